@@ -0,0 +1,560 @@
+/*
+ * bme280_bench.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Compensation and acquisition benchmarks, with results written to
+ *    standard output as one JSON object, for tracking from release to
+ *    release.
+ *
+ *      compensation - ns per sample of every Comp* function
+ *      batch        - BenchBatch(): Comp32FixedBatch() against the
+ *                     per-sample loop, with a bit-for-bit check, and
+ *                     CompFloatBatch() checked against CompFloatData()
+ *                     and the double reference
+ *      prepared     - BenchCompensation(): double compensation from
+ *                     CalParams and from PreparedCalibration
+ *      policies     - BenchPolicies(): the four precision policies
+ *      faults       - bus errors injected through EmuI2CSys::Fail():
+ *                     reads and configuration writes must be retried,
+ *                     forced triggers and resets must not
+ *      acquisition  - latency of GetComp32FixedData(),
+ *                     GetCompDoubleData(), ForceAndRead(), and
+ *                     ReadAndForce() against an emulated device, with
+ *                     bus transfers per reading
+ *
+ *    Raw samples are drawn from a fixed seed, over the range a device
+ *    reports indoors, so runs are comparable. The first few are
+ *    replaced by the raw values at the ends of the data sheet
+ *    operating range (-40 and 85 degC, 300 and 1100 hPa, 0 and 100
+ *    %RH), so that the checks also cover the extremes.
+ *
+ *  Usage:
+ *    bme280_bench [--quick] [--check]
+ *
+ *      --quick - fewer samples and readings, for a smoke test
+ *      --check - exit with status 1 if a batch kernel, the float
+ *                kernels, or the prepared calibration disagree with
+ *                the reference path, or if a fault injection check
+ *                fails
+ */
+
+
+#include <algorithm>         // copy, sort
+#include <math.h>            // fabs
+#include <random>            // mt19937, uniform_int_distribution
+#include <stdint.h>          // int64_t, uint32_t, uint64_t
+#include <stdio.h>           // printf
+#include <string.h>          // strcmp
+#include <thread>            // this_thread
+#include <chrono>            // microseconds
+#include <vector>            // vector
+
+#include "bme280.hpp"
+#include "bme280_comp.hpp"
+#include "bme280_config.hpp"
+#include "bme280_emu.hpp"
+#include "bme280_policy.hpp"
+#include "bme280_spi.hpp"
+#include "bme280_time.hpp"
+#include "bme280_transport.hpp"
+
+
+using namespace std;
+using namespace bosch_bme280;
+
+
+// Keeps the compiler from discarding the timed work.
+static volatile double sink;
+
+
+/*
+ * template <class F>
+ * static double PerSample(size_t count, unsigned rounds, F fn)
+ *
+ * Description:
+ *   Calls fn(i) for every sample index, rounds times, and returns the
+ *   mean time per call in nanoseconds.
+ */
+template <class F>
+static double PerSample(size_t count, unsigned rounds, F fn)
+{
+    double acc = 0.0;
+
+    int64_t start = SteadyNanos();
+    for (unsigned r = 0; r < rounds; r++)
+        for (size_t i = 0; i < count; i++)
+            acc += (double)fn(i);
+    int64_t elapsed = SteadyNanos() - start;
+
+    sink = acc;
+    return (double)elapsed / ((double)count * rounds);
+}
+
+/*
+ * template <class F>
+ * static uint32_t RawFor(F comp, double target, uint32_t max)
+ *
+ * Description:
+ *   Returns the raw value in [0, max] at which comp(raw) crosses
+ *   target, by bisection. comp must be monotonic over the range.
+ */
+template <class F>
+static uint32_t RawFor(F comp, double target, uint32_t max)
+{
+    uint32_t lo = 0;
+    uint32_t hi = max;
+    bool     up = comp(lo) < comp(hi);
+
+    while (hi - lo > 1)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+
+        if ((comp(mid) < target) == up)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/*
+ * static vector<TPH32SensorData> ExtremeSamples(const PreparedCalibration& pc)
+ *
+ * Description:
+ *   Returns raw samples at, and two counts either side of, the ends
+ *   of the data sheet operating range: every combination of -40 and
+ *   85 degC, 300 and 1100 hPa, and 0 and 100 %RH.
+ */
+static vector<TPH32SensorData> ExtremeSamples(const PreparedCalibration& pc)
+{
+    // The kernels clamp to the range, so the low ends are nudged
+    // inside it; otherwise every raw value past the end would match.
+    const double temps[]   = { -40.0 + 1e-6, 85.0 };
+    const double presses[] = { 30000.0 + 1e-6, 110000.0 };
+    const double humids[]  = { 0.0 + 1e-6, 100.0 };
+
+    vector<TPH32SensorData> out;
+
+    for (double tc : temps)
+    {
+        int32_t  tfine;
+        uint32_t ut = RawFor([&](uint32_t raw) { int32_t tf; return CompDoubleTemp(pc, raw, tf); }, tc, 0xFFFFF);
+        CompDoubleTemp(pc, ut, tfine);
+
+        for (double pa : presses)
+        {
+            uint32_t up = RawFor([&](uint32_t raw) { return CompDoublePress(pc, raw, tfine); }, pa, 0xFFFFF);
+
+            for (double rh : humids)
+            {
+                uint32_t uh = RawFor([&](uint32_t raw) { return CompDoubleHumid(pc, raw, tfine); }, rh, 0xFFFF);
+
+                for (int d = -2; d <= 2; d++)
+                {
+                    TPH32SensorData sd;
+                    sd.temperature = (ut + d) & 0xFFFFF;
+                    sd.pressure    = (up + d) & 0xFFFFF;
+                    sd.humidity    = (uh + d) & 0xFFFF;
+                    out.push_back(sd);
+                }
+            }
+        }
+    }
+
+    return out;
+}
+
+/*
+ * static size_t CheckFloat(const PreparedCalibration& pc, const PreparedFloatCalibration& pfc,
+ *                          const TPH32SensorData* sensdat, size_t count)
+ *
+ * Description:
+ *   Compensates the samples with CompFloatBatch() and returns the
+ *   number that either differ from CompFloatData(), or, where the
+ *   double result is inside the clamp limits, differ from it by more
+ *   than the bounds stated in bme280_comp.cpp. On 32-bit ARM, batch
+ *   pressure may differ from CompFloatData() by about one ulp.
+ */
+static size_t CheckFloat(const PreparedCalibration& pc, const PreparedFloatCalibration& pfc,
+                         const TPH32SensorData* sensdat, size_t count)
+{
+    vector<float> ft(count), fp(count), fh(count);
+    size_t        bad = 0;
+
+    CompFloatBatch(pfc, sensdat, count, &ft[0], &fp[0], &fh[0]);
+
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && !defined(__aarch64__)
+    const double press_ulps = 2.0;
+#else
+    const double press_ulps = 0.0;
+#endif
+
+    for (size_t i = 0; i < count; i++)
+    {
+        TPHFloatCompData  f = CompFloatData(pfc, sensdat[i]);
+        TPHDoubleCompData d = CompDoubleData(pc, sensdat[i]);
+
+        bool differs =
+            ft[i] != f.temperature || fh[i] != f.humidity ||
+            fabs((double)fp[i] - f.pressure) > press_ulps * 1.2e-7 * fabs(f.pressure);
+
+        bool outside =
+            (d.temperature > -40.0   && d.temperature < 85.0     &&
+             fabs(f.temperature - d.temperature) > 0.00002)      ||
+            (d.pressure    > 30000.0 && d.pressure    < 110000.0 &&
+             fabs(f.pressure - d.pressure) > 0.06)               ||
+            (d.humidity    > 0.0     && d.humidity    < 100.0    &&
+             fabs(f.humidity - d.humidity) > 0.0001);
+
+        if (differs || outside)
+            bad++;
+    }
+
+    return bad;
+}
+
+/*
+ * template <class F>
+ * static bool FailsOnce(EmuI2CSys& sys, F fn)
+ *
+ * Description:
+ *   Makes the next transfer fail, calls fn(), and returns true if fn
+ *   threw after exactly one attempt.
+ */
+template <class F>
+static bool FailsOnce(EmuI2CSys& sys, F fn)
+{
+    uint64_t calls = sys.Calls();
+
+    sys.Fail(1);
+    try
+    {
+        fn();
+    }
+    catch (...)
+    {
+        sys.Fail(0);
+        return sys.Calls() - calls == 1;
+    }
+
+    return false;
+}
+
+/*
+ * static size_t CheckFaults()
+ *
+ * Description:
+ *   Injects single transfer failures into an I2C_RDWR device and
+ *   returns the number of checks that fail: a data read and a
+ *   configuration write must each succeed on their retry; a forced
+ *   trigger, a ReadAndForce(), and a reset must each throw without
+ *   being sent again, see BME280::WriteRegs().
+ */
+static size_t CheckFaults()
+{
+    BME280Emulator              emu;
+    BME280Dev<EmuRdwrTransport> dev("/dev/i2c-emu", (uint8_t)BME280_I2C0, EmuI2CSys(&emu));
+    EmuI2CSys&                  sys = dev.GetTransport().GetSys();
+
+    size_t  bad = 0;
+    uint8_t status;
+
+    dev.LoadCalParams();
+    dev.ApplyConfig(ConfigWeather);
+    dev.ResetStats();
+
+    try
+    {
+        sys.Fail(1);
+        dev.GetSensorData();
+        sys.Fail(1);
+        dev.ApplyConfig(ConfigGaming);
+    }
+    catch (...)
+    {
+        bad++;
+    }
+
+    StatsSnapshot ss = dev.GetStats();
+    if (ss.op[OP_DATA].retries != 1 || ss.op[OP_CONFIG].retries != 1)
+        bad++;
+
+    dev.ApplyConfig(ConfigWeather);
+    dev.ResetStats();
+
+    if (!FailsOnce(sys, [&]() { dev.Force(); }))               bad++;
+    if (!FailsOnce(sys, [&]() { dev.ReadAndForce(status); }))  bad++;
+    if (!FailsOnce(sys, [&]() { dev.Reset(); }))               bad++;
+
+    if (dev.GetStats().Total().retries != 0)
+        bad++;
+
+    return bad;
+}
+
+/*
+ * struct Acquisition
+ *
+ * Description:
+ *   Result of one acquisition benchmark.
+ *
+ *     readings  - readings timed
+ *     mean_ns   - mean latency of one reading
+ *     p50_ns    - median latency
+ *     p99_ns    - 99th percentile latency
+ *     transfers - driver bus transfers per reading, from GetStats()
+ *     emu_reads - register reads per reading, seen by the emulator
+ *     emu_writes- register writes per reading, seen by the emulator
+ */
+struct Acquisition
+{
+    unsigned  readings;
+    double    mean_ns;
+    double    p50_ns;
+    double    p99_ns;
+    double    transfers;
+    double    emu_reads;
+    double    emu_writes;
+};
+
+/*
+ * template <class F>
+ * static Acquisition Acquire(BME280& dev, BME280Emulator& emu, unsigned readings,
+ *                            uint32_t gap_us, F fn)
+ *
+ * Description:
+ *   Times fn() readings times. Device and emulator statistics are
+ *   reset first. If gap_us is not zero, waits that long, untimed,
+ *   before each reading.
+ */
+template <class F>
+static Acquisition Acquire(BME280& dev, BME280Emulator& emu, unsigned readings,
+                           uint32_t gap_us, F fn)
+{
+    Acquisition    acq;
+    vector<double> lat(readings);
+    double         total = 0.0;
+
+    dev.ResetStats();
+    emu.ResetStats();
+
+    for (unsigned i = 0; i < readings; i++)
+    {
+        if (gap_us)
+            this_thread::sleep_for(chrono::microseconds(gap_us));
+
+        int64_t start = SteadyNanos();
+        fn();
+        lat[i] = (double)(SteadyNanos() - start);
+        total += lat[i];
+    }
+
+    StatsSnapshot ss = dev.GetStats();
+    EmuStats      es = emu.GetStats();
+
+    sort(lat.begin(), lat.end());
+
+    acq.readings   = readings;
+    acq.mean_ns    = total / readings;
+    acq.p50_ns     = lat[readings / 2];
+    acq.p99_ns     = lat[(readings * 99) / 100];
+    acq.transfers  = (double)ss.Total().xfers / readings;
+    acq.emu_reads  = (double)es.reads  / readings;
+    acq.emu_writes = (double)es.writes / readings;
+
+    return acq;
+}
+
+/*
+ * static void PrintAcquisition(const char* name, const char* transport,
+ *                              const Acquisition& acq, bool last)
+ *
+ * Description:
+ *   Writes one acquisition result as a JSON object.
+ */
+static void PrintAcquisition(const char* name, const char* transport,
+                             const Acquisition& acq, bool last)
+{
+    printf("    { \"name\": \"%s\", \"transport\": \"%s\", \"readings\": %u, "
+           "\"mean_ns\": %.0f, \"p50_ns\": %.0f, \"p99_ns\": %.0f, "
+           "\"transfers_per_reading\": %.2f, \"emu_reads_per_reading\": %.2f, "
+           "\"emu_writes_per_reading\": %.2f }%s\n",
+           name, transport, acq.readings, acq.mean_ns, acq.p50_ns, acq.p99_ns,
+           acq.transfers, acq.emu_reads, acq.emu_writes, last ? "" : ",");
+}
+
+int main(int argc, char* argv[])
+{
+    bool quick = false;
+    bool check = false;
+
+    for (int a = 1; a < argc; a++)
+    {
+        if (strcmp(argv[a], "--quick") == 0)
+            quick = true;
+        else if (strcmp(argv[a], "--check") == 0)
+            check = true;
+        else
+        {
+            fprintf(stderr, "usage: %s [--quick] [--check]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    size_t   count    = quick ? 10000 : 200000;
+    unsigned rounds   = quick ? 2 : 10;
+    unsigned readings = quick ? 1000 : 20000;
+    unsigned forced   = quick ? 10 : 100;
+
+    // Calibration from an emulated device, which carries the data
+    // sheet example values.
+    BME280Emulator        emu;
+    BME280Dev<EmuTransport> dev(&emu);
+    dev.LoadCalParams();
+
+    CalParams                 cp   = dev.GetCalParams();
+    PreparedCalibration       pc(cp);
+    PreparedFloatCalibration  pfc(pc);
+
+    vector<TPH32SensorData> sensdat(count);
+    vector<int32_t>         tfine(count);
+    mt19937                 rng(280);
+
+    uniform_int_distribution<uint32_t> rawtemp  (400000, 600000);
+    uniform_int_distribution<uint32_t> rawpress (200000, 500000);
+    uniform_int_distribution<uint32_t> rawhum   ( 20000,  40000);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        sensdat[i].temperature = rawtemp(rng);
+        sensdat[i].pressure    = rawpress(rng);
+        sensdat[i].humidity    = rawhum(rng);
+    }
+
+    vector<TPH32SensorData> extremes = ExtremeSamples(pc);
+    copy(extremes.begin(), extremes.end(), sensdat.begin());
+
+    for (size_t i = 0; i < count; i++)
+        Comp32FixedTemp(cp, sensdat[i].temperature, tfine[i]);
+
+    const TPH32SensorData* s  = &sensdat[0];
+    const int32_t*         tf = &tfine[0];
+
+    printf("{\n");
+    printf("  \"compiler\": \"%s\",\n", __VERSION__);
+    printf("  \"samples\": %zu,\n", count);
+    printf("  \"rounds\": %u,\n", rounds);
+
+    // Per-function compensation
+    int32_t t;
+
+    printf("  \"compensation\": {\n");
+    printf("    \"Comp32FixedTemp\": %.2f,\n",
+           PerSample(count, rounds, [&](size_t i) { return Comp32FixedTemp(cp, s[i].temperature, t); }));
+    printf("    \"Comp32FixedPress\": %.2f,\n",
+           PerSample(count, rounds, [&](size_t i) { return Comp32FixedPress(cp, s[i].pressure, tf[i]); }));
+    printf("    \"Comp64FixedPress\": %.2f,\n",
+           PerSample(count, rounds, [&](size_t i) { return Comp64FixedPress(cp, s[i].pressure, tf[i]); }));
+    printf("    \"Comp32FixedHumid\": %.2f,\n",
+           PerSample(count, rounds, [&](size_t i) { return Comp32FixedHumid(cp, s[i].humidity, tf[i]); }));
+    printf("    \"CompDoubleTemp\": %.2f,\n",
+           PerSample(count, rounds, [&](size_t i) { return CompDoubleTemp(cp, s[i].temperature, t); }));
+    printf("    \"CompDoublePress\": %.2f,\n",
+           PerSample(count, rounds, [&](size_t i) { return CompDoublePress(cp, s[i].pressure, tf[i]); }));
+    printf("    \"CompDoubleHumid\": %.2f,\n",
+           PerSample(count, rounds, [&](size_t i) { return CompDoubleHumid(cp, s[i].humidity, tf[i]); }));
+    printf("    \"CompDoubleTemp_prepared\": %.2f,\n",
+           PerSample(count, rounds, [&](size_t i) { return CompDoubleTemp(pc, s[i].temperature, t); }));
+    printf("    \"CompDoublePress_prepared\": %.2f,\n",
+           PerSample(count, rounds, [&](size_t i) { return CompDoublePress(pc, s[i].pressure, tf[i]); }));
+    printf("    \"CompDoubleHumid_prepared\": %.2f,\n",
+           PerSample(count, rounds, [&](size_t i) { return CompDoubleHumid(pc, s[i].humidity, tf[i]); }));
+    printf("    \"CompFloatTemp\": %.2f,\n",
+           PerSample(count, rounds, [&](size_t i) { return CompFloatTemp(pfc, s[i].temperature, t); }));
+    printf("    \"CompFloatPress\": %.2f,\n",
+           PerSample(count, rounds, [&](size_t i) { return CompFloatPress(pfc, s[i].pressure, tf[i]); }));
+    printf("    \"CompFloatHumid\": %.2f,\n",
+           PerSample(count, rounds, [&](size_t i) { return CompFloatHumid(pfc, s[i].humidity, tf[i]); }));
+    printf("    \"Comp32FixedData\": %.2f,\n",
+           PerSample(count, rounds, [&](size_t i) { return Comp32FixedData(cp, s[i]).pressure; }));
+    printf("    \"CompDoubleData\": %.2f,\n",
+           PerSample(count, rounds, [&](size_t i) { return CompDoubleData(cp, s[i]).pressure; }));
+    printf("    \"CompDoubleData_prepared\": %.2f,\n",
+           PerSample(count, rounds, [&](size_t i) { return CompDoubleData(pc, s[i]).pressure; }));
+    printf("    \"CompFloatData\": %.2f\n",
+           PerSample(count, rounds, [&](size_t i) { return CompFloatData(pfc, s[i]).pressure; }));
+    printf("  },\n");
+
+    // Batch, prepared, and policy comparisons
+    BatchBench  bb = BenchBatch(cp, s, count, rounds);
+    CompBench   cb = BenchCompensation(cp, s, count, rounds);
+    PolicyBench pb = BenchPolicies(cp, s, count, rounds);
+
+    vector<float> ft(count), fp(count), fh(count);
+    int64_t start = SteadyNanos();
+    for (unsigned r = 0; r < rounds; r++)
+        CompFloatBatch(pfc, s, count, &ft[0], &fp[0], &fh[0]);
+    double floatbatch = (double)(SteadyNanos() - start) / ((double)count * rounds);
+    size_t floatbad   = CheckFloat(pc, pfc, s, count);
+
+    printf("  \"batch\": { \"kernel\": \"%s\", \"loop_ns\": %.2f, \"batch_ns\": %.2f, "
+           "\"float_batch_ns\": %.2f, \"mismatches\": %zu, \"float_mismatches\": %zu },\n",
+           bb.kernel, bb.loop_ns, bb.batch_ns, floatbatch, bb.mismatches, floatbad);
+    printf("  \"prepared\": { \"plain_ns\": %.2f, \"prepared_ns\": %.2f, \"mismatches\": %zu },\n",
+           cb.plain_ns, cb.prepared_ns, cb.mismatches);
+    size_t faults = CheckFaults();
+    printf("  \"faults\": { \"failed_checks\": %zu },\n", faults);
+    printf("  \"policies\": { \"fixed32_ns\": %.2f, \"fixed64_ns\": %.2f, "
+           "\"float_ns\": %.2f, \"double_ns\": %.2f },\n",
+           pb.fixed32, pb.fixed64, pb.single, pb.dbl);
+
+    // Acquisition, against emulated devices. Normal mode keeps fresh
+    // data in the registers for the plain reads.
+    Acquisition acq;
+
+    printf("  \"acquisition\": [\n");
+
+    dev.ApplyConfig(ConfigGaming);
+    acq = Acquire(dev, emu, readings, 0, [&]() { sink = dev.GetComp32FixedData().pressure; });
+    PrintAcquisition("GetComp32FixedData", "emu", acq, false);
+    acq = Acquire(dev, emu, readings, 0, [&]() { sink = dev.GetCompDoubleData().pressure; });
+    PrintAcquisition("GetCompDoubleData", "emu", acq, false);
+
+    BME280Emulator           spiemu;
+    BME280Dev<EmuSpiTransport> spidev(&spiemu);
+    spidev.ApplyConfig(ConfigGaming);
+    acq = Acquire(spidev, spiemu, readings, 0, [&]() { sink = spidev.GetComp32FixedData().pressure; });
+    PrintAcquisition("GetComp32FixedData", "spi", acq, false);
+
+    BME280Emulator              rdwremu;
+    BME280Dev<EmuRdwrTransport> rdwrdev("/dev/i2c-emu", (uint8_t)BME280_I2C0, EmuI2CSys(&rdwremu));
+    rdwrdev.ApplyConfig(ConfigGaming);
+    acq = Acquire(rdwrdev, rdwremu, readings, 0, [&]() { sink = rdwrdev.GetComp32FixedData().pressure; });
+    PrintAcquisition("GetComp32FixedData", "i2c_rdwr", acq, false);
+
+    // Forced mode: ForceAndRead() includes the conversion wait.
+    // ReadAndForce() collects the previous conversion and starts the
+    // next in one transfer; the wait happens between readings.
+    dev.ApplyConfig(ConfigWeather);
+    acq = Acquire(dev, emu, forced, 0, [&]() { sink = dev.ForceAndRead().pressure; });
+    PrintAcquisition("ForceAndRead", "emu", acq, false);
+
+    uint8_t status;
+    rdwrdev.ApplyConfig(ConfigWeather);
+    rdwrdev.Force();
+    acq = Acquire(rdwrdev, rdwremu, forced, rdwrdev.MeasureTime(true),
+                  [&]() { sink = rdwrdev.ReadAndForce(status).pressure; });
+    PrintAcquisition("ReadAndForce", "i2c_rdwr", acq, true);
+
+    printf("  ]\n");
+    printf("}\n");
+
+    if (check && (bb.mismatches || cb.mismatches || floatbad || faults))
+        return 1;
+
+    return 0;
+}
@@ -1,4 +1,3 @@
-```
 /*
  * bme280.cpp
  *
@@ -9,25 +8,22 @@
  *    BME280 Combined Humidity and Pressure Sensor.
  *
  *  Note:
- *    This driver assumes that device configuration will be
- *    set at startup and only the power mode is subject to change
- *    afterward.
- *
- *    Settings for the ctrl_meas, ctrl_hum, and config registers
- *    are defined below. A call to SetConfig() loads these pre-
- *    defined values.
- *
- *    bme280_defs.hpp contains additional definitions that can be
- *    used to modify these settings.
+ *    Device configuration is described by a Config struct (see
+ *    bme280_config.hpp), which also provides the data sheet's
+ *    recommended settings as constexpr presets. ApplyConfig()
+ *    loads any configuration at runtime; SetConfig() loads the
+ *    weather monitoring preset.
  */
 
 
 #include <chrono>            // std::chrono::seconds
+#include <stdexcept>         // invalid_argument, runtime_error
 #include <stdint.h>          // int16_t, uint16_t
 #include <thread>            // this_thread
 
 #include "bbb-i2c.hpp"       // I2CBus
 #include "bme280.hpp"
+#include "bme280_time.hpp"
 
 
 using namespace std;
@@ -37,18 +33,6 @@ using namespace bbbi2c;
 
 
 
-// Device Configuration
-// --------------------------------
-// Weather Monitoring Configuration
-//   * From BME280 Data Sheet
-//     BST-BME280-DS002-13, Rev 1.5
-//     May 2018
-#define BME280_CTRL_MEA_SET  BME280_OSRS_T_1X | BME280_OSRS_P_1X | BME280_MODE_SLEEP
-#define BME280_CTRL_HUM_SET  BME280_OSRS_H_1X
-#define BME280_CONF_SET      BME280_T_SB_1K   | BME280_FILTER_OFF
-
-
-
 namespace bosch_bme280
 {
 
@@ -60,7 +44,8 @@ namespace bosch_bme280
  *
  * Description:
  *   Constructor. Assigns the I2C bus and the target device address.
- *   Initializes chip id to zero.
+ *   Initializes chip id to zero and marks the shadow registers as
+ *   unknown.
  *
  * Parameters:
  *   bus  - pointer to an I2CBus object
@@ -77,6 +62,15 @@ BME280::BME280(I2CBus* bus, uint8_t addr)
     chipid  = 0;
     i2cbus  = bus;
     i2caddr = addr;
+
+    shadow_hum   = 0;
+    shadow_meas  = 0;
+    shadow_conf  = 0;
+    shadow_valid = false;
+    forced       = 0;
+
+    for (int i = 0; i < BME280_CAL_SIZE; i++)
+        rawcal[i] = 0;
 }
 
 /*
@@ -95,6 +89,46 @@ BME280::~BME280()
 { }
 
 
+/*
+ * void* BME280::operator new(size_t size)
+ * void* BME280::operator new[](size_t size)
+ * void  BME280::operator delete(void* ptr)
+ * void  BME280::operator delete[](void* ptr)
+ *
+ * Description:
+ *   Allocation for BME280 objects and arrays on the heap. The
+ *   prepared calibration members are cache-line aligned, so memory
+ *   comes from AlignedAlloc().
+ *
+ * Exceptions:
+ *   operator new throws std::bad_alloc if memory is exhausted.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280.hpp
+ */
+void* BME280::operator new(size_t size)
+{
+    return AlignedAlloc(size);
+}
+
+void* BME280::operator new[](size_t size)
+{
+    return AlignedAlloc(size);
+}
+
+void BME280::operator delete(void* ptr)
+{
+    AlignedFree(ptr);
+}
+
+void BME280::operator delete[](void* ptr)
+{
+    AlignedFree(ptr);
+}
+
 
 // BME280 Protected
 // -----------------------------------------------------------------
@@ -105,6 +139,9 @@ BME280::~BME280()
  * Description:
  *   Reads the contents of one or more consecutive device registers.
  *
+ *   All register reads pass through this function. A derived class
+ *   may override it to reach the device by some other route.
+ *
  * Parameters:
  *   regaddr  - address of the first register to be read
  *   data     - pointer to a buffer that will receive data
@@ -132,6 +169,9 @@ void BME280::GetRegs(uint8_t regaddr, uint8_t* data, int len)
  *   This {address, data} sequence is repeated for each register
  *   to be written.
  *
+ *   All register writes pass through this function. A derived class
+ *   may override it to reach the device by some other route.
+ *
  * Parameters:
  *   data - pointer to a buffer that contains data which will be
  *          written to the device
@@ -148,73 +188,244 @@ void BME280::SetRegs(uint8_t* data, int len)
     i2cbus->Write(data, len, i2caddr);
 }
 
+/*
+ * void BME280::GetSetRegs(uint8_t regaddr, uint8_t* data, int len,
+ *                         uint8_t* wdata, int wlen)
+ *
+ * Description:
+ *   Reads one or more consecutive registers, then writes {address,
+ *   data} pairs. A derived class whose transport can carry both in
+ *   one transaction overrides this; here it is GetRegs() followed by
+ *   SetRegs().
+ *
+ * Parameters:
+ *   regaddr - address of the first register to be read
+ *   data    - pointer to a buffer that will receive data
+ *   len     - the number of bytes to read
+ *   wdata   - {address, data} pairs to be written after the read
+ *   wlen    - the total number of bytes to be written
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+void BME280::GetSetRegs(uint8_t regaddr, uint8_t* data, int len, uint8_t* wdata, int wlen)
+{
+    this->GetRegs(regaddr, data, len);
+    this->SetRegs(wdata, wlen);
+}
+
+/*
+ * void BME280::ReadRegs(BusOp op, uint8_t regaddr, uint8_t* data, int len)
+ *
+ * Description:
+ *   Reads registers through GetRegs(), and records the transfer in
+ *   the device statistics. A failed read is retried up to
+ *   BME280_XFER_RETRIES times. See ReadRegsVia().
+ *
+ * Parameters:
+ *   op       - operation the transfer is counted under
+ *   regaddr  - address of the first register to be read
+ *   data     - pointer to a buffer that will receive data
+ *   len      - the number of bytes to read
+ *
+ * Exceptions:
+ *   Rethrows the exception from the last failed attempt.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ *   bme280_stats.hpp
+ */
+void BME280::ReadRegs(BusOp op, uint8_t regaddr, uint8_t* data, int len)
+{
+    this->ReadRegsVia([this](uint8_t r, uint8_t* d, int n) { this->GetRegs(r, d, n); },
+                      op, regaddr, data, len);
+}
+
+/*
+ * static bool Repeatable(BusOp op, const uint8_t* data, int len)
+ *
+ * Description:
+ *   Tells whether a failed write may be sent again. A transfer that
+ *   reports failure may still have reached the device. Writing the
+ *   same value to a configuration register twice is harmless, but a
+ *   second forced mode trigger or soft reset is not: it restarts a
+ *   conversion, or an NVM copy, that may already be under way.
+ *
+ * Parameters:
+ *   op   - operation the transfer is counted under
+ *   data - {address, data} pairs
+ *   len  - the total number of bytes to be written
+ *
+ * Returns:
+ *   Returns false for forced mode triggers and for writes that
+ *   include the soft reset command.
+ */
+static bool Repeatable(BusOp op, const uint8_t* data, int len)
+{
+    if (op == OP_FORCE) return false;
 
+    for (int i = 0; i + 1 < len; i += 2)
+    {
+        if (data[i] == BME280_R_RESET && data[i + 1] == BME280_CMD_RESET)
+            return false;
+    }
 
-// BME280 Public
-// -----------------------------------------------------------------
+    return true;
+}
 
 /*
- * void BME280::LoadCalParams()
+ * void BME280::WriteRegs(BusOp op, uint8_t* data, int len)
  *
  * Description:
- *   Loads calibration parameters from the device ROM.
+ *   Writes registers through SetRegs(), and records the transfer in
+ *   the device statistics. A failed configuration write is retried
+ *   up to BME280_XFER_RETRIES times. Forced mode triggers and soft
+ *   resets are not retried, see Repeatable().
+ *
+ * Parameters:
+ *   op   - operation the transfer is counted under
+ *   data - {address, data} pairs, as for SetRegs()
+ *   len  - the total number of bytes to be written
+ *
+ * Exceptions:
+ *   Rethrows the exception from the last failed attempt.
  *
  * Namespace:
  *   bosch_bme280
  *
  * Header File(s);
  *   bme280.hpp
+ *   bme280_stats.hpp
  */
-void BME280::LoadCalParams()
+void BME280::WriteRegs(BusOp op, uint8_t* data, int len)
 {
-    uint8_t tpcparams[BME280_TPCAL_SIZE] {0};
-    uint8_t hucparams[BME280_HUCAL_SIZE] {0};
+    int retries = Repeatable(op, data, len) ? BME280_XFER_RETRIES : 0;
+
+    for (int attempt = 0; ; attempt++)
+    {
+        int64_t start = SteadyNanos();
+        try
+        {
+            this->SetRegs(data, len);
+        }
+        catch (...)
+        {
+            stats.Error(op);
+            if (attempt >= retries) throw;
 
-    this->GetRegs(BME280_TPCAL_START, tpcparams, BME280_TPCAL_SIZE);
-    this->GetRegs(BME280_HUCAL_START, hucparams, BME280_HUCAL_SIZE);
+            stats.Retry(op);
+            continue;
+        }
 
-    cparams.t1 =          (((uint16_t)tpcparams[1] << 8) | (uint16_t)tpcparams[0]);
-    cparams.t2 = (int16_t)(((uint16_t)tpcparams[3] << 8) | (uint16_t)tpcparams[2]);
-    cparams.t3 = (int16_t)(((uint16_t)tpcparams[5] << 8) | (uint16_t)tpcparams[4]);
+        stats.Record(op, len, SteadyNanos() - start);
+        return;
+    }
+}
 
-    cparams.p1 =          (((uint16_t)tpcparams[7]  << 8) | (uint16_t)tpcparams[6]);
-    cparams.p2 = (int16_t)(((uint16_t)tpcparams[9]  << 8) | (uint16_t)tpcparams[8]);
-    cparams.p3 = (int16_t)(((uint16_t)tpcparams[11] << 8) | (uint16_t)tpcparams[10]);
-    cparams.p4 = (int16_t)(((uint16_t)tpcparams[13] << 8) | (uint16_t)tpcparams[12]);
-    cparams.p5 = (int16_t)(((uint16_t)tpcparams[15] << 8) | (uint16_t)tpcparams[14]);
-    cparams.p6 = (int16_t)(((uint16_t)tpcparams[17] << 8) | (uint16_t)tpcparams[16]);
-    cparams.p7 = (int16_t)(((uint16_t)tpcparams[19] << 8) | (uint16_t)tpcparams[18]);
-    cparams.p8 = (int16_t)(((uint16_t)tpcparams[21] << 8) | (uint16_t)tpcparams[20]);
-    cparams.p9 = (int16_t)(((uint16_t)tpcparams[23] << 8) | (uint16_t)tpcparams[22]);
+/*
+ * void BME280::ReadWriteRegs(BusOp op, uint8_t regaddr, uint8_t* data, int len,
+ *                            uint8_t* wdata, int wlen)
+ *
+ * Description:
+ *   Reads and then writes registers through GetSetRegs(), and records
+ *   the transfer in the device statistics. A failed transfer is
+ *   retried up to BME280_XFER_RETRIES times, unless its write part
+ *   may not be repeated, see Repeatable().
+ *
+ * Parameters:
+ *   op      - operation the transfer is counted under
+ *   regaddr - address of the first register to be read
+ *   data    - pointer to a buffer that will receive data
+ *   len     - the number of bytes to read
+ *   wdata   - {address, data} pairs, as for SetRegs()
+ *   wlen    - the total number of bytes to be written
+ *
+ * Exceptions:
+ *   Rethrows the exception from the last failed attempt.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ *   bme280_stats.hpp
+ */
+void BME280::ReadWriteRegs(BusOp op, uint8_t regaddr, uint8_t* data, int len,
+                           uint8_t* wdata, int wlen)
+{
+    int retries = Repeatable(op, wdata, wlen) ? BME280_XFER_RETRIES : 0;
 
-    cparams.h1 = tpcparams[25];
+    for (int attempt = 0; ; attempt++)
+    {
+        int64_t start = SteadyNanos();
+        try
+        {
+            this->GetSetRegs(regaddr, data, len, wdata, wlen);
+        }
+        catch (...)
+        {
+            stats.Error(op);
+            if (attempt >= retries) throw;
 
-    cparams.h2 = (int16_t)(((uint16_t)hucparams[1] << 8) | (uint16_t)hucparams[0]);
-    cparams.h3 = hucparams[2];
+            stats.Retry(op);
+            continue;
+        }
 
-    int16_t h4_msb = (int16_t)(int8_t)hucparams[3] * 16;
-    int16_t h4_lsb = (int16_t)(hucparams[4] & 0x0F);
-    cparams.h4 = h4_msb | h4_lsb;
+        stats.Record(op, len + wlen, SteadyNanos() - start);
+        return;
+    }
+}
 
-    int16_t h5_msb = (int16_t)(int8_t)hucparams[5] * 16;
-    int16_t h5_lsb = (int16_t)(hucparams[4] >> 4);
-    cparams.h5 = h5_msb | h5_lsb;
 
-    cparams.h6 = (int8_t)hucparams[6];
+/*
+ * void BME280::LoadShadowRegs()
+ *
+ * Description:
+ *   Reads ctrl_hum, ctrl_meas, and config from the device in one
+ *   burst and stores them as shadow registers. Called only when the
+ *   driver has not yet written these registers itself.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+void BME280::LoadShadowRegs()
+{
+    uint8_t ctrl[4];    // ctrl_hum, status, ctrl_meas, config
+    this->ReadRegs(OP_CONFIG, BME280_R_CTRL_HUM, ctrl, 4);
 
-    cparams.loaded = true;
+    shadow_hum   = ctrl[0];
+    shadow_meas  = ctrl[2];
+    shadow_conf  = ctrl[3];
+    shadow_valid = true;
 }
 
 /*
- * TPH32SensorData BME280::GetSensorData()
+ * bool BME280::WriteConfig(uint8_t hum, uint8_t meas, uint8_t conf)
  *
  * Description:
- *   Retrieves raw temperature, pressure, and humidity data
- *   from the sensor.
+ *   Writes ctrl_hum, config, and ctrl_meas, skipping registers whose
+ *   shadow copies already hold the requested values. All registers
+ *   that do change go out in one bus transaction.
+ *
+ *   A change to ctrl_hum takes effect only after a write to
+ *   ctrl_meas, so ctrl_meas is always written when ctrl_hum is.
+ *
+ * Parameters:
+ *   hum  - ctrl_hum  register value
+ *   meas - ctrl_meas register value
+ *   conf - config    register value
  *
  * Returns:
- *   Returns a structure containing uncompensated temperature,
- *   pressure, and humidity data, along with a time stamp.
+ *   Returns true if anything was written.
  *
  * Namespace:
  *   bosch_bme280
@@ -222,12 +433,136 @@ void BME280::LoadCalParams()
  * Header File(s);
  *   bme280.hpp
  */
-TPH32SensorData BME280::GetSensorData()
+bool BME280::WriteConfig(uint8_t hum, uint8_t meas, uint8_t conf)
 {
-TPH32SensorData sensdat;
-uint8_t regdat[BME280_DATA_SIZE] {0};
+    uint8_t configdat[6];
+    int     len = 0;
+
+    bool humchange = !shadow_valid || (hum != shadow_hum);
+
+    if (humchange)
+    {
+        configdat[len++] = BME280_R_CTRL_HUM;
+        configdat[len++] = hum;
+    }
+    if (!shadow_valid || (conf != shadow_conf))
+    {
+        configdat[len++] = BME280_R_CONF;
+        configdat[len++] = conf;
+    }
+    if (humchange || (meas != shadow_meas))
+    {
+        configdat[len++] = BME280_R_CTRL_MEA;
+        configdat[len++] = meas;
+    }
+
+    if (len)
+        this->WriteRegs(OP_CONFIG, configdat, len);
+
+    shadow_hum   = hum;
+    shadow_conf  = conf;
+    shadow_meas  = meas;
+    shadow_valid = true;
+
+    if ((meas & BME280_MODE_MSK) == BME280_MODE_FORCED)
+        shadow_meas &= BME280_MODE_MSK_OUT;
 
-this->GetRegs(BME280_DATA_START, regdat, BME280_DATA_SIZE);
+    return (len > 0);
+}
+
+/*
+ * void BME280::WriteCtrlMeas(uint8_t meas, BusOp op)
+ *
+ * Description:
+ *   Writes ctrl_meas and updates its shadow copy. A forced mode
+ *   write is recorded as sleep mode, since the device returns to
+ *   sleep by itself when the measurement completes.
+ *
+ * Parameters:
+ *   meas - ctrl_meas register value
+ *   op   - Optional. Operation the write is counted under.
+ *          Default value is OP_CONFIG.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+void BME280::WriteCtrlMeas(uint8_t meas, BusOp op)
+{
+    uint8_t dat[] { BME280_R_CTRL_MEA, meas };
+    this->WriteRegs(op, dat, 2);
+
+    shadow_meas = meas;
+    if ((meas & BME280_MODE_MSK) == BME280_MODE_FORCED)
+        shadow_meas &= BME280_MODE_MSK_OUT;
+}
+
+
+/*
+ * void BME280::StampSensorData(TPH32SensorData& sensdat, int64_t start, int64_t end)
+ *
+ * Description:
+ *   Records the transfer times of a data read and estimates when the
+ *   conversion took place, from the shadow register settings:
+ *
+ *     forced mode - the conversion is taken to have just finished,
+ *                   so its midpoint is half the typical measurement
+ *                   time before the read.
+ *     normal mode - the newest conversion ended, on average, half a
+ *                   cycle (measurement plus standby) before the read.
+ *
+ *   Callers that know the trigger time can do better; see
+ *   ForceAndRead(). With no shadow registers, the read start is used.
+ *
+ * Parameters:
+ *   sensdat - the sample
+ *   start   - steady clock at the start of the transfer, in ns
+ *   end     - steady clock at the end of the transfer, in ns
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+void BME280::StampSensorData(TPH32SensorData& sensdat, int64_t start, int64_t end)
+{
+    sensdat.xfer_start = start;
+    sensdat.xfer_end   = end;
+    sensdat.sampled    = start;
+
+    if (shadow_valid)
+    {
+        int64_t ttyp = MeasureTimeTyp(shadow_hum, shadow_meas);
+
+        if ((shadow_meas & BME280_MODE_MSK) == BME280_MODE_NORMAL)
+            sensdat.sampled -= (ttyp + StandbyTime(shadow_conf) + ttyp) * 500;
+        else
+            sensdat.sampled -= ttyp * 500;
+    }
+
+    sensdat.timestamp = WallSeconds(sensdat.sampled);
+}
+
+/*
+ * TPH32SensorData ParseSensorData(const uint8_t* regdat)
+ *
+ * Description:
+ *   Assembles raw temperature, pressure, and humidity values from
+ *   the data registers (0xF7 - 0xFE).
+ *
+ * Parameters:
+ *   regdat - BME280_DATA_SIZE bytes read from BME280_DATA_START
+ *
+ * Returns:
+ *   Returns a structure containing uncompensated temperature,
+ *   pressure, and humidity data, along with a time stamp.
+ */
+static TPH32SensorData ParseSensorData(const uint8_t* regdat)
+{
+TPH32SensorData sensdat;
 
     sensdat.pressure = (
             ((uint32_t)regdat[BME280_PMSB_NDX]  << 12) |
@@ -250,21 +585,19 @@ this->GetRegs(BME280_DATA_START, regdat, BME280_DATA_SIZE);
 }
 
 /*
- * TPH32CompData BME280::GetComp32FixedData()
+ * TPH32SensorData BME280::MakeSensorData(const uint8_t* regdat, int64_t start, int64_t end)
  *
  * Description:
- *   Retrieves a temperature, pressure, and humidity reading and applies
- *   32-bit fixed-point compensation.
+ *   Assembles a sample from the data registers and stamps it, as
+ *   StampSensorData(), with the times of the transfer that read them.
  *
- *   Temperature compensation is performed first, in order to generate
- *   the 32-bit integer (tfine) that is required for pressure and
- *   humidity compensation.
+ * Parameters:
+ *   regdat - BME280_DATA_SIZE bytes read from BME280_DATA_START
+ *   start  - steady clock at the start of the transfer, in ns
+ *   end    - steady clock at the end of the transfer, in ns
  *
  * Returns:
- *   Returns a TPH32CompData structure containing a time stamp, a
- *   temperature reading (in 1/100 degrees centigrade), a pressure
- *   reading (in pascals), and a humidity reading, which can be
- *   devided by 1024 to give percent relative humidity.
+ *   Returns the stamped sample.
  *
  * Namespace:
  *   bosch_bme280
@@ -272,54 +605,47 @@ this->GetRegs(BME280_DATA_START, regdat, BME280_DATA_SIZE);
  * Header File(s);
  *   bme280.hpp
  */
-TPH32CompData BME280::GetComp32FixedData()
+TPH32SensorData BME280::MakeSensorData(const uint8_t* regdat, int64_t start, int64_t end)
 {
-    TPH32CompData   compdat;
-    TPH32SensorData sensdat = this->GetSensorData();
+    TPH32SensorData sensdat = ParseSensorData(regdat);
+    this->StampSensorData(sensdat, start, end);
 
-    compdat.timestamp   = sensdat.timestamp;
-    compdat.temperature = this->Comp32FixedTemp(sensdat.temperature);
-    compdat.pressure    = this->Comp32FixedPress(sensdat.pressure);
-    compdat.humidity    = this->Comp32FixedHumid(sensdat.humidity);
-
-    return compdat;
+    return sensdat;
 }
 
+
+// BME280 Public
+// -----------------------------------------------------------------
+
 /*
- * TPHDoubleCompData BME280::GetCompDoubleData()
+ * uint8_t BME280::ReadChipId()
  *
  * Description:
- *   Retrieves a temperature, pressure, and humidity reading and applies
- *   double floating-point compensation.
- *
- *   Temperature compensation is performed first, in order to generate
- *   the 32-bit integer (tfine) that is required for pressure and
- *   humidity compensation.
+ *   Reads the chip id register and stores its value. A BME280
+ *   returns BME280_ID.
  *
  * Returns:
- *   Returns a TPHDoubleCompData structure containing a time stamp, a
- *   temperature reading (in degrees centigrade), a pressure reading (in
- *   pascals), and a humidity reading (in percent relative humidity).
+ *   Returns the chip id.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
  */
-TPHDoubleCompData BME280::GetCompDoubleData()
+uint8_t BME280::ReadChipId()
 {
-    TPHDoubleCompData compdat;
-    TPH32SensorData   sensdat = this->GetSensorData();
-
-    compdat.timestamp   = sensdat.timestamp;
-    compdat.temperature = this->CompDoubleTemp(sensdat.temperature);
-    compdat.pressure    = this->CompDoublePress(sensdat.pressure);
-    compdat.humidity    = this->CompDoubleHumid(sensdat.humidity);
+    this->ReadRegs(OP_OTHER, BME280_R_ID, &chipid, 1);
 
-    return compdat;
+    return chipid;
 }
 
 /*
- * void BME280::SetConfig()
+ * uint8_t BME280::GetChipId()
  *
  * Description:
- *   Loads pre-defined configuration settings. Returns after
- *   a time delay.
+ *   Returns the chip id stored by ReadChipId(), or zero if it has
+ *   not been read.
  *
  * Namespace:
  *   bosch_bme280
@@ -327,83 +653,68 @@ TPHDoubleCompData BME280::GetCompDoubleData()
  * Header File(s);
  *   bme280.hpp
  */
-void BME280::SetConfig()
+uint8_t BME280::GetChipId()
 {
-    uint8_t configdat[6];
-    configdat[0] = BME280_R_CTRL_HUM;
-    configdat[1] = BME280_CTRL_HUM_SET;
-    configdat[2] = BME280_R_CONF;
-    configdat[3] = BME280_CONF_SET;
-    configdat[4] = BME280_R_CTRL_MEA;
-    configdat[5] = BME280_CTRL_MEA_SET;
-
-    this->SetRegs(configdat, 6);
-    this_thread::sleep_for(milliseconds(BME280_CONFIG_DELAY));
+    return chipid;
 }
 
 /*
- * void BME280::Force()
+ * uint8_t BME280::GetAddress()
  *
  * Description:
- *   Manually initiates a measurement cycle.
- *
- * Initial Conditions:
- *   All other configuration settings must be completed before
- *   calling this function.
- *
- *   The sensor must be in sleep mode.
+ *   Returns the I2C address of the device.
  *
  * Namespace:
  *   bosch_bme280
  *
- * Header File(s):
+ * Header File(s);
  *   bme280.hpp
  */
-void BME280::Force()
+uint8_t BME280::GetAddress()
 {
-    uint8_t ctrl;
-    this->GetRegs(BME280_R_CTRL_MEA, &ctrl, 1);
-
-    uint8_t dat[] { BME280_R_CTRL_MEA, (uint8_t)(ctrl | BME280_MODE_FORCED) };
-    this->SetRegs(dat, 2);
+    return i2caddr;
 }
 
 /*
- * void BME280::Reset(bool reload)
+ * void BME280::LoadCalParams()
  *
  * Description:
- *   Resets the device. Allows time for the reset process to
- *   complete before returning. Optionally, reloads device
- *   configuration when reset is complete.
- *
- * Parameters:
- *   reload - Optional. If true, reloads configuration settings
- *            following the reset.
- *            Default value is false.
+ *   Loads calibration parameters from the device ROM, and builds
+ *   the prepared coefficients that are used for double and float
+ *   compensation. The raw ROM bytes are kept as well; see
+ *   GetRawCalibration().
  *
  * Namespace:
  *   bosch_bme280
  *
- * Header File(s):
+ * Header File(s);
  *   bme280.hpp
  */
-void BME280::Reset(bool reload)
+void BME280::LoadCalParams()
 {
-    uint8_t dat[] { BME280_R_RESET, BME280_CMD_RESET };
-    this->SetRegs(dat, 2);
+    this->ReadRegs(OP_CALIBRATION, BME280_TPCAL_START, rawcal, BME280_TPCAL_SIZE);
+    this->ReadRegs(OP_CALIBRATION, BME280_HUCAL_START, rawcal + BME280_TPCAL_SIZE, BME280_HUCAL_SIZE);
 
-    this_thread::sleep_for(milliseconds(BME280_RESET_DELAY));
+    cparams = CalParams(rawcal, rawcal + BME280_TPCAL_SIZE);
 
-    if (reload)
-        this->SetConfig();
+    pcal  = PreparedCalibration(cparams);
+    pcalf = PreparedFloatCalibration(pcal);
 }
 
 /*
- * void BME280::Sleep()
+ * CalParams BME280::GetCalParams()
  *
  * Description:
- *   Places the device in sleep mode by setting the ctrl_meas
- *   register mode bits to zero.
+ *   Returns a copy of the device calibration parameters, loading them
+ *   from the device ROM first if necessary.
+ *
+ *   The copy can be passed to the stateless compensation functions
+ *   declared in bme280_comp.hpp. Each worker thread may keep its own
+ *   copy, so that compensation needs no locking and no two threads
+ *   write to the same CalParams.
+ *
+ * Returns:
+ *   Returns a CalParams structure.
  *
  * Namespace:
  *   bosch_bme280
@@ -411,14 +722,710 @@ void BME280::Reset(bool reload)
  * Header File(s);
  *   bme280.hpp
  */
-void BME280::Sleep()
+CalParams BME280::GetCalParams()
 {
-    uint8_t ctrl;
-    this->GetRegs(BME280_R_CTRL_MEA, &ctrl, 1);
+    if (!cparams.loaded) this->LoadCalParams();
+
+    return cparams;
+}
 
-    uint8_t dat[] { BME280_R_CTRL_MEA, (uint8_t)(ctrl & BME280_MODE_MSK_OUT) };
-    this->SetRegs(dat, 2);
+/*
+ * void BME280::GetRawCalibration(uint8_t* cal)
+ *
+ * Description:
+ *   Copies the calibration ROM bytes, as read by LoadCalParams(),
+ *   loading them from the device first if necessary. These are the
+ *   BME280_TPCAL_SIZE bytes at 0x88 - 0xA1 followed by the
+ *   BME280_HUCAL_SIZE bytes at 0xE1 - 0xE7.
+ *
+ * Parameters:
+ *   cal - buffer of at least BME280_CAL_SIZE bytes
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+void BME280::GetRawCalibration(uint8_t* cal)
+{
+    if (!cparams.loaded) this->LoadCalParams();
+
+    for (int i = 0; i < BME280_CAL_SIZE; i++)
+        cal[i] = rawcal[i];
+}
+
+/*
+ * PreparedCalibration BME280::GetPreparedCalibration()
+ *
+ * Description:
+ *   Returns a copy of the prepared calibration coefficients used for
+ *   double compensation, loading calibration parameters from the
+ *   device ROM first if necessary.
+ *
+ * Returns:
+ *   Returns a PreparedCalibration structure.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+PreparedCalibration BME280::GetPreparedCalibration()
+{
+    if (!cparams.loaded) this->LoadCalParams();
+
+    return pcal;
+}
+
+/*
+ * PreparedFloatCalibration BME280::GetPreparedFloatCalibration()
+ *
+ * Description:
+ *   Returns a copy of the prepared calibration coefficients used for
+ *   single-precision compensation, loading calibration parameters
+ *   from the device ROM first if necessary.
+ *
+ * Returns:
+ *   Returns a PreparedFloatCalibration structure.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+PreparedFloatCalibration BME280::GetPreparedFloatCalibration()
+{
+    if (!cparams.loaded) this->LoadCalParams();
+
+    return pcalf;
+}
+
+/*
+ * TPH32SensorData BME280::GetSensorData()
+ *
+ * Description:
+ *   Retrieves raw temperature, pressure, and humidity data
+ *   from the sensor. The transfer is timed, and the sample time
+ *   is estimated as described for StampSensorData().
+ *
+ * Returns:
+ *   Returns a structure containing uncompensated temperature,
+ *   pressure, and humidity data, along with a time stamp.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+TPH32SensorData BME280::GetSensorData()
+{
+    return this->SensorDataVia([this](uint8_t r, uint8_t* d, int n) { this->GetRegs(r, d, n); });
+}
+
+/*
+ * TPH32SensorData BME280::GetSensorData(uint8_t& status)
+ *
+ * Description:
+ *   Retrieves the status register and raw temperature, pressure,
+ *   and humidity data in a single burst read (0xF3 - 0xFE).
+ *
+ *   The data registers are shadowed by the device, so they always
+ *   hold a complete sample; a set measuring bit means that a newer
+ *   sample is being converted.
+ *
+ * Parameters:
+ *   status - receives the status register value
+ *
+ * Returns:
+ *   Returns a structure containing uncompensated temperature,
+ *   pressure, and humidity data, along with a time stamp.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+TPH32SensorData BME280::GetSensorData(uint8_t& status)
+{
+    return this->SensorDataVia([this](uint8_t r, uint8_t* d, int n) { this->GetRegs(r, d, n); },
+                               status);
+}
+
+/*
+ * TPH32CompData BME280::GetComp32FixedData()
+ *
+ * Description:
+ *   Retrieves a temperature, pressure, and humidity reading and applies
+ *   32-bit fixed-point compensation.
+ *
+ *   Temperature compensation is performed first, in order to generate
+ *   the 32-bit integer (tfine) that is required for pressure and
+ *   humidity compensation.
+ *
+ * Returns:
+ *   Returns a TPH32CompData structure containing a time stamp, a
+ *   temperature reading (in 1/100 degrees centigrade), a pressure
+ *   reading (in pascals), and a humidity reading, which can be
+ *   devided by 1024 to give percent relative humidity.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+TPH32CompData BME280::GetComp32FixedData()
+{
+    if (!cparams.loaded) this->LoadCalParams();
+
+    TPH32SensorData sensdat = this->GetSensorData();
+    TPH32CompData   compdat = Comp32FixedData(cparams, sensdat);
+
+    cparams.tfine = compdat.tfine;
+
+    return compdat;
+}
+
+/*
+ * TPHDoubleCompData BME280::GetCompDoubleData()
+ *
+ * Description:
+ *   Retrieves a temperature, pressure, and humidity reading and applies
+ *   double floating-point compensation.
+ *
+ *   Temperature compensation is performed first, in order to generate
+ *   the 32-bit integer (tfine) that is required for pressure and
+ *   humidity compensation.
+ *
+ * Returns:
+ *   Returns a TPHDoubleCompData structure containing a time stamp, a
+ *   temperature reading (in degrees centigrade), a pressure reading (in
+ *   pascals), and a humidity reading (in percent relative humidity).
+ */
+TPHDoubleCompData BME280::GetCompDoubleData()
+{
+    if (!cparams.loaded) this->LoadCalParams();
+
+    TPH32SensorData   sensdat = this->GetSensorData();
+    TPHDoubleCompData compdat = CompDoubleData(pcal, sensdat);
+
+    cparams.tfine = compdat.tfine;
+
+    return compdat;
+}
+
+/*
+ * TPHFloatCompData BME280::GetCompFloatData()
+ *
+ * Description:
+ *   Retrieves a temperature, pressure, and humidity reading and applies
+ *   single-precision floating-point compensation.
+ *
+ * Returns:
+ *   Returns a TPHFloatCompData structure containing a time stamp, a
+ *   temperature reading (in degrees centigrade), a pressure reading (in
+ *   pascals), and a humidity reading (in percent relative humidity).
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+TPHFloatCompData BME280::GetCompFloatData()
+{
+    if (!cparams.loaded) this->LoadCalParams();
+
+    TPH32SensorData  sensdat = this->GetSensorData();
+    TPHFloatCompData compdat = CompFloatData(pcalf, sensdat);
+
+    cparams.tfine = compdat.tfine;
+
+    return compdat;
+}
+
+/*
+ * void BME280::SetConfig()
+ *
+ * Description:
+ *   Loads the weather monitoring configuration (ConfigWeather).
+ *
+ *   Only registers that differ from the values last written are
+ *   sent. If nothing changes, there is no bus traffic.
+ *
+ *   Configuration writes take effect at once and need no settle
+ *   time, so this returns without the old BME280_CONFIG_DELAY
+ *   sleep. In normal mode, the first measurement is ready after
+ *   MeasureTime(true).
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+void BME280::SetConfig()
+{
+    this->ApplyConfig(ConfigWeather);
+}
+
+/*
+ * bool BME280::ApplyConfig(const Config& cfg)
+ *
+ * Description:
+ *   Loads a new device configuration. May be called at any time,
+ *   for instance to switch between a low-power forced mode profile
+ *   and a high-rate normal mode profile.
+ *
+ *   Writes to the config register may be ignored while the device
+ *   is in normal mode, so if config changes while the device is
+ *   running, it is put to sleep first. The new mode takes effect
+ *   with the final ctrl_meas write.
+ *
+ *   Only registers that differ from the values last written are
+ *   sent. Returns without a delay.
+ *
+ * Parameters:
+ *   cfg - the new configuration
+ *
+ * Returns:
+ *   Returns true if anything was written.
+ *
+ * Exceptions:
+ *   Throws std::invalid_argument if cfg.IsValid() is false.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ *   bme280_config.hpp
+ */
+bool BME280::ApplyConfig(const Config& cfg)
+{
+    if (!cfg.IsValid())
+        throw invalid_argument("BME280::ApplyConfig(): invalid configuration");
+
+    if (!shadow_valid) this->LoadShadowRegs();
+
+    if (((shadow_meas & BME280_MODE_MSK) == BME280_MODE_NORMAL) &&
+        (cfg.ConfReg() != shadow_conf))
+        this->WriteCtrlMeas(shadow_meas & BME280_MODE_MSK_OUT);
+
+    return this->WriteConfig(cfg.CtrlHum(), cfg.CtrlMeas(), cfg.ConfReg());
+}
+
+/*
+ * Config BME280::GetConfig()
+ *
+ * Description:
+ *   Returns the current device configuration, as held in the shadow
+ *   registers. A forced mode configuration reads back as sleep
+ *   mode once its measurement cycle has completed.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ *   bme280_config.hpp
+ */
+Config BME280::GetConfig()
+{
+    if (!shadow_valid) this->LoadShadowRegs();
+
+    return Config::FromRegs(shadow_hum, shadow_meas, shadow_conf);
+}
+
+/*
+ * void BME280::Force()
+ *
+ * Description:
+ *   Manually initiates a measurement cycle. The ctrl_meas value
+ *   comes from its shadow copy, so this is a single write.
+ *
+ * Initial Conditions:
+ *   All other configuration settings must be completed before
+ *   calling this function.
+ *
+ *   The sensor must be in sleep mode.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280.hpp
+ */
+void BME280::Force()
+{
+    if (!shadow_valid) this->LoadShadowRegs();
+
+    this->WriteCtrlMeas((shadow_meas & BME280_MODE_MSK_OUT) | BME280_MODE_FORCED, OP_FORCE);
+    forced = SteadyNanos();
+}
+
+/*
+ * TPH32SensorData BME280::ReadAndForce(uint8_t& status)
+ *
+ * Description:
+ *   Reads the status register and the sample from the previous
+ *   forced measurement (0xF3 - 0xFE), and triggers the next forced
+ *   measurement, in one combined transfer. On transports that can
+ *   chain messages, such as I2CRdwrTransport, this is a single
+ *   system call per sample.
+ *
+ *   For a paced forced-mode loop, call Force() once, then call
+ *   ReadAndForce() once per period. The period must be at least the
+ *   maximum measurement time; a set measuring bit in status means
+ *   the sample is from an earlier conversion.
+ *
+ *   The sample time is the previous trigger time plus half the
+ *   typical measurement time.
+ *
+ * Parameters:
+ *   status - receives the status register value
+ *
+ * Returns:
+ *   Returns a structure containing uncompensated temperature,
+ *   pressure, and humidity data, along with a time stamp.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280.hpp
+ */
+TPH32SensorData BME280::ReadAndForce(uint8_t& status)
+{
+    if (!shadow_valid) this->LoadShadowRegs();
+
+    uint8_t regdat[BME280_STATDATA_SIZE] {0};
+    uint8_t meas = (shadow_meas & BME280_MODE_MSK_OUT) | BME280_MODE_FORCED;
+    uint8_t dat[] { BME280_R_CTRL_MEA, meas };
+
+    int64_t prev  = forced;
+    int64_t start = SteadyNanos();
+    this->ReadWriteRegs(OP_FORCE, BME280_R_STAT, regdat, BME280_STATDATA_SIZE, dat, 2);
+    int64_t end   = SteadyNanos();
+
+    status = regdat[0];
+    forced = end;
+
+    TPH32SensorData sensdat = this->MakeSensorData(regdat + (BME280_DATA_START - BME280_R_STAT),
+                                                   start, end);
+
+    if (prev != 0)
+    {
+        sensdat.sampled   = prev + (int64_t)MeasureTimeTyp(shadow_hum, shadow_meas) * 500;
+        sensdat.timestamp = WallSeconds(sensdat.sampled);
+    }
+
+    return sensdat;
+}
+
+/*
+ * uint32_t BME280::MeasureTime(bool max)
+ *
+ * Description:
+ *   Computes the duration of one measurement cycle from the device's
+ *   current oversampling settings, as held in the shadow registers.
+ *
+ * Parameters:
+ *   max - Optional. If true, returns the data sheet maximum rather
+ *         than the typical time.
+ *         Default value is false.
+ *
+ * Returns:
+ *   Returns measurement time, in microseconds.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280.hpp
+ */
+uint32_t BME280::MeasureTime(bool max)
+{
+    if (!shadow_valid) this->LoadShadowRegs();
+
+    if (max)
+        return MeasureTimeMax(shadow_hum, shadow_meas);
+
+    return MeasureTimeTyp(shadow_hum, shadow_meas);
+}
+
+/*
+ * TPHDoubleCompData BME280::ForceAndRead(bool poll)
+ *
+ * Description:
+ *   Initiates a forced measurement, waits for it to complete, and
+ *   returns the compensated result.
+ *
+ *   The wait is computed from the active oversampling settings. With
+ *   polling, the function sleeps for the typical measurement time
+ *   and then polls the status register until the measuring bit
+ *   clears, giving up at the maximum measurement time. Without
+ *   polling, it sleeps for the maximum measurement time.
+ *
+ *   The sample time is the trigger time plus half the typical
+ *   measurement time.
+ *
+ * Parameters:
+ *   poll - Optional. If true, polls the status register after the
+ *          typical measurement time.
+ *          Default value is true.
+ *
+ * Initial Conditions:
+ *   All other configuration settings must be completed before
+ *   calling this function.
+ *
+ *   The sensor must be in sleep mode.
+ *
+ * Returns:
+ *   Returns a TPHDoubleCompData structure, as GetCompDoubleData().
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280.hpp
+ */
+TPHDoubleCompData BME280::ForceAndRead(bool poll)
+{
+    this->Force();
+
+    steady_clock::time_point start = steady_clock::now();
+    uint32_t ttyp = MeasureTimeTyp(shadow_hum, shadow_meas);
+    uint32_t tmax = MeasureTimeMax(shadow_hum, shadow_meas);
+
+    if (poll)
+    {
+        this_thread::sleep_until(start + microseconds(ttyp));
+
+        uint8_t stat;
+        this->ReadRegs(OP_DATA, BME280_R_STAT, &stat, 1);
+
+        while ((stat & BME280_STATUS_MEASURING) &&
+               (steady_clock::now() < start + microseconds(tmax)))
+        {
+            this_thread::sleep_for(microseconds(BME280_POLL_INTERVAL));
+            this->ReadRegs(OP_DATA, BME280_R_STAT, &stat, 1);
+        }
+    }
+    else
+    {
+        this_thread::sleep_until(start + microseconds(tmax));
+    }
+
+    TPHDoubleCompData compdat = this->GetCompDoubleData();
+
+    // The trigger time is known, so the conversion midpoint is too.
+    compdat.sampled   = duration_cast<nanoseconds>(start.time_since_epoch()).count() + (int64_t)ttyp * 500;
+    compdat.timestamp = WallSeconds(compdat.sampled);
+
+    return compdat;
+}
+
+/*
+ * uint8_t BME280::ReadStatus()
+ *
+ * Description:
+ *   Reads the status register.
+ *
+ * Returns:
+ *   Returns the status register value. BME280_STATUS_MEASURING is
+ *   set while a conversion runs; BME280_STATUS_IM_UPDATE is set
+ *   while calibration data is copied from NVM.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280.hpp
+ */
+uint8_t BME280::ReadStatus()
+{
+    uint8_t stat;
+    this->ReadRegs(OP_OTHER, BME280_R_STAT, &stat, 1);
+
+    return stat;
+}
+
+/*
+ * bool BME280::WaitStatus(uint8_t mask, uint32_t timeout)
+ *
+ * Description:
+ *   Polls the status register every BME280_POLL_INTERVAL until the
+ *   bits in mask are clear. A read that fails counts as not ready,
+ *   since a device coming out of reset may not answer at once.
+ *
+ * Parameters:
+ *   mask    - status bits to wait on
+ *   timeout - longest wait, in microseconds
+ *
+ * Returns:
+ *   Returns true if the bits cleared, false on timeout.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280.hpp
+ */
+bool BME280::WaitStatus(uint8_t mask, uint32_t timeout)
+{
+    steady_clock::time_point end = steady_clock::now() + microseconds(timeout);
+
+    for (;;)
+    {
+        try
+        {
+            if ((this->ReadStatus() & mask) == 0)
+                return true;
+        }
+        catch (...)
+        {
+        }
+
+        if (steady_clock::now() >= end)
+            return false;
+
+        this_thread::sleep_for(microseconds(BME280_POLL_INTERVAL));
+    }
+}
+
+/*
+ * void BME280::BeginReset()
+ *
+ * Description:
+ *   Sends the reset command and returns at once. The device is not
+ *   usable until BME280_RESET_DELAY has passed; callers that cannot
+ *   sleep, such as BME280Async, wait for it themselves. Status may
+ *   read clear before the NVM copy starts, so do not poll it until
+ *   BME280_NVM_MIN_DELAY has passed.
+ *
+ *   Shadow registers take the device reset values (zero).
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280.hpp
+ */
+void BME280::BeginReset()
+{
+    uint8_t dat[] { BME280_R_RESET, BME280_CMD_RESET };
+    this->WriteRegs(OP_CONFIG, dat, 2);
+
+    shadow_hum   = 0;
+    shadow_meas  = 0;
+    shadow_conf  = 0;
+    shadow_valid = true;
+    forced       = 0;
+}
+
+/*
+ * void BME280::Reset(bool reload)
+ *
+ * Description:
+ *   Resets the device, and returns once the status register shows
+ *   that the NVM copy is done. Status is first polled after
+ *   BME280_NVM_MIN_DELAY, since it may read clear before the copy
+ *   starts. Optionally, reloads device configuration when reset is
+ *   complete.
+ *
+ *   Shadow registers take the device reset values (zero).
+ *
+ * Parameters:
+ *   reload - Optional. If true, reloads configuration settings
+ *            following the reset.
+ *            Default value is false.
+ *
+ * Exceptions:
+ *   Throws std::runtime_error if the NVM copy has not finished
+ *   BME280_NVM_TIMEOUT after the reset, the limit StartDevices()
+ *   also uses.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280.hpp
+ */
+void BME280::Reset(bool reload)
+{
+    this->BeginReset();
+    this_thread::sleep_for(microseconds(BME280_NVM_MIN_DELAY));
+
+    if (!this->WaitStatus(BME280_STATUS_IM_UPDATE,
+                          BME280_NVM_TIMEOUT * 1000 - BME280_NVM_MIN_DELAY))
+        throw runtime_error("BME280::Reset(): NVM copy did not finish");
+
+    if (reload)
+        this->SetConfig();
+}
+
+/*
+ * void BME280::Sleep()
+ *
+ * Description:
+ *   Places the device in sleep mode by setting the ctrl_meas
+ *   register mode bits to zero. The ctrl_meas value comes from its
+ *   shadow copy, so this is a single write.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+void BME280::Sleep()
+{
+    if (!shadow_valid) this->LoadShadowRegs();
+
+    this->WriteCtrlMeas(shadow_meas & BME280_MODE_MSK_OUT);
+}
+
+/*
+ * StatsSnapshot BME280::GetStats()
+ *
+ * Description:
+ *   Returns a copy of the bus transfer counters and latency
+ *   histograms, per operation. Does not take the device mutex, so
+ *   it may be called from any thread while acquisition runs.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ *   bme280_stats.hpp
+ */
+StatsSnapshot BME280::GetStats()
+{
+    return stats.Snapshot();
+}
+
+/*
+ * void BME280::ResetStats()
+ *
+ * Description:
+ *   Zeroes the bus transfer counters and latency histograms.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+void BME280::ResetStats()
+{
+    stats.Reset();
 }
 
 } // namespace bosch_bme280
-```
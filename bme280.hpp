@@ -1,4 +1,3 @@
-```
 /*
  * bme280.hpp
  *
@@ -18,12 +17,17 @@
 #define BME280_HPP_
 
 #include <mutex>             // mutex
+#include <stddef.h>          // size_t
 #include <stdint.h>          // int16_t, uint16_t
 
 #include "bbb-i2c.hpp"       // I2CBus
 
 #include "bme280_defs.hpp"
+#include "bme280_config.hpp"
 #include "bme280_data.hpp"
+#include "bme280_comp.hpp"
+#include "bme280_stats.hpp"
+#include "bme280_time.hpp"
 
 
 using bbbi2c::I2CBus;
@@ -40,40 +44,199 @@ class BME280
 	uint8_t i2caddr;
 	uint8_t chipid;
 
-	CalParams cparams;
+	uint8_t shadow_hum;      // last ctrl_hum  value written
+	uint8_t shadow_meas;     // last ctrl_meas value written, mode bits as
+	                         // they stand once a forced cycle completes
+	uint8_t shadow_conf;     // last config    value written
+	bool    shadow_valid;
+	int64_t forced;          // steady clock of the last forced trigger, ns
 
-	void  GetRegs  ( uint8_t regaddr, uint8_t* data, int len );
-	void  SetRegs  ( uint8_t* data, int len );
+	uint8_t   rawcal[BME280_CAL_SIZE];
+	CalParams cparams;
+	PreparedCalibration pcal;
+	PreparedFloatCalibration pcalf;
+
+	DeviceStats stats;
+
+	virtual void  GetRegs  ( uint8_t regaddr, uint8_t* data, int len );
+	virtual void  SetRegs  ( uint8_t* data, int len );
+	virtual void  GetSetRegs ( uint8_t regaddr, uint8_t* data, int len,
+	                           uint8_t* wdata, int wlen );
+
+	void  ReadRegs        ( BusOp op, uint8_t regaddr, uint8_t* data, int len );
+	void  WriteRegs       ( BusOp op, uint8_t* data, int len );
+	void  ReadWriteRegs   ( BusOp op, uint8_t regaddr, uint8_t* data, int len,
+	                        uint8_t* wdata, int wlen );
+	void  LoadShadowRegs  ();
+	bool  WriteConfig     ( uint8_t hum, uint8_t meas, uint8_t conf );
+	void  WriteCtrlMeas   ( uint8_t meas, BusOp op=OP_CONFIG );
+	void  StampSensorData ( TPH32SensorData& sensdat, int64_t start, int64_t end );
+	TPH32SensorData  MakeSensorData ( const uint8_t* regdat, int64_t start, int64_t end );
+
+	template <class Get>
+	void  ReadRegsVia ( Get get, BusOp op, uint8_t regaddr, uint8_t* data, int len );
+	template <class Get>
+	TPH32SensorData  SensorDataVia ( Get get );
+	template <class Get>
+	TPH32SensorData  SensorDataVia ( Get get, uint8_t& status );
 
   public:
 
 	std::mutex mtx;
 
 	BME280 ( I2CBus* bus, uint8_t addr );
-   ~BME280 ();
+	virtual ~BME280 ();
+
+	static void* operator new      ( size_t size );
+	static void* operator new[]    ( size_t size );
+	static void  operator delete   ( void* ptr );
+	static void  operator delete[] ( void* ptr );
+
+	uint8_t   ReadChipId ();
+	uint8_t   GetChipId  ();
+	uint8_t   GetAddress ();
 
 	void      LoadCalParams ();
+	CalParams GetCalParams  ();
+	void      GetRawCalibration ( uint8_t* cal );
+	PreparedCalibration      GetPreparedCalibration ();
+	PreparedFloatCalibration GetPreparedFloatCalibration ();
+
 	 int32_t  Comp32FixedTemp  ( uint32_t unctemp  );
 	uint32_t  Comp32FixedPress ( uint32_t uncpress );
 	uint32_t  Comp32FixedHumid ( uint32_t unchum   );
+	uint32_t  Comp64FixedPress ( uint32_t uncpress );
+	void      Comp32FixedBatch ( const TPH32SensorData* sensdat, size_t count,
+	                             int32_t* temp, uint32_t* press, uint32_t* humid );
 
 	double  CompDoubleTemp  ( uint32_t unctemp  );
 	double  CompDoublePress ( uint32_t uncpress );
 	double  CompDoubleHumid ( uint32_t unchum   );
 
 	TPH32SensorData    GetSensorData ();
+	TPH32SensorData    GetSensorData ( uint8_t& status );
 	TPH32CompData      GetComp32FixedData ();
 	TPHDoubleCompData  GetCompDoubleData ();
+	TPHFloatCompData   GetCompFloatData ();
 
-	void  SetConfig ();
+	void    SetConfig   ();
+	bool    ApplyConfig ( const Config& cfg );
+	Config  GetConfig   ();
+
+	uint32_t  MeasureTime ( bool max=false );
 
 	void  Force ();
+	TPH32SensorData  ReadAndForce ( uint8_t& status );
+	TPHDoubleCompData  ForceAndRead ( bool poll=true );
 	void  Reset ( bool reload=false );
+	void  BeginReset ();
+
+	uint8_t  ReadStatus ();
+	bool     WaitStatus ( uint8_t mask, uint32_t timeout );
 	void  Sleep ();
 
+	StatsSnapshot  GetStats   ();
+	void           ResetStats ();
+
 }; // class BME280
 
+
+// BME280 Read Path
+// -----------------------------------------------------------------
+// The register read loop is a template on the function that does the
+// transfer. BME280 passes its virtual GetRegs(); BME280Dev passes its
+// transport's Read(), which then inlines with no indirection.
+
+/*
+ * template <class Get>
+ * void BME280::ReadRegsVia(Get get, BusOp op, uint8_t regaddr, uint8_t* data, int len)
+ *
+ * Description:
+ *   Reads registers by calling get(regaddr, data, len), and records
+ *   the transfer in the device statistics. A failed read is retried
+ *   up to BME280_XFER_RETRIES times.
+ *
+ * Parameters:
+ *   get      - void get(uint8_t regaddr, uint8_t* data, int len)
+ *   op       - operation the transfer is counted under
+ *   regaddr  - address of the first register to be read
+ *   data     - pointer to a buffer that will receive data
+ *   len      - the number of bytes to read
+ *
+ * Exceptions:
+ *   Rethrows the exception from the last failed attempt.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280.hpp
+ */
+template <class Get>
+void BME280::ReadRegsVia(Get get, BusOp op, uint8_t regaddr, uint8_t* data, int len)
+{
+    for (int attempt = 0; ; attempt++)
+    {
+        int64_t start = SteadyNanos();
+        try
+        {
+            get(regaddr, data, len);
+        }
+        catch (...)
+        {
+            stats.Error(op);
+            if (attempt >= BME280_XFER_RETRIES) throw;
+
+            stats.Retry(op);
+            continue;
+        }
+
+        stats.Record(op, len, SteadyNanos() - start);
+        return;
+    }
+}
+
+/*
+ * template <class Get>
+ * TPH32SensorData BME280::SensorDataVia(Get get)
+ * TPH32SensorData BME280::SensorDataVia(Get get, uint8_t& status)
+ *
+ * Description:
+ *   GetSensorData(), with the data registers, or the status and data
+ *   registers, read through get as for ReadRegsVia().
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280.hpp
+ */
+template <class Get>
+TPH32SensorData BME280::SensorDataVia(Get get)
+{
+    uint8_t regdat[BME280_DATA_SIZE] {0};
+
+    int64_t start = SteadyNanos();
+    this->ReadRegsVia(get, OP_DATA, BME280_DATA_START, regdat, BME280_DATA_SIZE);
+    int64_t end   = SteadyNanos();
+
+    return this->MakeSensorData(regdat, start, end);
+}
+
+template <class Get>
+TPH32SensorData BME280::SensorDataVia(Get get, uint8_t& status)
+{
+    uint8_t regdat[BME280_STATDATA_SIZE] {0};
+
+    int64_t start = SteadyNanos();
+    this->ReadRegsVia(get, OP_DATA, BME280_R_STAT, regdat, BME280_STATDATA_SIZE);
+    int64_t end   = SteadyNanos();
+
+    status = regdat[0];
+
+    return this->MakeSensorData(regdat + (BME280_DATA_START - BME280_R_STAT), start, end);
+}
+
 } // namespace bosch_bme280
 
 #endif /* BME280_HPP_ */
-```
@@ -0,0 +1,969 @@
+/*
+ * bme280_archive.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Compressed columnar archive of compensated BME280 series.
+ *
+ *  Notes:
+ *    1. Time stamps. The first time stamp of a block is stored in 64
+ *       bits. Each later one is stored as the change in the interval
+ *       between samples (delta of delta), with a variable-length code:
+ *
+ *         0                         dod == 0
+ *         10   +  8 bits            -128      .. 127
+ *         110  + 14 bits            -8192     .. 8191
+ *         1110 + 24 bits            -8388608  .. 8388607
+ *         1111 + 64 bits            anything else
+ *
+ *    2. Values. The first value of a block is stored in 64 bits. Each
+ *       later one is XORed with its predecessor:
+ *
+ *         0                         same value
+ *         10 + meaningful bits      non-zero bits fit the previous
+ *                                   leading/trailing zero window
+ *         11 + 5 bits leading zeros + 6 bits (length - 1) + bits
+ *
+ *    3. Bit streams are written most significant bit first and padded
+ *       to a whole byte, so every stream of a block can be decoded on
+ *       its own.
+ */
+
+
+#include <algorithm>         // lower_bound, min, max
+#include <fstream>           // ifstream, ofstream
+#include <limits>            // numeric_limits
+#include <stdexcept>         // invalid_argument, runtime_error
+#include <string.h>          // memcpy, memcmp
+
+#include "bme280_archive.hpp"
+#include "bme280_time.hpp"
+
+
+using namespace std;
+
+
+namespace bosch_bme280
+{
+
+// Bit Streams
+// -----------------------------------------------------------------
+
+/*
+ * class BitWriter
+ *
+ * Description:
+ *   Appends bit fields to a byte vector, most significant bit first.
+ */
+class BitWriter
+{
+    vector<uint8_t>&  out;
+    uint64_t          acc;
+    int               n;
+
+  public:
+
+    BitWriter ( vector<uint8_t>& dest )
+      : out(dest), acc(0), n(0) { }
+
+    void Put ( uint64_t v, int bits )
+    {
+        if (bits < 64) v &= (1ULL << bits) - 1;
+
+        while (bits > 0)
+        {
+            int      room = 64 - n;
+            int      take = (bits < room) ? bits : room;
+            uint64_t part = (take == bits) ? v : (v >> (bits - take));
+
+            if (take < 64) part &= (1ULL << take) - 1;
+
+            acc  |= part << (room - take);
+            n    += take;
+            bits -= take;
+
+            if (n == 64)
+            {
+                for (int s = 56; s >= 0; s -= 8)
+                    out.push_back((uint8_t)(acc >> s));
+                acc = 0;
+                n   = 0;
+            }
+        }
+    }
+
+    void Finish ( )
+    {
+        for (int s = 56; n > 0; s -= 8, n -= 8)
+            out.push_back((uint8_t)(acc >> s));
+        acc = 0;
+        n   = 0;
+    }
+};
+
+/*
+ * class BitReader
+ *
+ * Description:
+ *   Reads bit fields written by BitWriter. Reads past the end
+ *   return zero bits.
+ */
+class BitReader
+{
+    const uint8_t*  p;
+    size_t          size;
+    size_t          pos;     // in bits
+
+  public:
+
+    BitReader ( const uint8_t* data, size_t len )
+      : p(data), size(len), pos(0) { }
+
+    uint64_t Get ( int bits )
+    {
+        uint64_t v = 0;
+
+        while (bits > 0)
+        {
+            size_t  byte  = pos >> 3;
+            int     avail = 8 - (int)(pos & 7);
+            int     take  = (bits < avail) ? bits : avail;
+            uint8_t b     = (byte < size) ? p[byte] : 0;
+
+            v = (v << take) | ((b >> (avail - take)) & ((1u << take) - 1));
+
+            pos  += take;
+            bits -= take;
+        }
+
+        return v;
+    }
+};
+
+static inline int64_t SignExtend(uint64_t v, int bits)
+{
+    return (int64_t)(v << (64 - bits)) >> (64 - bits);
+}
+
+static inline uint64_t DoubleBits(double d)
+{
+    uint64_t u;
+    memcpy(&u, &d, sizeof(u));
+    return u;
+}
+
+static inline double BitsDouble(uint64_t u)
+{
+    double d;
+    memcpy(&d, &u, sizeof(d));
+    return d;
+}
+
+
+// Column Codecs
+// -----------------------------------------------------------------
+
+/*
+ * Encodes n time stamps, delta of delta.
+ */
+static void EncodeTimes(const int64_t* t, size_t n, vector<uint8_t>& out)
+{
+    BitWriter w(out);
+
+    w.Put((uint64_t)t[0], 64);
+
+    int64_t pdelta = 0;
+    for (size_t i = 1; i < n; i++)
+    {
+        int64_t delta = t[i] - t[i - 1];
+        int64_t dod   = delta - pdelta;
+
+        if (dod == 0)
+            w.Put(0, 1);
+        else if ((dod >= -128) && (dod <= 127))
+        {
+            w.Put(0x2, 2);
+            w.Put((uint64_t)dod, 8);
+        }
+        else if ((dod >= -8192) && (dod <= 8191))
+        {
+            w.Put(0x6, 3);
+            w.Put((uint64_t)dod, 14);
+        }
+        else if ((dod >= -8388608) && (dod <= 8388607))
+        {
+            w.Put(0xE, 4);
+            w.Put((uint64_t)dod, 24);
+        }
+        else
+        {
+            w.Put(0xF, 4);
+            w.Put((uint64_t)dod, 64);
+        }
+
+        pdelta = delta;
+    }
+
+    w.Finish();
+}
+
+/*
+ * Decodes n time stamps written by EncodeTimes().
+ */
+static void DecodeTimes(const uint8_t* p, size_t size, size_t n, int64_t* t)
+{
+    BitReader r(p, size);
+
+    t[0] = (int64_t)r.Get(64);
+
+    int64_t pdelta = 0;
+    for (size_t i = 1; i < n; i++)
+    {
+        int64_t dod;
+
+        if (r.Get(1) == 0)
+            dod = 0;
+        else if (r.Get(1) == 0)
+            dod = SignExtend(r.Get(8), 8);
+        else if (r.Get(1) == 0)
+            dod = SignExtend(r.Get(14), 14);
+        else if (r.Get(1) == 0)
+            dod = SignExtend(r.Get(24), 24);
+        else
+            dod = (int64_t)r.Get(64);
+
+        pdelta += dod;
+        t[i]    = t[i - 1] + pdelta;
+    }
+}
+
+/*
+ * Encodes n doubles, XOR against the previous value.
+ */
+static void EncodeValues(const double* v, size_t n, vector<uint8_t>& out)
+{
+    BitWriter w(out);
+
+    uint64_t prev  = DoubleBits(v[0]);
+    int      plead = -1;
+    int      ptrail = 0;
+
+    w.Put(prev, 64);
+
+    for (size_t i = 1; i < n; i++)
+    {
+        uint64_t cur = DoubleBits(v[i]);
+        uint64_t x   = cur ^ prev;
+        prev = cur;
+
+        if (x == 0)
+        {
+            w.Put(0, 1);
+            continue;
+        }
+
+        int lead  = __builtin_clzll(x);
+        int trail = __builtin_ctzll(x);
+        if (lead > 31) lead = 31;
+
+        if ((plead >= 0) && (lead >= plead) && (trail >= ptrail))
+        {
+            w.Put(0x2, 2);
+            w.Put(x >> ptrail, 64 - plead - ptrail);
+        }
+        else
+        {
+            int len = 64 - lead - trail;
+
+            w.Put(0x3, 2);
+            w.Put((uint64_t)lead, 5);
+            w.Put((uint64_t)(len - 1), 6);
+            w.Put(x >> trail, len);
+
+            plead  = lead;
+            ptrail = trail;
+        }
+    }
+
+    w.Finish();
+}
+
+/*
+ * Decodes n doubles written by EncodeValues().
+ */
+static void DecodeValues(const uint8_t* p, size_t size, size_t n, double* v)
+{
+    BitReader r(p, size);
+
+    uint64_t prev  = r.Get(64);
+    int      lead  = 0;
+    int      trail = 0;
+
+    v[0] = BitsDouble(prev);
+
+    for (size_t i = 1; i < n; i++)
+    {
+        if (r.Get(1) != 0)
+        {
+            if (r.Get(1) != 0)
+            {
+                lead  = (int)r.Get(5);
+                int len = (int)r.Get(6) + 1;
+                trail = 64 - lead - len;
+            }
+
+            prev ^= r.Get(64 - lead - trail) << trail;
+        }
+
+        v[i] = BitsDouble(prev);
+    }
+}
+
+
+// BME280Archive Constructor
+// -----------------------------------------------------------------
+
+/*
+ * BME280Archive::BME280Archive()
+ *
+ * Description:
+ *   Constructor. Creates an empty archive.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+BME280Archive::BME280Archive()
+{
+    ptime.reserve(BME280_ARCHIVE_BLOCK);
+    for (int c = 0; c < CH_COUNT; c++)
+        pval[c].reserve(BME280_ARCHIVE_BLOCK);
+}
+
+
+// BME280Archive Protected
+// -----------------------------------------------------------------
+
+/*
+ * void BME280Archive::Seal()
+ *
+ * Description:
+ *   Encodes the open block, appends it to the data, and adds its
+ *   header to the index.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+void BME280Archive::Seal()
+{
+    if (ptime.empty()) return;
+
+    ArchiveBlock blk;
+    memset(&blk, 0, sizeof(blk));
+
+    size_t n = ptime.size();
+
+    blk.t_first = ptime.front();
+    blk.t_last  = ptime.back();
+    blk.offset  = data.size();
+    blk.count   = (uint32_t)n;
+
+    size_t start = data.size();
+    EncodeTimes(ptime.data(), n, data);
+    blk.size[0] = (uint32_t)(data.size() - start);
+
+    for (int c = 0; c < CH_COUNT; c++)
+    {
+        start = data.size();
+        EncodeValues(pval[c].data(), n, data);
+        blk.size[1 + c] = (uint32_t)(data.size() - start);
+
+        ChannelSummary& s = blk.ch[c];
+        s.min = s.max = pval[c][0];
+        s.sum = 0.0;
+        for (size_t i = 0; i < n; i++)
+        {
+            s.min  = min(s.min, pval[c][i]);
+            s.max  = max(s.max, pval[c][i]);
+            s.sum += pval[c][i];
+        }
+
+        pval[c].clear();
+    }
+
+    ptime.clear();
+    index.push_back(blk);
+}
+
+/*
+ * void BME280Archive::DecodeBlock(const ArchiveBlock& blk, int ch, int64_t* t, double* v) const
+ *
+ * Description:
+ *   Decodes the time column and/or one value column of a block.
+ *
+ * Parameters:
+ *   blk - block header
+ *   ch  - Channel to decode into v
+ *   t   - receives blk.count time stamps, or null
+ *   v   - receives blk.count values, or null
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+void BME280Archive::DecodeBlock(const ArchiveBlock& blk, int ch, int64_t* t, double* v) const
+{
+    const uint8_t* p = data.data() + blk.offset;
+
+    if (t)
+        DecodeTimes(p, blk.size[0], blk.count, t);
+
+    if (v)
+    {
+        p += blk.size[0];
+        for (int c = 0; c < ch; c++)
+            p += blk.size[1 + c];
+
+        DecodeValues(p, blk.size[1 + ch], blk.count, v);
+    }
+}
+
+
+// BME280Archive Public
+// -----------------------------------------------------------------
+
+/*
+ * void BME280Archive::Append(int64_t t, double temperature, double pressure, double humidity)
+ *
+ * Description:
+ *   Appends one sample. Seals the open block when it is full.
+ *
+ * Parameters:
+ *   t           - wall clock time, microseconds since the epoch
+ *   temperature - degrees C
+ *   pressure    - Pa
+ *   humidity    - %RH
+ *
+ * Exceptions:
+ *   Throws std::invalid_argument if t is earlier than the last
+ *   sample appended.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+void BME280Archive::Append(int64_t t, double temperature, double pressure, double humidity)
+{
+    int64_t last = !ptime.empty()  ? ptime.back() :
+                   !index.empty()  ? index.back().t_last :
+                                     numeric_limits<int64_t>::min();
+    if (t < last)
+        throw invalid_argument("BME280Archive::Append(): sample out of time order");
+
+    ptime.push_back(t);
+    pval[CH_TEMPERATURE].push_back(temperature);
+    pval[CH_PRESSURE].push_back(pressure);
+    pval[CH_HUMIDITY].push_back(humidity);
+
+    if (ptime.size() >= BME280_ARCHIVE_BLOCK)
+        this->Seal();
+}
+
+/*
+ * void BME280Archive::Append(const TPHDoubleCompData& compdat)
+ *
+ * Description:
+ *   Appends one compensated sample. The time is the sample time
+ *   converted to the wall clock, or the time stamp if there is no
+ *   sample time.
+ *
+ * Exceptions:
+ *   Throws std::invalid_argument if the sample is earlier than the
+ *   last sample appended.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+void BME280Archive::Append(const TPHDoubleCompData& compdat)
+{
+    int64_t t = compdat.sampled ? WallMicros(compdat.sampled) :
+                                  (int64_t)compdat.timestamp * 1000000;
+
+    this->Append(t, compdat.temperature, compdat.pressure, compdat.humidity);
+}
+
+/*
+ * void BME280Archive::Flush()
+ *
+ * Description:
+ *   Seals the open block, even if it is not full.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+void BME280Archive::Flush()
+{
+    this->Seal();
+}
+
+/*
+ * void BME280Archive::Clear()
+ *
+ * Description:
+ *   Removes all samples.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+void BME280Archive::Clear()
+{
+    index.clear();
+    data.clear();
+    ptime.clear();
+    for (int c = 0; c < CH_COUNT; c++)
+        pval[c].clear();
+}
+
+/*
+ * uint64_t BME280Archive::Size() const
+ *
+ * Description:
+ *   Returns the number of samples, sealed and open.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+uint64_t BME280Archive::Size() const
+{
+    uint64_t n = ptime.size();
+
+    for (size_t i = 0; i < index.size(); i++)
+        n += index[i].count;
+
+    return n;
+}
+
+/*
+ * size_t BME280Archive::Blocks() const
+ *
+ * Description:
+ *   Returns the number of sealed blocks.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+size_t BME280Archive::Blocks() const
+{
+    return index.size();
+}
+
+/*
+ * const std::vector<ArchiveBlock>& BME280Archive::Index() const
+ *
+ * Description:
+ *   Returns the block headers, in time order.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+const vector<ArchiveBlock>& BME280Archive::Index() const
+{
+    return index;
+}
+
+/*
+ * RangeSummary BME280Archive::Summarize(Channel ch, int64_t t0, int64_t t1) const
+ *
+ * Description:
+ *   Returns the count, minimum, maximum, and mean of one channel
+ *   over a time range. Blocks wholly inside the range are answered
+ *   from their headers; only blocks that straddle an end of the
+ *   range are decoded, and then only their time and ch columns.
+ *
+ * Parameters:
+ *   ch - the channel
+ *   t0 - range start, microseconds, inclusive
+ *   t1 - range end, microseconds, inclusive
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+RangeSummary BME280Archive::Summarize(Channel ch, int64_t t0, int64_t t1) const
+{
+    RangeSummary rs;
+    double       sum = 0.0;
+
+    auto merge = [&rs, &sum](double mn, double mx, double s, uint64_t n)
+    {
+        if (n == 0) return;
+
+        rs.min    = rs.count ? min(rs.min, mn) : mn;
+        rs.max    = rs.count ? max(rs.max, mx) : mx;
+        sum      += s;
+        rs.count += n;
+    };
+
+    vector<ArchiveBlock>::const_iterator it =
+        lower_bound(index.begin(), index.end(), t0,
+                    [](const ArchiveBlock& b, int64_t t) { return b.t_last < t; });
+
+    int64_t t[BME280_ARCHIVE_BLOCK];
+    double  v[BME280_ARCHIVE_BLOCK];
+
+    for ( ; (it != index.end()) && (it->t_first <= t1); ++it)
+    {
+        const ArchiveBlock& blk = *it;
+
+        if ((t0 <= blk.t_first) && (blk.t_last <= t1))
+        {
+            merge(blk.ch[ch].min, blk.ch[ch].max, blk.ch[ch].sum, blk.count);
+            rs.summarized++;
+            continue;
+        }
+
+        this->DecodeBlock(blk, ch, t, v);
+        rs.decoded++;
+
+        for (uint32_t i = 0; i < blk.count; i++)
+            if ((t[i] >= t0) && (t[i] <= t1))
+                merge(v[i], v[i], v[i], 1);
+    }
+
+    for (size_t i = 0; i < ptime.size(); i++)
+        if ((ptime[i] >= t0) && (ptime[i] <= t1))
+            merge(pval[ch][i], pval[ch][i], pval[ch][i], 1);
+
+    if (rs.count)
+        rs.mean = sum / (double)rs.count;
+
+    return rs;
+}
+
+/*
+ * size_t BME280Archive::Read(int64_t t0, int64_t t1, std::vector<ArchiveSample>& out) const
+ *
+ * Description:
+ *   Decodes every sample in a time range and appends it to out.
+ *
+ * Parameters:
+ *   t0  - range start, microseconds, inclusive
+ *   t1  - range end, microseconds, inclusive
+ *   out - receives the samples, in time order
+ *
+ * Returns:
+ *   Returns the number of samples appended.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+size_t BME280Archive::Read(int64_t t0, int64_t t1, vector<ArchiveSample>& out) const
+{
+    size_t before = out.size();
+
+    vector<ArchiveBlock>::const_iterator it =
+        lower_bound(index.begin(), index.end(), t0,
+                    [](const ArchiveBlock& b, int64_t t) { return b.t_last < t; });
+
+    int64_t t[BME280_ARCHIVE_BLOCK];
+    double  v[CH_COUNT][BME280_ARCHIVE_BLOCK];
+
+    for ( ; (it != index.end()) && (it->t_first <= t1); ++it)
+    {
+        this->DecodeBlock(*it, CH_TEMPERATURE, t, v[CH_TEMPERATURE]);
+        this->DecodeBlock(*it, CH_PRESSURE,    nullptr, v[CH_PRESSURE]);
+        this->DecodeBlock(*it, CH_HUMIDITY,    nullptr, v[CH_HUMIDITY]);
+
+        for (uint32_t i = 0; i < it->count; i++)
+        {
+            if ((t[i] < t0) || (t[i] > t1)) continue;
+
+            ArchiveSample s;
+            s.t = t[i];
+            for (int c = 0; c < CH_COUNT; c++)
+                s.value[c] = v[c][i];
+
+            out.push_back(s);
+        }
+    }
+
+    for (size_t i = 0; i < ptime.size(); i++)
+    {
+        if ((ptime[i] < t0) || (ptime[i] > t1)) continue;
+
+        ArchiveSample s;
+        s.t = ptime[i];
+        for (int c = 0; c < CH_COUNT; c++)
+            s.value[c] = pval[c][i];
+
+        out.push_back(s);
+    }
+
+    return out.size() - before;
+}
+
+
+// Archive File
+// -----------------------------------------------------------------
+
+struct ArchiveFileHeader
+{
+    char      magic[8];
+    uint32_t  version;
+    uint32_t  block_size;
+    uint64_t  blocks;
+    uint64_t  data_bytes;
+};
+
+static const char armagic[8] { 'B', 'M', 'E', '2', '8', '0', 'A', 'R' };
+
+/*
+ * static bool ValidBlock(const ArchiveBlock& blk, const ArchiveBlock* prev,
+ *                        uint64_t data_bytes)
+ *
+ * Description:
+ *   Checks a block header read from a file: a sample count from 1 to
+ *   BME280_ARCHIVE_BLOCK, streams that lie inside the data, a time
+ *   range in order, and a start no earlier than the end of the
+ *   previous block.
+ *
+ * Parameters:
+ *   blk        - the block header
+ *   prev       - the block before it, or null for the first
+ *   data_bytes - size of the block data
+ *
+ * Returns:
+ *   Returns true if the header can be used.
+ */
+static bool ValidBlock(const ArchiveBlock& blk, const ArchiveBlock* prev, uint64_t data_bytes)
+{
+    if (blk.count == 0 || blk.count > BME280_ARCHIVE_BLOCK)
+        return false;
+
+    if (blk.t_first > blk.t_last)
+        return false;
+
+    if (prev && blk.t_first < prev->t_last)
+        return false;
+
+    uint64_t end = blk.offset;
+    if (end > data_bytes)
+        return false;
+
+    for (int s = 0; s < 1 + CH_COUNT; s++)
+    {
+        end += blk.size[s];
+        if (end > data_bytes)
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ * void BME280Archive::Save(const std::string& path)
+ *
+ * Description:
+ *   Seals the open block and writes the archive to a file: a file
+ *   header, the block index, then the block data. Multi-byte fields
+ *   are in host byte order.
+ *
+ * Parameters:
+ *   path - archive file path
+ *
+ * Exceptions:
+ *   Throws std::runtime_error if the file cannot be written.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+void BME280Archive::Save(const string& path)
+{
+    this->Seal();
+
+    ArchiveFileHeader hdr;
+    memcpy(hdr.magic, armagic, sizeof(armagic));
+    hdr.version    = BME280_ARCHIVE_VERSION;
+    hdr.block_size = sizeof(ArchiveBlock);
+    hdr.blocks     = index.size();
+    hdr.data_bytes = data.size();
+
+    ofstream arfile(path.c_str(), ios::out | ios::binary | ios::trunc);
+    if (!arfile)
+        throw runtime_error("BME280Archive: cannot create " + path);
+
+    arfile.write((const char*)&hdr, sizeof(hdr));
+    arfile.write((const char*)index.data(), index.size() * sizeof(ArchiveBlock));
+    arfile.write((const char*)data.data(), data.size());
+    arfile.close();
+
+    if (!arfile)
+        throw runtime_error("BME280Archive: cannot write " + path);
+}
+
+/*
+ * void BME280Archive::Load(const std::string& path)
+ *
+ * Description:
+ *   Replaces the contents of the archive with a file written by
+ *   Save().
+ *
+ * Parameters:
+ *   path - archive file path
+ *
+ *   Every block header is checked before the archive is used: its
+ *   sample count, that its streams lie inside the data, and that the
+ *   blocks are in time order.
+ *
+ * Exceptions:
+ *   Throws std::runtime_error if the file cannot be read, is not an
+ *   archive of this version, or fails the checks. The archive is
+ *   then left empty.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+void BME280Archive::Load(const string& path)
+{
+    this->Clear();
+
+    ifstream arfile(path.c_str(), ios::in | ios::binary);
+    if (!arfile)
+        throw runtime_error("BME280Archive: cannot open " + path);
+
+    ArchiveFileHeader hdr;
+    arfile.read((char*)&hdr, sizeof(hdr));
+
+    if (!arfile ||
+        (memcmp(hdr.magic, armagic, sizeof(armagic)) != 0) ||
+        (hdr.version    != BME280_ARCHIVE_VERSION) ||
+        (hdr.block_size != sizeof(ArchiveBlock)))
+        throw runtime_error("BME280Archive: not an archive file " + path);
+
+    // Sizes must fit in the file before anything is allocated.
+    streamoff here = arfile.tellg();
+    arfile.seekg(0, ios::end);
+    uint64_t left = (uint64_t)(arfile.tellg() - here);
+    arfile.seekg(here);
+
+    if ((hdr.blocks > left / sizeof(ArchiveBlock)) ||
+        (hdr.data_bytes != left - hdr.blocks * sizeof(ArchiveBlock)))
+        throw runtime_error("BME280Archive: bad archive size " + path);
+
+    index.resize(hdr.blocks);
+    data.resize(hdr.data_bytes);
+
+    arfile.read((char*)index.data(), index.size() * sizeof(ArchiveBlock));
+    arfile.read((char*)data.data(), data.size());
+
+    if (!arfile)
+    {
+        this->Clear();
+        throw runtime_error("BME280Archive: short archive file " + path);
+    }
+
+    for (size_t i = 0; i < index.size(); i++)
+    {
+        if (!ValidBlock(index[i], i ? &index[i - 1] : nullptr, data.size()))
+        {
+            this->Clear();
+            throw runtime_error("BME280Archive: corrupt block index in " + path);
+        }
+    }
+}
+
+/*
+ * ArchiveBench BME280Archive::Benchmark() const
+ *
+ * Description:
+ *   Measures the sealed blocks: compression ratio against
+ *   TPHDoubleCompData structs, the rate of a full decode of every
+ *   column, and the time of a whole-archive summary from headers.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+ArchiveBench BME280Archive::Benchmark() const
+{
+    ArchiveBench ab;
+
+    for (size_t i = 0; i < index.size(); i++)
+        ab.samples += index[i].count;
+
+    ab.raw_bytes     = ab.samples * sizeof(TPHDoubleCompData);
+    ab.encoded_bytes = data.size() + index.size() * sizeof(ArchiveBlock);
+    ab.ratio         = ab.encoded_bytes ? (double)ab.raw_bytes / (double)ab.encoded_bytes : 0.0;
+
+    int64_t t[BME280_ARCHIVE_BLOCK];
+    double  v[BME280_ARCHIVE_BLOCK];
+
+    volatile double sink = 0.0;    // keeps the decode from being optimized away
+
+    int64_t start = SteadyNanos();
+    for (size_t i = 0; i < index.size(); i++)
+    {
+        for (int c = 0; c < CH_COUNT; c++)
+        {
+            this->DecodeBlock(index[i], c, (c == 0) ? t : nullptr, v);
+            sink = sink + v[index[i].count - 1];
+        }
+        sink = sink + (double)t[0];
+    }
+    int64_t elapsed = SteadyNanos() - start;
+
+    ab.scan_rate = elapsed ? (double)ab.samples * 1e9 / (double)elapsed : 0.0;
+
+    start = SteadyNanos();
+    RangeSummary rs = this->Summarize(CH_HUMIDITY, numeric_limits<int64_t>::min(),
+                                                   numeric_limits<int64_t>::max());
+    ab.summary_ns = SteadyNanos() - start;
+
+    sink = sink + rs.max;
+
+    return ab;
+}
+
+} // namespace bosch_bme280
@@ -0,0 +1,239 @@
+/*
+ * bme280_archive.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Compressed columnar archive of compensated BME280 series.
+ *
+ *    Samples are grouped into blocks of BME280_ARCHIVE_BLOCK. Within
+ *    a block, each column is a separate bit stream:
+ *
+ *      time        - wall clock microseconds, delta-of-delta encoded
+ *      temperature - doubles, XOR encoded against the previous value
+ *      pressure    -   "
+ *      humidity    -   "
+ *
+ *    This is the encoding of Facebook's Gorilla time series store.
+ *    A steady sample period costs one bit per time stamp, and slowly
+ *    changing values share sign, exponent, and leading mantissa bits
+ *    with their predecessors. Compression is lossless.
+ *
+ *    Each block has an ArchiveBlock header with its time range and
+ *    the minimum, maximum, and sum of each channel. The headers form
+ *    the time index. A range query summarizes blocks that lie wholly
+ *    inside the range from their headers alone, and decodes only the
+ *    time and the one requested channel of the blocks at its ends.
+ *
+ *  Example:
+ *    BME280Archive ar;
+ *    ar.Append(compdat);                           // as sampled
+ *    ...
+ *    RangeSummary rh = ar.Summarize(CH_HUMIDITY, now - 30 * 86400000000LL, now);
+ *    double maxhum   = rh.max;
+ */
+
+#ifndef BME280_ARCHIVE_HPP_
+#define BME280_ARCHIVE_HPP_
+
+#include <stddef.h>          // size_t
+#include <stdint.h>          // uint8_t, uint32_t, int64_t, uint64_t
+#include <string>            // string
+#include <vector>            // vector
+
+#include "bme280_data.hpp"
+#include "bme280_defs.hpp"
+
+
+namespace bosch_bme280
+{
+
+/*
+ * struct ChannelSummary
+ *
+ * Description:
+ *   Minimum, maximum, and sum of one channel over one block.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+struct ChannelSummary
+{
+    double  min;
+    double  max;
+    double  sum;
+};
+
+/*
+ * struct ArchiveBlock
+ *
+ * Description:
+ *   Block header and time index entry.
+ *
+ *     t_first, t_last - time range, wall clock microseconds
+ *     offset          - position of the block's streams in the data
+ *     count           - samples in the block
+ *     size            - bytes in each stream: time, then one per
+ *                       Channel. Streams are stored in that order.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+struct ArchiveBlock
+{
+    int64_t         t_first;
+    int64_t         t_last;
+    uint64_t        offset;
+    uint32_t        count;
+    uint32_t        size[1 + CH_COUNT];
+    uint32_t        reserved;
+    ChannelSummary  ch[CH_COUNT];
+};
+
+/*
+ * struct ArchiveSample
+ *
+ * Description:
+ *   One decoded sample. value is indexed by Channel.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+struct ArchiveSample
+{
+    int64_t  t;
+    double   value[CH_COUNT];
+};
+
+/*
+ * struct RangeSummary
+ *
+ * Description:
+ *   Result of a range query on one channel.
+ *
+ *     count          - samples in the range
+ *     min, max, mean - over those samples; zero if count is zero
+ *     summarized     - blocks answered from their headers
+ *     decoded        - blocks that had to be decoded
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+struct RangeSummary
+{
+    uint64_t  count;
+    double    min;
+    double    max;
+    double    mean;
+    size_t    summarized;
+    size_t    decoded;
+
+    RangeSummary ( )
+      : count(0), min(0.0), max(0.0), mean(0.0), summarized(0), decoded(0) { }
+};
+
+/*
+ * struct ArchiveBench
+ *
+ * Description:
+ *   Result of BME280Archive::Benchmark().
+ *
+ *     samples       - samples in sealed blocks
+ *     raw_bytes     - the same samples as TPHDoubleCompData structs
+ *     encoded_bytes - block streams plus headers
+ *     ratio         - raw_bytes / encoded_bytes
+ *     scan_rate     - samples per second, decoding every column
+ *     summary_ns    - time to summarize one channel over all
+ *                     blocks, from headers
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+struct ArchiveBench
+{
+    uint64_t  samples;
+    uint64_t  raw_bytes;
+    uint64_t  encoded_bytes;
+    double    ratio;
+    double    scan_rate;
+    int64_t   summary_ns;
+
+    ArchiveBench ( )
+      : samples(0), raw_bytes(0), encoded_bytes(0), ratio(0.0), scan_rate(0.0),
+        summary_ns(0) { }
+};
+
+/*
+ * class BME280Archive
+ *
+ * Description:
+ *   An in-memory compressed archive, with Save() and Load(). Samples
+ *   must be appended in time order. The newest samples are held
+ *   uncompressed until a block fills, or until Flush(); queries
+ *   include them.
+ *
+ *   Not thread safe. Const member functions may be called from
+ *   several threads at once.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_archive.hpp
+ */
+class BME280Archive
+{
+
+  protected:
+
+	std::vector<ArchiveBlock>  index;
+	std::vector<uint8_t>       data;
+
+	std::vector<int64_t>       ptime;             // open block
+	std::vector<double>        pval[CH_COUNT];
+
+	void  Seal        ();
+	void  DecodeBlock ( const ArchiveBlock& blk, int ch, int64_t* t, double* v ) const;
+
+  public:
+
+	BME280Archive ();
+
+	void  Append ( int64_t t, double temperature, double pressure, double humidity );
+	void  Append ( const TPHDoubleCompData& compdat );
+	void  Flush  ();
+	void  Clear  ();
+
+	uint64_t  Size   () const;
+	size_t    Blocks () const;
+	const std::vector<ArchiveBlock>&  Index () const;
+
+	RangeSummary  Summarize ( Channel ch, int64_t t0, int64_t t1 ) const;
+	size_t        Read      ( int64_t t0, int64_t t1, std::vector<ArchiveSample>& out ) const;
+
+	void  Save ( const std::string& path );
+	void  Load ( const std::string& path );
+
+	ArchiveBench  Benchmark () const;
+
+}; // class BME280Archive
+
+} // namespace bosch_bme280
+
+#endif /* BME280_ARCHIVE_HPP_ */
@@ -1,4 +1,3 @@
-```
 /*
  * bme280_comp.cpp
  *
@@ -19,20 +18,52 @@
  *      b. Pressure - output is in pascals (Pa).
  *      c. Humidity - divide the output by 1024 to get percent
  *         relative humidity.
- *    2. Floating-point compensation
+ *    2. 64-bit fixed-point compensation (pressure only)
+ *      a. Pressure - divide the output by 100 to get pascals (Pa).
+ *    3. Floating-point compensation
  *      a. Temperature - output is in degrees centigrade.
  *      b. Pressure - output is in pascals (Pa).
  *      c. Humidity - output is in percent relative humidity.
  */
 
 
+#include <stddef.h>          // size_t
+#include <stdint.h>          // int32_t, uint32_t, int64_t
+#include <vector>            // vector
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>        // float32x4_t, int32x4_t
+#endif
+
+// x86-64 replay hosts: build SSE4.1 and AVX2 batch kernels and pick
+// one at run time.
+#if defined(__GNUC__) && defined(__x86_64__)
+#define BME280_BATCH_X86
+#include <immintrin.h>       // __m128i, __m256i
+#endif
+
 #include "bme280.hpp"
+#include "bme280_comp.hpp"
+#include "bme280_time.hpp"
+
+
+// Samples per batch block. Sized so that the raw and tfine scratch
+// buffers stay well inside L1 cache.
+#define BME280_BATCH_BLOCK  256
+
 
 namespace bosch_bme280
 {
 
+// Stateless Compensation
+// -----------------------------------------------------------------
+// These functions read calibration parameters and raw values only
+// from their arguments and write nothing else, so any number of
+// threads may call them concurrently with a shared, unchanging
+// CalParams.
+
 /*
- * int32_t BME280::Comp32FixedTemp(uint32_t unctemp)
+ * int32_t Comp32FixedTemp(const CalParams& cp, uint32_t unctemp, int32_t& tfine)
  *
  * Description:
  *   Applies 32-bit fixed-point compensation to a temperature reading.
@@ -40,32 +71,29 @@ namespace bosch_bme280
  *   compensate associated pressure and humidity readings.
  *
  * Parameters:
+ *   cp      - calibration parameters
  *   unctemp - an uncompensated temperature value
+ *   tfine   - receives a value that can be used to compensate
+ *             associated pressure and humidity readings
  *
  * Returns:
  *   Returns a 32-bit integer that has units of 1/100 degrees centigrade.
  *
- *   cparams.tfine - When this function exits, tfine will contain a value
- *   that can be used to compensate associated pressure and humidity
- *   readings.
- *
  * Namespace:
  *   bosch_bme280
  *
  * Header File(s);
- *   bme280.hpp
+ *   bme280_comp.hpp
  */
-int32_t BME280::Comp32FixedTemp(uint32_t unctemp)
+int32_t Comp32FixedTemp(const CalParams& cp, uint32_t unctemp, int32_t& tfine)
 {
-    if (!cparams.loaded) this->LoadCalParams();
-
     int32_t temperature;
     int32_t temp_min = -4000;
     int32_t temp_max =  8500;
 
-    int32_t t1 = (int32_t)cparams.t1;
-    int32_t t2 = (int32_t)cparams.t2;
-    int32_t t3 = (int32_t)cparams.t3;
+    int32_t t1 = (int32_t)cp.t1;
+    int32_t t2 = (int32_t)cp.t2;
+    int32_t t3 = (int32_t)cp.t3;
 
     int32_t v1;
     int32_t v2;
@@ -75,9 +103,9 @@ int32_t BME280::Comp32FixedTemp(uint32_t unctemp)
 
     v2 = (int32_t)((unctemp/16)-t1);
     v2 = (((v2*v2)/4096)*t3)/16384;
-    cparams.tfine = v1 + v2;
+    tfine = v1 + v2;
 
-    temperature = (cparams.tfine * 5 + 128) / 256;
+    temperature = (tfine * 5 + 128) / 256;
 
     if (temperature < temp_min)
         temperature = temp_min;
@@ -88,13 +116,15 @@ int32_t BME280::Comp32FixedTemp(uint32_t unctemp)
 }
 
 /*
- * uint32_t BME280::Comp32FixedPress(uint32_t uncpress)
+ * uint32_t Comp32FixedPress(const CalParams& cp, uint32_t uncpress, int32_t tfine)
  *
  * Description:
  *   Applies 32-bit fixed-point compensation to a pressure reading.
  *
  * Parameters:
+ *   cp       - calibration parameters
  *   uncpress - an uncompensated pressure value
+ *   tfine    - generated by Comp32FixedTemp() for the same sample
  *
  * Returns:
  *   Returns barometric pressure, in pascals (Pa).
@@ -103,9 +133,9 @@ int32_t BME280::Comp32FixedTemp(uint32_t unctemp)
  *   bosch_bme280
  *
  * Header File(s);
- *   bme280.hpp
+ *   bme280_comp.hpp
  */
-uint32_t BME280::Comp32FixedPress(uint32_t uncpress)
+uint32_t Comp32FixedPress(const CalParams& cp, uint32_t uncpress, int32_t tfine)
 {
      int32_t v1, v2, v3, v4;
     uint32_t v5;
@@ -113,14 +143,14 @@ uint32_t BME280::Comp32FixedPress(uint32_t uncpress)
     uint32_t p_min = 30000;
     uint32_t p_max = 110000;
 
-    v1 = (cparams.tfine / 2) - 64000;
-    v2 = (((v1/4) * (v1/4)) / 2048) * ((int32_t)cparams.p6);
-    v2 = v2 + ((v1 * ((int32_t)cparams.p5)) * 2);
-    v2 = (v2 / 4) + (((int32_t)cparams.p4) * 65536);
-    v3 = (cparams.p3 * (((v1 / 4) * (v1 / 4)) / 8192)) / 8;
-    v4 = (((int32_t)cparams.p2) * v1) / 2;
+    v1 = (tfine / 2) - 64000;
+    v2 = (((v1/4) * (v1/4)) / 2048) * ((int32_t)cp.p6);
+    v2 = v2 + ((v1 * ((int32_t)cp.p5)) * 2);
+    v2 = (v2 / 4) + (((int32_t)cp.p4) * 65536);
+    v3 = (cp.p3 * (((v1 / 4) * (v1 / 4)) / 8192)) / 8;
+    v4 = (((int32_t)cp.p2) * v1) / 2;
     v1 = (v3 + v4) / 262144;
-    v1 = (((32768 + v1)) * ((int32_t)cparams.p1)) / 32768;
+    v1 = (((32768 + v1)) * ((int32_t)cp.p1)) / 32768;
 
     if (v1)
     {
@@ -131,9 +161,9 @@ uint32_t BME280::Comp32FixedPress(uint32_t uncpress)
         else
             pressure = (pressure / (uint32_t)v1) * 2;
 
-        v1 = (((int32_t)cparams.p9) * ((int32_t)(((pressure / 8) * (pressure / 8)) / 8192))) / 4096;
-        v2 = (((int32_t)(pressure / 4)) * ((int32_t)cparams.p8)) / 8192;
-        pressure = (uint32_t)((int32_t)pressure + ((v1 + v2 + cparams.p7) / 16));
+        v1 = (((int32_t)cp.p9) * ((int32_t)(((pressure / 8) * (pressure / 8)) / 8192))) / 4096;
+        v2 = (((int32_t)(pressure / 4)) * ((int32_t)cp.p8)) / 8192;
+        pressure = (uint32_t)((int32_t)pressure + ((v1 + v2 + cp.p7) / 16));
 
         if (pressure < p_min)
             pressure = p_min;
@@ -149,15 +179,76 @@ uint32_t BME280::Comp32FixedPress(uint32_t uncpress)
 }
 
 /*
- * uint32_t BME280::Comp32FixedHumid(uint32_t unchum)
+ * uint32_t Comp64FixedPress(const CalParams& cp, uint32_t uncpress, int32_t tfine)
+ *
+ * Description:
+ *   Applies 64-bit fixed-point compensation to a pressure reading.
+ *   This is the high-precision pressure variant of the Bosch driver;
+ *   temperature and humidity have no 64-bit counterpart.
+ *
+ * Parameters:
+ *   cp       - calibration parameters
+ *   uncpress - an uncompensated pressure value
+ *   tfine    - generated by Comp32FixedTemp() for the same sample
+ *
+ * Returns:
+ *   Returns barometric pressure, in 1/100 pascals.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_comp.hpp
+ */
+uint32_t Comp64FixedPress(const CalParams& cp, uint32_t uncpress, int32_t tfine)
+{
+    int64_t v1, v2, v3, v4;
+    uint32_t pressure;
+    uint32_t p_min = 3000000;
+    uint32_t p_max = 11000000;
+
+    v1 = ((int64_t)tfine) - 128000;
+    v2 = v1 * v1 * (int64_t)cp.p6;
+    v2 = v2 + ((v1 * (int64_t)cp.p5) * 131072);
+    v2 = v2 + (((int64_t)cp.p4) * 34359738368LL);
+    v1 = ((v1 * v1 * (int64_t)cp.p3) / 256) + ((v1 * ((int64_t)cp.p2) * 4096));
+    v3 = ((int64_t)1) * 140737488355328LL;
+    v1 = (v3 + v1) * ((int64_t)cp.p1) / 8589934592LL;
+
+    if (v1 != 0)
+    {
+        v4 = 1048576 - (int64_t)uncpress;
+        v4 = (((v4 * 2147483648LL) - v2) * 3125) / v1;
+        v1 = (((int64_t)cp.p9) * (v4 / 8192) * (v4 / 8192)) / 33554432;
+        v2 = (((int64_t)cp.p8) * v4) / 524288;
+        v4 = ((v4 + v1 + v2) / 256) + (((int64_t)cp.p7) * 16);
+        pressure = (uint32_t)(((v4 / 2) * 100) / 128);
+
+        if (pressure < p_min)
+            pressure = p_min;
+        else if (pressure > p_max)
+            pressure = p_max;
+    }
+    else
+    {
+        pressure = p_min;
+    }
+
+    return pressure;
+}
+
+/*
+ * uint32_t Comp32FixedHumid(const CalParams& cp, uint32_t unchum, int32_t tfine)
  *
  * Description:
  *   Applies 32-bit fixed-point compensation to a humidity reading.
  *
  * Parameters:
+ *   cp     - calibration parameters
  *   unchum - an uncompensated humidity value
+ *   tfine  - generated by Comp32FixedTemp() for the same sample
  *
- * Returns
+ * Returns:
  *   Returns a 32-bit integer which, when divided by 1024, yields
  *   percent relative humidity.
  *
@@ -165,28 +256,26 @@ uint32_t BME280::Comp32FixedPress(uint32_t uncpress)
  *   bosch_bme280
  *
  * Header File(s);
- *   bme280.hpp
+ *   bme280_comp.hpp
  */
-uint32_t BME280::Comp32FixedHumid(uint32_t unchum)
+uint32_t Comp32FixedHumid(const CalParams& cp, uint32_t unchum, int32_t tfine)
 {
-    if (!cparams.loaded) this->LoadCalParams();
-
     int32_t v1, v2, v3, v4, v5;
     uint32_t humidity;
     uint32_t hu_max = 102400;
 
-    v1 = cparams.tfine - ((int32_t)76800);
+    v1 = tfine - ((int32_t)76800);
     v2 = (int32_t)(unchum * 16384);
-    v3 = (int32_t)(((int32_t)cparams.h4) * 1048576);
-    v4 = ((int32_t)cparams.h5) * v1;
+    v3 = (int32_t)(((int32_t)cp.h4) * 1048576);
+    v4 = ((int32_t)cp.h5) * v1;
     v5 = (((v2 - v3) - v4) + (int32_t)16384) / 32768;
-    v2 = (v1 * ((int32_t)cparams.h6)) / 1024;
-    v3 = (v1 * ((int32_t)cparams.h3)) / 2048;
+    v2 = (v1 * ((int32_t)cp.h6)) / 1024;
+    v3 = (v1 * ((int32_t)cp.h3)) / 2048;
     v4 = ((v2 * (v3 + (int32_t)32768)) / 1024) + (int32_t)2097152;
-    v2 = ((v4 * ((int32_t)cparams.h2)) + 8192) / 16384;
+    v2 = ((v4 * ((int32_t)cp.h2)) + 8192) / 16384;
     v3 = v5 * v2;
     v4 = ((v3 / 32768) * (v3 / 32768)) / 128;
-    v5 = v3 - ((v4 * ((int32_t)cparams.h1)) / 16);
+    v5 = v3 - ((v4 * ((int32_t)cp.h1)) / 16);
     v5 = (v5 < 0 ? 0 : v5);
     v5 = (v5 > 419430400 ? 419430400 : v5);
     humidity = (uint32_t)(v5 / 4096);
@@ -198,14 +287,17 @@ uint32_t BME280::Comp32FixedHumid(uint32_t unchum)
 }
 
 /*
- * double BME280::CompDoubleTemp(uint32_t unctemp)
+ * double CompDoubleTemp(const CalParams& cp, uint32_t unctemp, int32_t& tfine)
  *
  * Description:
  *   Applies double floating-point compensation to a temperature
- *   reading.
+ *   reading. Also generates tfine.
  *
  * Parameters:
+ *   cp      - calibration parameters
  *   unctemp - an uncompensated temperature value
+ *   tfine   - receives a value that can be used to compensate
+ *             associated pressure and humidity readings
  *
  * Returns:
  *   Returns temperature, in degrees centigrade.
@@ -214,12 +306,10 @@ uint32_t BME280::Comp32FixedHumid(uint32_t unchum)
  *   bosch_bme280
  *
  * Header File(s);
- *   bme280.hpp
+ *   bme280_comp.hpp
  */
-double BME280::CompDoubleTemp(uint32_t unctemp)
+double CompDoubleTemp(const CalParams& cp, uint32_t unctemp, int32_t& tfine)
 {
-    if (!cparams.loaded) this->LoadCalParams();
-
     double v1;
     double v2;
     double temperature;
@@ -227,15 +317,15 @@ double BME280::CompDoubleTemp(uint32_t unctemp)
     double t_min = -40;
     double t_max =  85;
 
-    double t1 = (double)cparams.t1;
-    double t2 = (double)cparams.t2;
-    double t3 = (double)cparams.t3;
+    double t1 = (double)cp.t1;
+    double t2 = (double)cp.t2;
+    double t3 = (double)cp.t3;
 
     v1 = (utemp/16384.0  - t1/1024.0) * t2;
     v2 = (utemp/131072.0 - t1/8192.0);
     v2 = (v2*v2) * t3;
 
-    cparams.tfine = (int32_t)(v1 + v2);
+    tfine = (int32_t)(v1 + v2);
     temperature = (v1+v2)/5120.0;
 
     if (temperature < t_min)
@@ -247,14 +337,16 @@ double BME280::CompDoubleTemp(uint32_t unctemp)
 }
 
 /*
- * double BME280::CompDoublePress(uint32_t uncpress)
+ * double CompDoublePress(const CalParams& cp, uint32_t uncpress, int32_t tfine)
  *
  * Description:
  *   Applies double floating-point compensation to a pressure
  *   reading.
  *
  * Parameters:
+ *   cp       - calibration parameters
  *   uncpress - an uncompensated pressure value
+ *   tfine    - generated by CompDoubleTemp() for the same sample
  *
  * Returns:
  *   Returns barometric pressure, in pascals (Pa).
@@ -263,9 +355,9 @@ double BME280::CompDoubleTemp(uint32_t unctemp)
  *   bosch_bme280
  *
  * Header File(s);
- *   bme280.hpp
+ *   bme280_comp.hpp
  */
-double BME280::CompDoublePress(uint32_t uncpress)
+double CompDoublePress(const CalParams& cp, uint32_t uncpress, int32_t tfine)
 {
     double v1;
     double v2;
@@ -274,21 +366,21 @@ double BME280::CompDoublePress(uint32_t uncpress)
     double p_min =  30000.0;
     double p_max = 110000.0;
 
-    v1 = ((double)cparams.tfine/2.0) - 64000.0;
-    v2 = v1*v1 * ((double)cparams.p6)/32768.0;
-    v2 = v2+v1 * ((double)cparams.p5) * 2.0;
-    v2 = (v2/4.0) + (((double)cparams.p4) * 65536.0);
-    v3 = ((double)cparams.p3)*v1*v1/524288.0;
-    v1 = (v3 + ((double)cparams.p2) * v1) / 524288.0;
-    v1 = (1.0 + v1 / 32768.0) * ((double)cparams.p1);
+    v1 = ((double)tfine/2.0) - 64000.0;
+    v2 = v1*v1 * ((double)cp.p6)/32768.0;
+    v2 = v2+v1 * ((double)cp.p5) * 2.0;
+    v2 = (v2/4.0) + (((double)cp.p4) * 65536.0);
+    v3 = ((double)cp.p3)*v1*v1/524288.0;
+    v1 = (v3 + ((double)cp.p2) * v1) / 524288.0;
+    v1 = (1.0 + v1 / 32768.0) * ((double)cp.p1);
 
     if (v1)
     {
         pressure = 1048576.0 - (double)uncpress;
         pressure = (pressure - (v2/4096.0)) * 6250.0 / v1;
-        v1 = ((double)cparams.p9) * pressure * pressure / 2147483648.0;
-        v2 = pressure * ((double)cparams.p8) / 32768.0;
-        pressure = pressure + (v1 + v2 + ((double)cparams.p7)) / 16.0;
+        v1 = ((double)cp.p9) * pressure * pressure / 2147483648.0;
+        v2 = pressure * ((double)cp.p8) / 32768.0;
+        pressure = pressure + (v1 + v2 + ((double)cp.p7)) / 16.0;
 
         if (pressure < p_min)
             pressure = p_min;
@@ -304,14 +396,16 @@ double BME280::CompDoublePress(uint32_t uncpress)
 }
 
 /*
- * double BME280::CompDoubleHumid(uint32_t unchum)
+ * double CompDoubleHumid(const CalParams& cp, uint32_t unchum, int32_t tfine)
  *
  * Description:
  *   Applies double floating-point compensation to a humidity
  *   reading.
  *
  * Parameters:
+ *   cp     - calibration parameters
  *   unchum - an uncompensated humidity value
+ *   tfine  - generated by CompDoubleTemp() for the same sample
  *
  * Returns:
  *   Returns percent relative humidity.
@@ -320,23 +414,23 @@ double BME280::CompDoublePress(uint32_t uncpress)
  *   bosch_bme280
  *
  * Header File(s);
- *   bme280.hpp
+ *   bme280_comp.hpp
  */
-double BME280::CompDoubleHumid(uint32_t unchum)
+double CompDoubleHumid(const CalParams& cp, uint32_t unchum, int32_t tfine)
 {
     double humidity;
     double hu_min = 0.0;
     double hu_max = 100.0;
     double v1, v2, v3, v4, v5, v6;
 
-    v1 = ((double)cparams.tfine) - 76800.0;
-    v2 = (((double)cparams.h4) * 64.0 + (((double)cparams.h5) / 16384.0) * v1);
+    v1 = ((double)tfine) - 76800.0;
+    v2 = (((double)cp.h4) * 64.0 + (((double)cp.h5) / 16384.0) * v1);
     v3 = unchum - v2;
-    v4 = ((double)cparams.h2) / 65536.0;
-    v5 = (1.0 + (((double)cparams.h3) / 67108864.0) * v1);
-    v6 = 1.0 + (((double)cparams.h6) / 67108864.0) * v1 * v5;
+    v4 = ((double)cp.h2) / 65536.0;
+    v5 = (1.0 + (((double)cp.h3) / 67108864.0) * v1);
+    v6 = 1.0 + (((double)cp.h6) / 67108864.0) * v1 * v5;
     v6 = v3*v4*v5*v6;
-    humidity = v6 * (1.0 - ((double)cparams.h1) * v6 / 524288.0);
+    humidity = v6 * (1.0 - ((double)cp.h1) * v6 / 524288.0);
 
     if (humidity > hu_max)
         humidity = hu_max;
@@ -346,5 +440,1199 @@ double BME280::CompDoubleHumid(uint32_t unchum)
     return humidity;
 }
 
+/*
+ * TPH32CompData Comp32FixedData(const CalParams& cp, const TPH32SensorData& sensdat)
+ *
+ * Description:
+ *   Applies 32-bit fixed-point compensation to a complete
+ *   temperature, pressure, and humidity sample.
+ *
+ * Parameters:
+ *   cp      - calibration parameters
+ *   sensdat - uncompensated sample
+ *
+ * Returns:
+ *   Returns a TPH32CompData structure containing the sample time
+ *   stamp, the compensated values, and the tfine value that was used
+ *   for pressure and humidity.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_comp.hpp
+ */
+TPH32CompData Comp32FixedData(const CalParams& cp, const TPH32SensorData& sensdat)
+{
+    TPH32CompData compdat;
+
+    compdat.timestamp   = sensdat.timestamp;
+    compdat.sampled     = sensdat.sampled;
+    compdat.temperature = Comp32FixedTemp  (cp, sensdat.temperature, compdat.tfine);
+    compdat.pressure    = Comp32FixedPress (cp, sensdat.pressure,    compdat.tfine);
+    compdat.humidity    = Comp32FixedHumid (cp, sensdat.humidity,    compdat.tfine);
+
+    return compdat;
+}
+
+/*
+ * TPHDoubleCompData CompDoubleData(const CalParams& cp, const TPH32SensorData& sensdat)
+ *
+ * Description:
+ *   Applies double floating-point compensation to a complete
+ *   temperature, pressure, and humidity sample.
+ *
+ * Parameters:
+ *   cp      - calibration parameters
+ *   sensdat - uncompensated sample
+ *
+ * Returns:
+ *   Returns a TPHDoubleCompData structure containing the sample time
+ *   stamp, the compensated values, and the tfine value that was used
+ *   for pressure and humidity.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_comp.hpp
+ */
+TPHDoubleCompData CompDoubleData(const CalParams& cp, const TPH32SensorData& sensdat)
+{
+    TPHDoubleCompData compdat;
+
+    compdat.timestamp   = sensdat.timestamp;
+    compdat.sampled     = sensdat.sampled;
+    compdat.temperature = CompDoubleTemp  (cp, sensdat.temperature, compdat.tfine);
+    compdat.pressure    = CompDoublePress (cp, sensdat.pressure,    compdat.tfine);
+    compdat.humidity    = CompDoubleHumid (cp, sensdat.humidity,    compdat.tfine);
+
+    return compdat;
+}
+
+/*
+ * TPHDoubleCompData CompDoubleData(const PreparedCalibration& pc, const TPH32SensorData& sensdat)
+ *
+ * Description:
+ *   Applies double floating-point compensation to a complete
+ *   temperature, pressure, and humidity sample, using prepared
+ *   calibration coefficients.
+ *
+ * Parameters:
+ *   pc      - prepared calibration coefficients
+ *   sensdat - uncompensated sample
+ *
+ * Returns:
+ *   Returns a TPHDoubleCompData structure containing the sample time
+ *   stamp, the compensated values, and the tfine value that was used
+ *   for pressure and humidity.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_comp.hpp
+ */
+TPHDoubleCompData CompDoubleData(const PreparedCalibration& pc, const TPH32SensorData& sensdat)
+{
+    TPHDoubleCompData compdat;
+
+    compdat.timestamp   = sensdat.timestamp;
+    compdat.sampled     = sensdat.sampled;
+    compdat.temperature = CompDoubleTemp  (pc, sensdat.temperature, compdat.tfine);
+    compdat.pressure    = CompDoublePress (pc, sensdat.pressure,    compdat.tfine);
+    compdat.humidity    = CompDoubleHumid (pc, sensdat.humidity,    compdat.tfine);
+
+    return compdat;
+}
+
+/*
+ * CompBench BenchCompensation(const CalParams& cp, const TPH32SensorData* sensdat,
+ *                             size_t count, unsigned rounds)
+ *
+ * Description:
+ *   Times double floating-point compensation from CalParams against
+ *   the same from a PreparedCalibration built from it, over the same
+ *   samples, rounds times each.
+ *
+ *   Also counts the samples where the two differ in pressure or
+ *   humidity, which should be none. Temperature may differ by one
+ *   unit in the last place and is not compared.
+ *
+ * Parameters:
+ *   cp      - calibration parameters
+ *   sensdat - pointer to an array of uncompensated samples
+ *   count   - the number of samples
+ *   rounds  - number of timed passes over the samples
+ *
+ * Returns:
+ *   Per-sample times of each path, and the mismatch count.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_comp.hpp
+ */
+CompBench BenchCompensation(const CalParams& cp, const TPH32SensorData* sensdat,
+                            size_t count, unsigned rounds)
+{
+    CompBench cb;
+    cb.samples = count;
+
+    if (count == 0 || rounds == 0)
+        return cb;
+
+    PreparedCalibration             pc(cp);
+    std::vector<TPHDoubleCompData>  plain(count);
+    std::vector<TPHDoubleCompData>  prepared(count);
+    int64_t                         start;
+
+    start = SteadyNanos();
+    for (unsigned r = 0; r < rounds; r++)
+        for (size_t i = 0; i < count; i++)
+            plain[i] = CompDoubleData(cp, sensdat[i]);
+    cb.plain_ns = (double)(SteadyNanos() - start) / ((double)count * rounds);
+
+    start = SteadyNanos();
+    for (unsigned r = 0; r < rounds; r++)
+        for (size_t i = 0; i < count; i++)
+            prepared[i] = CompDoubleData(pc, sensdat[i]);
+    cb.prepared_ns = (double)(SteadyNanos() - start) / ((double)count * rounds);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (plain[i].pressure != prepared[i].pressure ||
+            plain[i].humidity != prepared[i].humidity)
+            cb.mismatches++;
+    }
+
+    return cb;
+}
+
+// Batch Kernels
+// -----------------------------------------------------------------
+// Temperature and humidity compensation are straight-line 32-bit
+// integer code: multiplies, adds, shifts, and clamps. Each has vector
+// kernels written with intrinsics, four lanes for SSE4.1 and NEON
+// and eight for AVX2. A signed division by a power of two is done as
+// an arithmetic shift, with a bias of (divisor - 1) added to negative
+// values first, so that it truncates toward zero as C division does.
+// The vector kernels therefore match Comp32FixedTemp() and
+// Comp32FixedHumid() bit for bit. (Only calibration values far
+// outside what a device stores can make a product overflow int32.
+// The scalar result is then undefined; the vector kernels wrap, as
+// the scalar code does when built with -fwrapv.)
+//
+// Pressure has a per-sample unsigned division and stays scalar.
+//
+// Each kernel compensates as many whole vectors as fit in count and
+// returns the number of samples done; the caller finishes the rest
+// with the scalar functions.
+
+typedef size_t (*Comp32TempKernel)  ( const CalParams& cp, const uint32_t* unctemp, size_t count,
+                                      int32_t* temp, int32_t* tfine );
+typedef size_t (*Comp32HumidKernel) ( const CalParams& cp, const uint32_t* unchum, const int32_t* tfine,
+                                      size_t count, uint32_t* humid );
+
+#if defined(BME280_BATCH_X86)
+
+/*
+ * static __m128i sse_div2n(__m128i x, int n)
+ *
+ * Description:
+ *   Four-lane signed division by 2^n, truncating toward zero.
+ */
+static inline __m128i sse_div2n(__m128i x, int n)
+{
+    __m128i bias = _mm_srli_epi32(_mm_srai_epi32(x, 31), 32 - n);
+    return _mm_srai_epi32(_mm_add_epi32(x, bias), n);
+}
+
+/*
+ * static size_t temp_sse41(const CalParams& cp, const uint32_t* unctemp, size_t count,
+ *                          int32_t* temp, int32_t* tfine)
+ *
+ * Description:
+ *   Comp32FixedTemp(), four samples at a time.
+ */
+__attribute__((target("sse4.1")))
+static size_t temp_sse41(const CalParams& cp, const uint32_t* unctemp, size_t count,
+                         int32_t* temp, int32_t* tfine)
+{
+    const __m128i t1   = _mm_set1_epi32((int32_t)cp.t1);
+    const __m128i t1x2 = _mm_set1_epi32((int32_t)cp.t1 * 2);
+    const __m128i t2   = _mm_set1_epi32((int32_t)cp.t2);
+    const __m128i t3   = _mm_set1_epi32((int32_t)cp.t3);
+    const __m128i tmin = _mm_set1_epi32(-4000);
+    const __m128i tmax = _mm_set1_epi32( 8500);
+
+    __m128i ut, v1, v2, tf, t;
+    size_t  i = 0;
+
+    for ( ; i + 4 <= count; i += 4)
+    {
+        ut = _mm_loadu_si128((const __m128i*)(unctemp + i));
+
+        v1 = _mm_sub_epi32(_mm_srli_epi32(ut, 3), t1x2);
+        v1 = sse_div2n(_mm_mullo_epi32(v1, t2), 11);
+
+        v2 = _mm_sub_epi32(_mm_srli_epi32(ut, 4), t1);
+        v2 = sse_div2n(_mm_mullo_epi32(v2, v2), 12);
+        v2 = sse_div2n(_mm_mullo_epi32(v2, t3), 14);
+        tf = _mm_add_epi32(v1, v2);
+
+        t  = _mm_add_epi32(_mm_mullo_epi32(tf, _mm_set1_epi32(5)), _mm_set1_epi32(128));
+        t  = sse_div2n(t, 8);
+        t  = _mm_min_epi32(_mm_max_epi32(t, tmin), tmax);
+
+        _mm_storeu_si128((__m128i*)(temp  + i), t);
+        _mm_storeu_si128((__m128i*)(tfine + i), tf);
+    }
+
+    return i;
+}
+
+/*
+ * static size_t humid_sse41(const CalParams& cp, const uint32_t* unchum, const int32_t* tfine,
+ *                           size_t count, uint32_t* humid)
+ *
+ * Description:
+ *   Comp32FixedHumid(), four samples at a time.
+ */
+__attribute__((target("sse4.1")))
+static size_t humid_sse41(const CalParams& cp, const uint32_t* unchum, const int32_t* tfine,
+                          size_t count, uint32_t* humid)
+{
+    const __m128i h1   = _mm_set1_epi32((int32_t)cp.h1);
+    const __m128i h2   = _mm_set1_epi32((int32_t)cp.h2);
+    const __m128i h3   = _mm_set1_epi32((int32_t)cp.h3);
+    const __m128i h4   = _mm_set1_epi32((int32_t)cp.h4 * 1048576);
+    const __m128i h5   = _mm_set1_epi32((int32_t)cp.h5);
+    const __m128i h6   = _mm_set1_epi32((int32_t)cp.h6);
+    const __m128i vmax = _mm_set1_epi32(419430400);
+
+    __m128i v1, v2, v3, v4, v5;
+    size_t  i = 0;
+
+    for ( ; i + 4 <= count; i += 4)
+    {
+        v1 = _mm_sub_epi32(_mm_loadu_si128((const __m128i*)(tfine + i)), _mm_set1_epi32(76800));
+        v2 = _mm_slli_epi32(_mm_loadu_si128((const __m128i*)(unchum + i)), 14);
+        v4 = _mm_mullo_epi32(v1, h5);
+        v5 = _mm_add_epi32(_mm_sub_epi32(_mm_sub_epi32(v2, h4), v4), _mm_set1_epi32(16384));
+        v5 = sse_div2n(v5, 15);
+        v2 = sse_div2n(_mm_mullo_epi32(v1, h6), 10);
+        v3 = sse_div2n(_mm_mullo_epi32(v1, h3), 11);
+        v4 = sse_div2n(_mm_mullo_epi32(v2, _mm_add_epi32(v3, _mm_set1_epi32(32768))), 10);
+        v4 = _mm_add_epi32(v4, _mm_set1_epi32(2097152));
+        v2 = sse_div2n(_mm_add_epi32(_mm_mullo_epi32(v4, h2), _mm_set1_epi32(8192)), 14);
+        v3 = _mm_mullo_epi32(v5, v2);
+        v4 = sse_div2n(v3, 15);
+        v4 = sse_div2n(_mm_mullo_epi32(v4, v4), 7);
+        v5 = _mm_sub_epi32(v3, sse_div2n(_mm_mullo_epi32(v4, h1), 4));
+        v5 = _mm_min_epi32(_mm_max_epi32(v5, _mm_setzero_si128()), vmax);
+
+        _mm_storeu_si128((__m128i*)(humid + i), _mm_srli_epi32(v5, 12));
+    }
+
+    return i;
+}
+
+/*
+ * static __m256i avx2_div2n(__m256i x, int n)
+ *
+ * Description:
+ *   Eight-lane signed division by 2^n, truncating toward zero.
+ */
+__attribute__((target("avx2")))
+static inline __m256i avx2_div2n(__m256i x, int n)
+{
+    __m256i bias = _mm256_srli_epi32(_mm256_srai_epi32(x, 31), 32 - n);
+    return _mm256_srai_epi32(_mm256_add_epi32(x, bias), n);
+}
+
+/*
+ * static size_t temp_avx2(const CalParams& cp, const uint32_t* unctemp, size_t count,
+ *                         int32_t* temp, int32_t* tfine)
+ *
+ * Description:
+ *   Comp32FixedTemp(), eight samples at a time.
+ */
+__attribute__((target("avx2")))
+static size_t temp_avx2(const CalParams& cp, const uint32_t* unctemp, size_t count,
+                        int32_t* temp, int32_t* tfine)
+{
+    const __m256i t1   = _mm256_set1_epi32((int32_t)cp.t1);
+    const __m256i t1x2 = _mm256_set1_epi32((int32_t)cp.t1 * 2);
+    const __m256i t2   = _mm256_set1_epi32((int32_t)cp.t2);
+    const __m256i t3   = _mm256_set1_epi32((int32_t)cp.t3);
+    const __m256i tmin = _mm256_set1_epi32(-4000);
+    const __m256i tmax = _mm256_set1_epi32( 8500);
+
+    __m256i ut, v1, v2, tf, t;
+    size_t  i = 0;
+
+    for ( ; i + 8 <= count; i += 8)
+    {
+        ut = _mm256_loadu_si256((const __m256i*)(unctemp + i));
+
+        v1 = _mm256_sub_epi32(_mm256_srli_epi32(ut, 3), t1x2);
+        v1 = avx2_div2n(_mm256_mullo_epi32(v1, t2), 11);
+
+        v2 = _mm256_sub_epi32(_mm256_srli_epi32(ut, 4), t1);
+        v2 = avx2_div2n(_mm256_mullo_epi32(v2, v2), 12);
+        v2 = avx2_div2n(_mm256_mullo_epi32(v2, t3), 14);
+        tf = _mm256_add_epi32(v1, v2);
+
+        t  = _mm256_add_epi32(_mm256_mullo_epi32(tf, _mm256_set1_epi32(5)), _mm256_set1_epi32(128));
+        t  = avx2_div2n(t, 8);
+        t  = _mm256_min_epi32(_mm256_max_epi32(t, tmin), tmax);
+
+        _mm256_storeu_si256((__m256i*)(temp  + i), t);
+        _mm256_storeu_si256((__m256i*)(tfine + i), tf);
+    }
+
+    return i;
+}
+
+/*
+ * static size_t humid_avx2(const CalParams& cp, const uint32_t* unchum, const int32_t* tfine,
+ *                          size_t count, uint32_t* humid)
+ *
+ * Description:
+ *   Comp32FixedHumid(), eight samples at a time.
+ */
+__attribute__((target("avx2")))
+static size_t humid_avx2(const CalParams& cp, const uint32_t* unchum, const int32_t* tfine,
+                         size_t count, uint32_t* humid)
+{
+    const __m256i h1   = _mm256_set1_epi32((int32_t)cp.h1);
+    const __m256i h2   = _mm256_set1_epi32((int32_t)cp.h2);
+    const __m256i h3   = _mm256_set1_epi32((int32_t)cp.h3);
+    const __m256i h4   = _mm256_set1_epi32((int32_t)cp.h4 * 1048576);
+    const __m256i h5   = _mm256_set1_epi32((int32_t)cp.h5);
+    const __m256i h6   = _mm256_set1_epi32((int32_t)cp.h6);
+    const __m256i vmax = _mm256_set1_epi32(419430400);
+
+    __m256i v1, v2, v3, v4, v5;
+    size_t  i = 0;
+
+    for ( ; i + 8 <= count; i += 8)
+    {
+        v1 = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i*)(tfine + i)), _mm256_set1_epi32(76800));
+        v2 = _mm256_slli_epi32(_mm256_loadu_si256((const __m256i*)(unchum + i)), 14);
+        v4 = _mm256_mullo_epi32(v1, h5);
+        v5 = _mm256_add_epi32(_mm256_sub_epi32(_mm256_sub_epi32(v2, h4), v4), _mm256_set1_epi32(16384));
+        v5 = avx2_div2n(v5, 15);
+        v2 = avx2_div2n(_mm256_mullo_epi32(v1, h6), 10);
+        v3 = avx2_div2n(_mm256_mullo_epi32(v1, h3), 11);
+        v4 = avx2_div2n(_mm256_mullo_epi32(v2, _mm256_add_epi32(v3, _mm256_set1_epi32(32768))), 10);
+        v4 = _mm256_add_epi32(v4, _mm256_set1_epi32(2097152));
+        v2 = avx2_div2n(_mm256_add_epi32(_mm256_mullo_epi32(v4, h2), _mm256_set1_epi32(8192)), 14);
+        v3 = _mm256_mullo_epi32(v5, v2);
+        v4 = avx2_div2n(v3, 15);
+        v4 = avx2_div2n(_mm256_mullo_epi32(v4, v4), 7);
+        v5 = _mm256_sub_epi32(v3, avx2_div2n(_mm256_mullo_epi32(v4, h1), 4));
+        v5 = _mm256_min_epi32(_mm256_max_epi32(v5, _mm256_setzero_si256()), vmax);
+
+        _mm256_storeu_si256((__m256i*)(humid + i), _mm256_srli_epi32(v5, 12));
+    }
+
+    return i;
+}
+
+static bool sse41_usable () { return __builtin_cpu_supports("sse4.1"); }
+static bool avx2_usable  () { return __builtin_cpu_supports("avx2"); }
+
+#endif // BME280_BATCH_X86
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+/*
+ * static int32x4_t neon_div2n(int32x4_t x, int n)
+ *
+ * Description:
+ *   Four-lane signed division by 2^n, truncating toward zero. NEON
+ *   shifts by a vector count, negative for a right shift.
+ */
+static inline int32x4_t neon_div2n(int32x4_t x, int n)
+{
+    uint32x4_t sign = vreinterpretq_u32_s32(vshrq_n_s32(x, 31));
+    int32x4_t  bias = vreinterpretq_s32_u32(vshlq_u32(sign, vdupq_n_s32(n - 32)));
+    return vshlq_s32(vaddq_s32(x, bias), vdupq_n_s32(-n));
+}
+
+/*
+ * static size_t temp_neon(const CalParams& cp, const uint32_t* unctemp, size_t count,
+ *                         int32_t* temp, int32_t* tfine)
+ *
+ * Description:
+ *   Comp32FixedTemp(), four samples at a time.
+ */
+static size_t temp_neon(const CalParams& cp, const uint32_t* unctemp, size_t count,
+                        int32_t* temp, int32_t* tfine)
+{
+    const int32x4_t t1   = vdupq_n_s32((int32_t)cp.t1);
+    const int32x4_t t1x2 = vdupq_n_s32((int32_t)cp.t1 * 2);
+    const int32x4_t tmin = vdupq_n_s32(-4000);
+    const int32x4_t tmax = vdupq_n_s32( 8500);
+
+    uint32x4_t ut;
+    int32x4_t  v1, v2, tf, t;
+    size_t     i = 0;
+
+    for ( ; i + 4 <= count; i += 4)
+    {
+        ut = vld1q_u32(unctemp + i);
+
+        v1 = vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(ut, 3)), t1x2);
+        v1 = neon_div2n(vmulq_n_s32(v1, (int32_t)cp.t2), 11);
+
+        v2 = vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(ut, 4)), t1);
+        v2 = neon_div2n(vmulq_s32(v2, v2), 12);
+        v2 = neon_div2n(vmulq_n_s32(v2, (int32_t)cp.t3), 14);
+        tf = vaddq_s32(v1, v2);
+
+        t  = vaddq_s32(vmulq_n_s32(tf, 5), vdupq_n_s32(128));
+        t  = neon_div2n(t, 8);
+        t  = vminq_s32(vmaxq_s32(t, tmin), tmax);
+
+        vst1q_s32(temp  + i, t);
+        vst1q_s32(tfine + i, tf);
+    }
+
+    return i;
+}
+
+/*
+ * static size_t humid_neon(const CalParams& cp, const uint32_t* unchum, const int32_t* tfine,
+ *                          size_t count, uint32_t* humid)
+ *
+ * Description:
+ *   Comp32FixedHumid(), four samples at a time.
+ */
+static size_t humid_neon(const CalParams& cp, const uint32_t* unchum, const int32_t* tfine,
+                         size_t count, uint32_t* humid)
+{
+    const int32x4_t h4   = vdupq_n_s32((int32_t)cp.h4 * 1048576);
+    const int32x4_t vmax = vdupq_n_s32(419430400);
+
+    int32x4_t v1, v2, v3, v4, v5;
+    size_t    i = 0;
+
+    for ( ; i + 4 <= count; i += 4)
+    {
+        v1 = vsubq_s32(vld1q_s32(tfine + i), vdupq_n_s32(76800));
+        v2 = vreinterpretq_s32_u32(vshlq_n_u32(vld1q_u32(unchum + i), 14));
+        v4 = vmulq_n_s32(v1, (int32_t)cp.h5);
+        v5 = vaddq_s32(vsubq_s32(vsubq_s32(v2, h4), v4), vdupq_n_s32(16384));
+        v5 = neon_div2n(v5, 15);
+        v2 = neon_div2n(vmulq_n_s32(v1, (int32_t)cp.h6), 10);
+        v3 = neon_div2n(vmulq_n_s32(v1, (int32_t)cp.h3), 11);
+        v4 = neon_div2n(vmulq_s32(v2, vaddq_s32(v3, vdupq_n_s32(32768))), 10);
+        v4 = vaddq_s32(v4, vdupq_n_s32(2097152));
+        v2 = neon_div2n(vaddq_s32(vmulq_n_s32(v4, (int32_t)cp.h2), vdupq_n_s32(8192)), 14);
+        v3 = vmulq_s32(v5, v2);
+        v4 = neon_div2n(v3, 15);
+        v4 = neon_div2n(vmulq_s32(v4, v4), 7);
+        v5 = vsubq_s32(v3, neon_div2n(vmulq_n_s32(v4, (int32_t)cp.h1), 4));
+        v5 = vminq_s32(vmaxq_s32(v5, vdupq_n_s32(0)), vmax);
+
+        vst1q_u32(humid + i, vshrq_n_u32(vreinterpretq_u32_s32(v5), 12));
+    }
+
+    return i;
+}
+
+#endif // __ARM_NEON
+
+/*
+ * struct Comp32Kernels
+ *
+ * Description:
+ *   One set of batch kernels. usable is null if the kernels run on
+ *   every host this file was built for; temp and humid are null for
+ *   the scalar set.
+ */
+struct Comp32Kernels
+{
+    const char*        name;
+    bool               (*usable) ();
+    Comp32TempKernel   temp;
+    Comp32HumidKernel  humid;
+};
+
+// Best first. The scalar set is always last.
+static const Comp32Kernels comp32_kernels[] =
+{
+#if defined(BME280_BATCH_X86)
+    { "avx2",   avx2_usable,  temp_avx2,  humid_avx2  },
+    { "sse4.1", sse41_usable, temp_sse41, humid_sse41 },
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    { "neon",   nullptr,      temp_neon,  humid_neon  },
+#endif
+    { "scalar", nullptr,      nullptr,    nullptr     },
+};
+
+#define BME280_BATCH_KERNELS  (sizeof(comp32_kernels) / sizeof(comp32_kernels[0]))
+
+/*
+ * static const Comp32Kernels& comp32_best()
+ *
+ * Description:
+ *   Returns the first kernel set that the host can run.
+ */
+static const Comp32Kernels& comp32_best()
+{
+    size_t k = 0;
+
+    while (comp32_kernels[k].usable && !comp32_kernels[k].usable())
+        k++;
+
+    return comp32_kernels[k];
+}
+
+/*
+ * static const Comp32Kernels& comp32_select()
+ *
+ * Description:
+ *   Returns the kernel set for Comp32FixedBatch(), chosen once, on
+ *   first use.
+ */
+static const Comp32Kernels& comp32_select()
+{
+    static const Comp32Kernels& selected = comp32_best();
+    return selected;
+}
+
+/*
+ * static void comp32_block(const Comp32Kernels& k, const CalParams& cp,
+ *                          const TPH32SensorData* sensdat, size_t count,
+ *                          int32_t* temp, uint32_t* press, uint32_t* humid)
+ *
+ * Description:
+ *   Compensates one block of samples, at most BME280_BATCH_BLOCK.
+ *   Raw temperature and humidity are first gathered into contiguous
+ *   arrays for the vector kernels.
+ */
+static void comp32_block(const Comp32Kernels& k, const CalParams& cp,
+                         const TPH32SensorData* sensdat, size_t count,
+                         int32_t* temp, uint32_t* press, uint32_t* humid)
+{
+    uint32_t raw[BME280_BATCH_BLOCK];
+    int32_t  tfine[BME280_BATCH_BLOCK];
+    size_t   i;
+    size_t   done;
+
+    for (i = 0; i < count; i++)
+        raw[i] = sensdat[i].temperature;
+
+    done = k.temp ? k.temp(cp, raw, count, temp, tfine) : 0;
+    for (i = done; i < count; i++)
+        temp[i] = Comp32FixedTemp(cp, raw[i], tfine[i]);
+
+    for (i = 0; i < count; i++)
+        press[i] = Comp32FixedPress(cp, sensdat[i].pressure, tfine[i]);
+
+    for (i = 0; i < count; i++)
+        raw[i] = sensdat[i].humidity;
+
+    done = k.humid ? k.humid(cp, raw, tfine, count, humid) : 0;
+    for (i = done; i < count; i++)
+        humid[i] = Comp32FixedHumid(cp, raw[i], tfine[i]);
+}
+
+/*
+ * static void comp32_batch(const Comp32Kernels& k, const CalParams& cp,
+ *                          const TPH32SensorData* sensdat, size_t count,
+ *                          int32_t* temp, uint32_t* press, uint32_t* humid)
+ *
+ * Description:
+ *   Comp32FixedBatch() with a given kernel set.
+ */
+static void comp32_batch(const Comp32Kernels& k, const CalParams& cp,
+                         const TPH32SensorData* sensdat, size_t count,
+                         int32_t* temp, uint32_t* press, uint32_t* humid)
+{
+    size_t blocklen;
+
+    for (size_t i = 0; i < count; i += blocklen)
+    {
+        blocklen = count - i;
+        if (blocklen > BME280_BATCH_BLOCK)
+            blocklen = BME280_BATCH_BLOCK;
+
+        comp32_block(k, cp, sensdat + i, blocklen, temp + i, press + i, humid + i);
+    }
+}
+
+/*
+ * void Comp32FixedBatch(const CalParams& cp, const TPH32SensorData* sensdat,
+ *                       size_t count, int32_t* temp, uint32_t* press, uint32_t* humid)
+ *
+ * Description:
+ *   Applies 32-bit fixed-point compensation to an array of raw
+ *   samples. Results are identical to calling Comp32FixedTemp(),
+ *   Comp32FixedPress(), and Comp32FixedHumid() on each sample in turn.
+ *
+ *   Temperature and humidity use the best vector kernels the host
+ *   can run: AVX2 or SSE4.1 on x86-64, chosen at run time, NEON on
+ *   ARM. Comp32BatchKernel() names the choice.
+ *
+ *   Samples are processed in blocks of BME280_BATCH_BLOCK so that
+ *   intermediate tfine values stay in a small stack buffer.
+ *
+ * Parameters:
+ *   cp      - calibration parameters
+ *   sensdat - pointer to an array of uncompensated samples
+ *   count   - the number of samples
+ *   temp    - array of count elements, receives temperature
+ *             (1/100 degrees centigrade)
+ *   press   - array of count elements, receives pressure (Pa)
+ *   humid   - array of count elements, receives humidity
+ *             (percent relative humidity * 1024)
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_comp.hpp
+ */
+void Comp32FixedBatch(const CalParams& cp, const TPH32SensorData* sensdat,
+                      size_t count, int32_t* temp, uint32_t* press, uint32_t* humid)
+{
+    comp32_batch(comp32_select(), cp, sensdat, count, temp, press, humid);
+}
+
+/*
+ * const char* Comp32BatchKernel()
+ *
+ * Description:
+ *   Names the kernels Comp32FixedBatch() uses on this host: "avx2",
+ *   "sse4.1", "neon", or "scalar".
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_comp.hpp
+ */
+const char* Comp32BatchKernel()
+{
+    return comp32_select().name;
+}
+
+/*
+ * BatchBench BenchBatch(const CalParams& cp, const TPH32SensorData* sensdat,
+ *                       size_t count, unsigned rounds)
+ *
+ * Description:
+ *   Times Comp32FixedBatch() against a loop over Comp32FixedTemp(),
+ *   Comp32FixedPress(), and Comp32FixedHumid(), over the same
+ *   samples, rounds times each.
+ *
+ *   Also checks the output of every kernel set the host can run
+ *   against the loop, bit for bit, and counts the samples where any
+ *   of them differ. This should be zero.
+ *
+ * Parameters:
+ *   cp      - calibration parameters
+ *   sensdat - pointer to an array of uncompensated samples
+ *   count   - the number of samples
+ *   rounds  - number of timed passes over the samples
+ *
+ * Returns:
+ *   Per-sample times of each method, and the mismatch count.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_comp.hpp
+ */
+BatchBench BenchBatch(const CalParams& cp, const TPH32SensorData* sensdat,
+                      size_t count, unsigned rounds)
+{
+    BatchBench bb;
+    bb.samples = count;
+    bb.kernel  = Comp32BatchKernel();
+
+    if (count == 0 || rounds == 0)
+        return bb;
+
+   std::vector<int32_t>  ltemp(count),  btemp(count);
+   std::vector<uint32_t> lpress(count), bpress(count);
+   std::vector<uint32_t> lhumid(count), bhumid(count);
+    int32_t          tfine;
+    int64_t          start;
+
+    start = SteadyNanos();
+    for (unsigned r = 0; r < rounds; r++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            ltemp[i]  = Comp32FixedTemp  (cp, sensdat[i].temperature, tfine);
+            lpress[i] = Comp32FixedPress (cp, sensdat[i].pressure,    tfine);
+            lhumid[i] = Comp32FixedHumid (cp, sensdat[i].humidity,    tfine);
+        }
+    }
+    bb.loop_ns = (double)(SteadyNanos() - start) / ((double)count * rounds);
+
+    start = SteadyNanos();
+    for (unsigned r = 0; r < rounds; r++)
+        Comp32FixedBatch(cp, sensdat, count, &btemp[0], &bpress[0], &bhumid[0]);
+    bb.batch_ns = (double)(SteadyNanos() - start) / ((double)count * rounds);
+
+   std::vector<bool> bad(count, false);
+
+    for (size_t k = 0; k < BME280_BATCH_KERNELS; k++)
+    {
+        if (comp32_kernels[k].usable && !comp32_kernels[k].usable())
+            continue;
+
+        comp32_batch(comp32_kernels[k], cp, sensdat, count, &btemp[0], &bpress[0], &bhumid[0]);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            if (btemp[i] != ltemp[i] || bpress[i] != lpress[i] || bhumid[i] != lhumid[i])
+                bad[i] = true;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++)
+        if (bad[i]) bb.mismatches++;
+
+    return bb;
+}
+
+
+
+// Single-Precision Compensation
+// -----------------------------------------------------------------
+// Float compensation is CompPreparedTemp/Press/Humid<float>() in
+// bme280_comp.hpp, the prepared double formulas with every operation
+// in single precision. Measured against the double
+// reference (CompDoubleData with PreparedCalibration) over the full
+// 20-bit temperature and pressure and 16-bit humidity raw domains,
+// for twenty calibration sets around the datasheet example values,
+// outputs that fall inside the clamp limits differ by at most:
+//
+//   temperature   0.00002 degC
+//   pressure      0.06    Pa
+//   humidity      0.0001  %RH
+//
+// tfine, which is truncated to an integer, may differ by one. The
+// figures above include that effect.
+
+/*
+ * TPHFloatCompData CompFloatData(const PreparedFloatCalibration& pc, const TPH32SensorData& sensdat)
+ *
+ * Description:
+ *   Applies single-precision floating-point compensation to a
+ *   complete temperature, pressure, and humidity sample.
+ *
+ * Parameters:
+ *   pc      - prepared float calibration coefficients
+ *   sensdat - uncompensated sample
+ *
+ * Returns:
+ *   Returns a TPHFloatCompData structure containing the sample time
+ *   stamp, the compensated values, and the tfine value that was used
+ *   for pressure and humidity.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_comp.hpp
+ */
+TPHFloatCompData CompFloatData(const PreparedFloatCalibration& pc, const TPH32SensorData& sensdat)
+{
+    TPHFloatCompData compdat;
+
+    compdat.timestamp   = sensdat.timestamp;
+    compdat.sampled     = sensdat.sampled;
+    compdat.temperature = CompFloatTemp  (pc, sensdat.temperature, compdat.tfine);
+    compdat.pressure    = CompFloatPress (pc, sensdat.pressure,    compdat.tfine);
+    compdat.humidity    = CompFloatHumid (pc, sensdat.humidity,    compdat.tfine);
+
+    return compdat;
+}
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+/*
+ * static float32x4_t neon_div(float32x4_t num, float32x4_t den)
+ *
+ * Description:
+ *   Four-lane division. AArch64 has a vector divide; 32-bit NEON
+ *   does not, so there the reciprocal estimate is refined with two
+ *   Newton-Raphson steps, which is good to about one ulp.
+ */
+static inline float32x4_t neon_div(float32x4_t num, float32x4_t den)
+{
+#if defined(__aarch64__)
+    return vdivq_f32(num, den);
+#else
+    float32x4_t r = vrecpeq_f32(den);
+    r = vmulq_f32(vrecpsq_f32(den, r), r);
+    r = vmulq_f32(vrecpsq_f32(den, r), r);
+    return vmulq_f32(num, r);
+#endif
+}
+
+/*
+ * static void compf_neon4(const PreparedFloatCalibration& pc,
+ *                         const uint32_t* ut, const uint32_t* up, const uint32_t* uh,
+ *                         float* temp, float* press, float* humid)
+ *
+ * Description:
+ *   Compensates four samples at once, one per NEON lane. Operation
+ *   order follows CompFloatTemp(), CompFloatPress(), and
+ *   CompFloatHumid().
+ */
+static void compf_neon4(const PreparedFloatCalibration& pc,
+                        const uint32_t* ut, const uint32_t* up, const uint32_t* uh,
+                        float* temp, float* press, float* humid)
+{
+    float32x4_t v1, v2, v3, v5, v6;
+    float32x4_t x;
+
+    // Temperature
+    x  = vcvtq_f32_u32(vld1q_u32(ut));
+    v1 = vmulq_n_f32(vsubq_f32(vmulq_n_f32(x, 1.0f/16384.0f),  vdupq_n_f32(pc.t1_1024)), pc.t2);
+    v2 = vsubq_f32(vmulq_n_f32(x, 1.0f/131072.0f), vdupq_n_f32(pc.t1_8192));
+    v2 = vmulq_n_f32(vmulq_f32(v2, v2), pc.t3);
+    x  = vaddq_f32(v1, v2);
+
+    int32x4_t   tfine = vcvtq_s32_f32(x);
+    float32x4_t ftf   = vcvtq_f32_s32(tfine);
+
+    x = vmulq_n_f32(x, 1.0f/5120.0f);
+    x = vminq_f32(vmaxq_f32(x, vdupq_n_f32(-40.0f)), vdupq_n_f32(85.0f));
+    vst1q_f32(temp, x);
+
+    // Pressure
+    v1 = vsubq_f32(vmulq_n_f32(ftf, 0.5f), vdupq_n_f32(64000.0f));
+    v2 = vmulq_n_f32(vmulq_f32(v1, v1), pc.p6_2e29);
+    v2 = vaddq_f32(v2, vmulq_n_f32(v1, pc.p5_8192));
+    v2 = vaddq_f32(v2, vdupq_n_f32(pc.p4_16));
+    v3 = vmulq_f32(vmulq_n_f32(v1, pc.p3_2e53), v1);
+    v1 = vaddq_f32(vdupq_n_f32(1.0f), vaddq_f32(v3, vmulq_n_f32(v1, pc.p2_2e34)));
+    v1 = vmulq_n_f32(v1, pc.p1);
+
+    uint32x4_t zero = vceqq_f32(v1, vdupq_n_f32(0.0f));
+
+    x  = vsubq_f32(vdupq_n_f32(1048576.0f), vcvtq_f32_u32(vld1q_u32(up)));
+    x  = neon_div(vmulq_n_f32(vsubq_f32(x, v2), 6250.0f), v1);
+    v1 = vmulq_f32(vmulq_n_f32(x, pc.p9_2e35), x);
+    v2 = vmulq_n_f32(x, pc.p8_2e19);
+    x  = vaddq_f32(x, vaddq_f32(vaddq_f32(v1, v2), vdupq_n_f32(pc.p7_16)));
+    x  = vminq_f32(vmaxq_f32(x, vdupq_n_f32(30000.0f)), vdupq_n_f32(110000.0f));
+    x  = vbslq_f32(zero, vdupq_n_f32(30000.0f), x);
+    vst1q_f32(press, x);
+
+    // Humidity
+    v1 = vsubq_f32(ftf, vdupq_n_f32(76800.0f));
+    v2 = vaddq_f32(vdupq_n_f32(pc.h4_64), vmulq_n_f32(v1, pc.h5_2e14));
+    v3 = vsubq_f32(vcvtq_f32_u32(vld1q_u32(uh)), v2);
+    v5 = vaddq_f32(vdupq_n_f32(1.0f), vmulq_n_f32(v1, pc.h3_2e26));
+    v6 = vaddq_f32(vdupq_n_f32(1.0f), vmulq_f32(vmulq_n_f32(v1, pc.h6_2e26), v5));
+    v6 = vmulq_f32(vmulq_f32(vmulq_n_f32(v3, pc.h2_2e16), v5), v6);
+    x  = vmulq_f32(v6, vsubq_f32(vdupq_n_f32(1.0f), vmulq_n_f32(v6, pc.h1_2e19)));
+    x  = vminq_f32(vmaxq_f32(x, vdupq_n_f32(0.0f)), vdupq_n_f32(100.0f));
+    vst1q_f32(humid, x);
+}
+
+#endif
+
+/*
+ * void CompFloatBatch(const PreparedFloatCalibration& pc, const TPH32SensorData* sensdat,
+ *                     size_t count, float* temp, float* press, float* humid)
+ *
+ * Description:
+ *   Applies single-precision floating-point compensation to an array
+ *   of raw samples.
+ *
+ *   Where NEON is available, samples are compensated four at a time.
+ *   Results then match CompFloatData() except for pressure on 32-bit
+ *   ARM, where division by reciprocal estimate may differ from it by
+ *   about one ulp. Elsewhere this is a plain loop over CompFloatData().
+ *
+ * Parameters:
+ *   pc      - prepared float calibration coefficients
+ *   sensdat - pointer to an array of uncompensated samples
+ *   count   - the number of samples
+ *   temp    - array of count elements, receives temperature (degC)
+ *   press   - array of count elements, receives pressure (Pa)
+ *   humid   - array of count elements, receives humidity (%RH)
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_comp.hpp
+ */
+void CompFloatBatch(const PreparedFloatCalibration& pc, const TPH32SensorData* sensdat,
+                    size_t count, float* temp, float* press, float* humid)
+{
+    size_t i = 0;
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    uint32_t ut[4];
+    uint32_t up[4];
+    uint32_t uh[4];
+
+    for ( ; i + 4 <= count; i += 4)
+    {
+        for (int lane = 0; lane < 4; lane++)
+        {
+            ut[lane] = sensdat[i + lane].temperature;
+            up[lane] = sensdat[i + lane].pressure;
+            uh[lane] = sensdat[i + lane].humidity;
+        }
+
+        compf_neon4(pc, ut, up, uh, temp + i, press + i, humid + i);
+    }
+#endif
+
+    int32_t tfine;
+
+    for ( ; i < count; i++)
+    {
+        temp[i]  = CompFloatTemp  (pc, sensdat[i].temperature, tfine);
+        press[i] = CompFloatPress (pc, sensdat[i].pressure,    tfine);
+        humid[i] = CompFloatHumid (pc, sensdat[i].humidity,    tfine);
+    }
+}
+
+
+// BME280 Compensation
+// -----------------------------------------------------------------
+// Member functions use the device's own calibration parameters and
+// carry tfine from the temperature call to the pressure and humidity
+// calls through cparams.tfine.
+
+/*
+ * int32_t BME280::Comp32FixedTemp(uint32_t unctemp)
+ *
+ * Description:
+ *   Applies 32-bit fixed-point compensation to a temperature reading.
+ *   Also generates a temperature value (tfine) which is used to
+ *   compensate associated pressure and humidity readings.
+ *
+ * Parameters:
+ *   unctemp - an uncompensated temperature value
+ *
+ * Returns:
+ *   Returns a 32-bit integer that has units of 1/100 degrees centigrade.
+ *
+ *   cparams.tfine - When this function exits, tfine will contain a value
+ *   that can be used to compensate associated pressure and humidity
+ *   readings.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+int32_t BME280::Comp32FixedTemp(uint32_t unctemp)
+{
+    if (!cparams.loaded) this->LoadCalParams();
+
+    return bosch_bme280::Comp32FixedTemp(cparams, unctemp, cparams.tfine);
+}
+
+/*
+ * uint32_t BME280::Comp32FixedPress(uint32_t uncpress)
+ *
+ * Description:
+ *   Applies 32-bit fixed-point compensation to a pressure reading.
+ *
+ * Parameters:
+ *   uncpress - an uncompensated pressure value
+ *
+ * Returns:
+ *   Returns barometric pressure, in pascals (Pa).
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+uint32_t BME280::Comp32FixedPress(uint32_t uncpress)
+{
+    return bosch_bme280::Comp32FixedPress(cparams, uncpress, cparams.tfine);
+}
+
+/*
+ * uint32_t BME280::Comp32FixedHumid(uint32_t unchum)
+ *
+ * Description:
+ *   Applies 32-bit fixed-point compensation to a humidity reading.
+ *
+ * Parameters:
+ *   unchum - an uncompensated humidity value
+ *
+ * Returns
+ *   Returns a 32-bit integer which, when divided by 1024, yields
+ *   percent relative humidity.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+uint32_t BME280::Comp32FixedHumid(uint32_t unchum)
+{
+    if (!cparams.loaded) this->LoadCalParams();
+
+    return bosch_bme280::Comp32FixedHumid(cparams, unchum, cparams.tfine);
+}
+
+/*
+ * uint32_t BME280::Comp64FixedPress(uint32_t uncpress)
+ *
+ * Description:
+ *   Applies 64-bit fixed-point compensation to a pressure reading.
+ *   Uses the tfine generated by Comp32FixedTemp().
+ *
+ * Parameters:
+ *   uncpress - an uncompensated pressure value
+ *
+ * Returns:
+ *   Returns barometric pressure, in 1/100 pascals.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+uint32_t BME280::Comp64FixedPress(uint32_t uncpress)
+{
+    return bosch_bme280::Comp64FixedPress(cparams, uncpress, cparams.tfine);
+}
+
+/*
+ * void BME280::Comp32FixedBatch(const TPH32SensorData* sensdat, size_t count,
+ *                               int32_t* temp, uint32_t* press, uint32_t* humid)
+ *
+ * Description:
+ *   Applies 32-bit fixed-point compensation to an array of raw
+ *   samples. Results are identical to calling Comp32FixedTemp(),
+ *   Comp32FixedPress(), and Comp32FixedHumid() on each sample in turn.
+ *
+ * Parameters:
+ *   sensdat - pointer to an array of uncompensated samples
+ *   count   - the number of samples
+ *   temp    - array of count elements, receives temperature
+ *             (1/100 degrees centigrade)
+ *   press   - array of count elements, receives pressure (Pa)
+ *   humid   - array of count elements, receives humidity
+ *             (percent relative humidity * 1024)
+ *
+ *   cparams.tfine - When this function exits, tfine will contain the
+ *   value generated by the last sample.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+void BME280::Comp32FixedBatch(const TPH32SensorData* sensdat, size_t count,
+                              int32_t* temp, uint32_t* press, uint32_t* humid)
+{
+    if (!cparams.loaded) this->LoadCalParams();
+
+    bosch_bme280::Comp32FixedBatch(cparams, sensdat, count, temp, press, humid);
+
+    if (count)
+        bosch_bme280::Comp32FixedTemp(cparams, sensdat[count-1].temperature, cparams.tfine);
+}
+
+/*
+ * double BME280::CompDoubleTemp(uint32_t unctemp)
+ *
+ * Description:
+ *   Applies double floating-point compensation to a temperature
+ *   reading.
+ *
+ * Parameters:
+ *   unctemp - an uncompensated temperature value
+ *
+ * Returns:
+ *   Returns temperature, in degrees centigrade.
+ *
+ *   cparams.tfine - When this function exits, tfine will contain a value
+ *   that can be used to compensate associated pressure and humidity
+ *   readings.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+double BME280::CompDoubleTemp(uint32_t unctemp)
+{
+    if (!cparams.loaded) this->LoadCalParams();
+
+    return bosch_bme280::CompDoubleTemp(pcal, unctemp, cparams.tfine);
+}
+
+/*
+ * double BME280::CompDoublePress(uint32_t uncpress)
+ *
+ * Description:
+ *   Applies double floating-point compensation to a pressure
+ *   reading.
+ *
+ * Parameters:
+ *   uncpress - an uncompensated pressure value
+ *
+ * Returns:
+ *   Returns barometric pressure, in pascals (Pa).
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+double BME280::CompDoublePress(uint32_t uncpress)
+{
+    return bosch_bme280::CompDoublePress(pcal, uncpress, cparams.tfine);
+}
+
+/*
+ * double BME280::CompDoubleHumid(uint32_t unchum)
+ *
+ * Description:
+ *   Applies double floating-point compensation to a humidity
+ *   reading.
+ *
+ * Parameters:
+ *   unchum - an uncompensated humidity value
+ *
+ * Returns:
+ *   Returns percent relative humidity.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280.hpp
+ */
+double BME280::CompDoubleHumid(uint32_t unchum)
+{
+    return bosch_bme280::CompDoubleHumid(pcal, unchum, cparams.tfine);
+}
+
 } // namespace bosch_bme280
-```
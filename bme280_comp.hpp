@@ -0,0 +1,329 @@
+/*
+ * bme280_comp.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Stateless compensation functions for the Bosch Sensortec BME280
+ *    combined humidity and pressure sensor.
+ *
+ *    These functions take calibration parameters and raw values as
+ *    arguments and return tfine to the caller rather than storing it
+ *    in CalParams, so a single CalParams may be shared, read-only, by
+ *    any number of threads.
+ */
+
+#ifndef BME280_COMP_HPP_
+#define BME280_COMP_HPP_
+
+#include <stddef.h>          // size_t
+#include <stdint.h>          // int32_t, uint32_t, int64_t
+
+#include "bme280_data.hpp"
+
+
+namespace bosch_bme280
+{
+
+ int32_t  Comp32FixedTemp  ( const CalParams& cp, uint32_t unctemp,  int32_t& tfine );
+uint32_t  Comp32FixedPress ( const CalParams& cp, uint32_t uncpress, int32_t  tfine );
+uint32_t  Comp32FixedHumid ( const CalParams& cp, uint32_t unchum,   int32_t  tfine );
+uint32_t  Comp64FixedPress ( const CalParams& cp, uint32_t uncpress, int32_t  tfine );
+
+double  CompDoubleTemp  ( const CalParams& cp, uint32_t unctemp,  int32_t& tfine );
+double  CompDoublePress ( const CalParams& cp, uint32_t uncpress, int32_t  tfine );
+double  CompDoubleHumid ( const CalParams& cp, uint32_t unchum,   int32_t  tfine );
+
+
+// Prepared Floating-Point Compensation
+// -----------------------------------------------------------------
+// One set of formulas for both precisions, templated on the value
+// type T. They are defined here, in the header, so that callers such
+// as Compensator<FloatPolicy> and Compensator<DoublePolicy> inline
+// them fully.
+
+/*
+ * template <class T> struct PreparedFor
+ *
+ * Description:
+ *   The prepared calibration type for value type T:
+ *   PreparedCalibration for double, PreparedFloatCalibration for
+ *   float.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_comp.hpp
+ */
+template <class T> struct PreparedFor;
+
+template <> struct PreparedFor<double> { typedef PreparedCalibration       Calibration; };
+template <> struct PreparedFor<float>  { typedef PreparedFloatCalibration  Calibration; };
+
+/*
+ * template <class T>
+ * T CompPreparedTemp(const typename PreparedFor<T>::Calibration& pc,
+ *                    uint32_t unctemp, int32_t& tfine)
+ *
+ * Description:
+ *   Applies floating-point compensation, in precision T, to a
+ *   temperature reading, using prepared calibration coefficients.
+ *   Also generates tfine. Contains no division.
+ *
+ * Parameters:
+ *   pc      - prepared calibration coefficients
+ *   unctemp - an uncompensated temperature value
+ *   tfine   - receives a value that can be used to compensate
+ *             associated pressure and humidity readings
+ *
+ * Returns:
+ *   Returns temperature, in degrees centigrade.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_comp.hpp
+ */
+template <class T>
+inline T CompPreparedTemp ( const typename PreparedFor<T>::Calibration& pc,
+                            uint32_t unctemp, int32_t& tfine )
+{
+    T v1;
+    T v2;
+    T temperature;
+    T utemp = (T)unctemp;
+    T t_min = T(-40.0);
+    T t_max = T( 85.0);
+
+    v1 = (utemp*T(1.0/16384.0)  - pc.t1_1024) * pc.t2;
+    v2 = (utemp*T(1.0/131072.0) - pc.t1_8192);
+    v2 = (v2*v2) * pc.t3;
+
+    tfine = (int32_t)(v1 + v2);
+    temperature = (v1+v2)*(T(1.0)/T(5120.0));
+
+    if (temperature < t_min)
+        temperature = t_min;
+    else if (temperature > t_max)
+        temperature = t_max;
+
+    return temperature;
+}
+
+/*
+ * template <class T>
+ * T CompPreparedPress(const typename PreparedFor<T>::Calibration& pc,
+ *                     uint32_t uncpress, int32_t tfine)
+ *
+ * Description:
+ *   Applies floating-point compensation, in precision T, to a
+ *   pressure reading, using prepared calibration coefficients. The
+ *   only division left is by a term that depends on tfine.
+ *
+ * Parameters:
+ *   pc       - prepared calibration coefficients
+ *   uncpress - an uncompensated pressure value
+ *   tfine    - generated by CompPreparedTemp() for the same sample
+ *
+ * Returns:
+ *   Returns barometric pressure, in pascals (Pa).
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_comp.hpp
+ */
+template <class T>
+inline T CompPreparedPress ( const typename PreparedFor<T>::Calibration& pc,
+                             uint32_t uncpress, int32_t tfine )
+{
+    T v1;
+    T v2;
+    T v3;
+    T pressure;
+    T p_min = T( 30000.0);
+    T p_max = T(110000.0);
+
+    v1 = ((T)tfine*T(0.5)) - T(64000.0);
+    v2 = v1*v1 * pc.p6_2e29;
+    v2 = v2+v1 * pc.p5_8192;
+    v2 = v2 + pc.p4_16;
+    v3 = pc.p3_2e53*v1*v1;
+    v1 = T(1.0) + (v3 + pc.p2_2e34 * v1);
+    v1 = v1 * pc.p1;
+
+    if (v1 != T(0.0))
+    {
+        pressure = T(1048576.0) - (T)uncpress;
+        pressure = (pressure - v2) * T(6250.0) / v1;
+        v1 = pc.p9_2e35 * pressure * pressure;
+        v2 = pressure * pc.p8_2e19;
+        pressure = pressure + (v1 + v2 + pc.p7_16);
+
+        if (pressure < p_min)
+            pressure = p_min;
+        else if (pressure > p_max)
+            pressure = p_max;
+    }
+    else
+    {
+        pressure = p_min;
+    }
+
+    return pressure;
+}
+
+/*
+ * template <class T>
+ * T CompPreparedHumid(const typename PreparedFor<T>::Calibration& pc,
+ *                     uint32_t unchum, int32_t tfine)
+ *
+ * Description:
+ *   Applies floating-point compensation, in precision T, to a
+ *   humidity reading, using prepared calibration coefficients.
+ *   Contains no division.
+ *
+ * Parameters:
+ *   pc     - prepared calibration coefficients
+ *   unchum - an uncompensated humidity value
+ *   tfine  - generated by CompPreparedTemp() for the same sample
+ *
+ * Returns:
+ *   Returns percent relative humidity.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_comp.hpp
+ */
+template <class T>
+inline T CompPreparedHumid ( const typename PreparedFor<T>::Calibration& pc,
+                             uint32_t unchum, int32_t tfine )
+{
+    T humidity;
+    T hu_min = T(0.0);
+    T hu_max = T(100.0);
+    T v1, v2, v3, v5, v6;
+
+    v1 = ((T)tfine) - T(76800.0);
+    v2 = pc.h4_64 + pc.h5_2e14 * v1;
+    v3 = (T)unchum - v2;
+    v5 = (T(1.0) + pc.h3_2e26 * v1);
+    v6 = T(1.0) + pc.h6_2e26 * v1 * v5;
+    v6 = v3*pc.h2_2e16*v5*v6;
+    humidity = v6 * (T(1.0) - pc.h1_2e19 * v6);
+
+    if (humidity > hu_max)
+        humidity = hu_max;
+    else if (humidity < hu_min)
+        humidity = hu_min;
+
+    return humidity;
+}
+
+// Double and float instances, under their established names.
+
+inline double CompDoubleTemp ( const PreparedCalibration& pc, uint32_t unctemp, int32_t& tfine )
+{ return CompPreparedTemp<double>(pc, unctemp, tfine); }
+
+inline double CompDoublePress ( const PreparedCalibration& pc, uint32_t uncpress, int32_t tfine )
+{ return CompPreparedPress<double>(pc, uncpress, tfine); }
+
+inline double CompDoubleHumid ( const PreparedCalibration& pc, uint32_t unchum, int32_t tfine )
+{ return CompPreparedHumid<double>(pc, unchum, tfine); }
+
+inline float CompFloatTemp ( const PreparedFloatCalibration& pc, uint32_t unctemp, int32_t& tfine )
+{ return CompPreparedTemp<float>(pc, unctemp, tfine); }
+
+inline float CompFloatPress ( const PreparedFloatCalibration& pc, uint32_t uncpress, int32_t tfine )
+{ return CompPreparedPress<float>(pc, uncpress, tfine); }
+
+inline float CompFloatHumid ( const PreparedFloatCalibration& pc, uint32_t unchum, int32_t tfine )
+{ return CompPreparedHumid<float>(pc, unchum, tfine); }
+
+TPH32CompData      Comp32FixedData ( const CalParams& cp, const TPH32SensorData& sensdat );
+TPHDoubleCompData  CompDoubleData  ( const CalParams& cp, const TPH32SensorData& sensdat );
+TPHDoubleCompData  CompDoubleData  ( const PreparedCalibration& pc, const TPH32SensorData& sensdat );
+TPHFloatCompData   CompFloatData   ( const PreparedFloatCalibration& pc, const TPH32SensorData& sensdat );
+
+/*
+ * struct CompBench
+ *
+ * Description:
+ *   Result of BenchCompensation().
+ *
+ *     samples     - samples per round
+ *     plain_ns    - per sample, CompDoubleData() from CalParams
+ *     prepared_ns - per sample, CompDoubleData() from a
+ *                   PreparedCalibration
+ *     mismatches  - samples whose pressure or humidity differ
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_comp.hpp
+ */
+struct CompBench
+{
+    size_t  samples;
+    double  plain_ns;
+    double  prepared_ns;
+    size_t  mismatches;
+
+    CompBench ( )
+      : samples(0), plain_ns(0.0), prepared_ns(0.0), mismatches(0) { }
+};
+
+CompBench  BenchCompensation ( const CalParams& cp, const TPH32SensorData* sensdat,
+                               size_t count, unsigned rounds );
+
+void  Comp32FixedBatch ( const CalParams& cp, const TPH32SensorData* sensdat, size_t count,
+                         int32_t* temp, uint32_t* press, uint32_t* humid );
+void  CompFloatBatch   ( const PreparedFloatCalibration& pc, const TPH32SensorData* sensdat, size_t count,
+                         float* temp, float* press, float* humid );
+
+const char*  Comp32BatchKernel ();
+
+/*
+ * struct BatchBench
+ *
+ * Description:
+ *   Result of BenchBatch().
+ *
+ *     samples    - samples per round
+ *     kernel     - Comp32BatchKernel()
+ *     loop_ns    - per sample, Comp32Fixed{Temp,Press,Humid}() loop
+ *     batch_ns   - per sample, Comp32FixedBatch()
+ *     mismatches - samples where any usable kernel set differs from
+ *                  the loop
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_comp.hpp
+ */
+struct BatchBench
+{
+    size_t       samples;
+    const char*  kernel;
+    double       loop_ns;
+    double       batch_ns;
+    size_t       mismatches;
+
+    BatchBench ( )
+      : samples(0), kernel(""), loop_ns(0.0), batch_ns(0.0), mismatches(0) { }
+};
+
+BatchBench  BenchBatch ( const CalParams& cp, const TPH32SensorData* sensdat,
+                         size_t count, unsigned rounds );
+
+} // namespace bosch_bme280
+
+#endif /* BME280_COMP_HPP_ */
@@ -0,0 +1,147 @@
+/*
+ * bme280_config.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Device configuration for the BME280: a typed description of the
+ *    ctrl_hum, ctrl_meas, and config register settings, and the
+ *    recommended settings for the data sheet's example use cases.
+ *
+ *    Field values are the register bit patterns defined in
+ *    bme280_defs.hpp, e.g. osrs_t = BME280_OSRS_T_2X.
+ *
+ *  Example:
+ *    dev.ApplyConfig(ConfigIndoorNav);     // 25 Hz, normal mode
+ *    ...
+ *    dev.ApplyConfig(ConfigWeather);       // 1/min, forced mode
+ */
+
+#ifndef BME280_CONFIG_HPP_
+#define BME280_CONFIG_HPP_
+
+#include <stdint.h>          // uint8_t
+
+#include "bme280_defs.hpp"
+
+
+namespace bosch_bme280
+{
+
+/*
+ * struct Config
+ *
+ * Description:
+ *   BME280 oversampling, filter, standby, and power mode settings.
+ *
+ *   IsValid() checks that every field holds a defined setting for
+ *   its register bits, and that pressure and humidity are measured
+ *   only together with temperature, which their compensation needs.
+ *   Because everything is constexpr, presets can be checked with
+ *   static_assert. A default Config holds the device reset values:
+ *   sleep mode with every measurement skipped.
+ *
+ *   spi3w selects the 3-wire SPI interface. It is part of the config
+ *   register, and is left clear for I2C and 4-wire SPI.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_config.hpp
+ */
+struct Config
+{
+    uint8_t  osrs_t;     // BME280_OSRS_T_xxx
+    uint8_t  osrs_p;     // BME280_OSRS_P_xxx
+    uint8_t  osrs_h;     // BME280_OSRS_H_xxx
+    uint8_t  filter;     // BME280_FILTER_xxx
+    uint8_t  t_sb;       // BME280_T_SB_xxx, normal mode only
+    uint8_t  mode;       // BME280_MODE_xxx
+    uint8_t  spi3w;      // BME280_SPI3W_xxx, 3-wire SPI interface
+
+    constexpr Config ( )
+      : osrs_t(0), osrs_p(0), osrs_h(0), filter(0), t_sb(0), mode(0), spi3w(0)
+    { }
+
+    constexpr Config ( uint8_t ost, uint8_t osp, uint8_t osh,
+                       uint8_t filt, uint8_t tsb, uint8_t pmode,
+                       uint8_t spi3 = BME280_SPI3W_DIS )
+      : osrs_t(ost), osrs_p(osp), osrs_h(osh),
+        filter(filt), t_sb(tsb), mode(pmode), spi3w(spi3)
+    { }
+
+    constexpr uint8_t CtrlHum () const
+    { return osrs_h; }
+
+    constexpr uint8_t CtrlMeas () const
+    { return (uint8_t)(osrs_t | osrs_p | mode); }
+
+    constexpr uint8_t ConfReg () const
+    { return (uint8_t)(t_sb | filter | spi3w); }
+
+    constexpr bool IsValid () const
+    {
+        return ((osrs_t & ~BME280_OSRS_T_MSK) == 0) && (osrs_t <= BME280_OSRS_T_16X) &&
+               ((osrs_p & ~BME280_OSRS_P_MSK) == 0) && (osrs_p <= BME280_OSRS_P_16X) &&
+               ((osrs_h & ~BME280_OSRS_H_MSK) == 0) && (osrs_h <= BME280_OSRS_H_16X) &&
+               ((filter & ~BME280_FILTER_MSK) == 0) && (filter <= BME280_FILTER_16)  &&
+               ((t_sb   & ~BME280_T_SB_MSK)   == 0) &&
+               ((spi3w  & ~BME280_SPI3W_MSK)  == 0) &&
+               ((mode == BME280_MODE_SLEEP) || (mode == BME280_MODE_FORCED) ||
+                (mode == BME280_MODE_NORMAL)) &&
+               ((osrs_t != BME280_OSRS_T_SKIP) ||
+                ((osrs_p == BME280_OSRS_P_SKIP) && (osrs_h == BME280_OSRS_H_SKIP)));
+    }
+
+    static constexpr Config FromRegs ( uint8_t ctrl_hum, uint8_t ctrl_meas, uint8_t config )
+    {
+        return Config((uint8_t)(ctrl_meas & BME280_OSRS_T_MSK),
+                      (uint8_t)(ctrl_meas & BME280_OSRS_P_MSK),
+                      (uint8_t)(ctrl_hum  & BME280_OSRS_H_MSK),
+                      (uint8_t)(config    & BME280_FILTER_MSK),
+                      (uint8_t)(config    & BME280_T_SB_MSK),
+                      (uint8_t)(ctrl_meas & BME280_MODE_MSK),
+                      (uint8_t)(config    & BME280_SPI3W_MSK));
+    }
+};
+
+
+// Recommended Settings
+// --------------------------------
+//   * From BME280 Data Sheet, section 3.5
+//     BST-BME280-DS002-13, Rev 1.5
+//     May 2018
+//
+// The forced mode scenarios are configured in sleep mode; each
+// sample is then triggered with Force() or ForceAndRead().
+
+// Weather monitoring: forced mode, 1 sample/min, 1x/1x/1x, filter off.
+constexpr Config ConfigWeather (
+    BME280_OSRS_T_1X, BME280_OSRS_P_1X, BME280_OSRS_H_1X,
+    BME280_FILTER_OFF, BME280_T_SB_1K, BME280_MODE_SLEEP );
+
+// Humidity sensing: forced mode, 1 sample/s, pressure skipped.
+constexpr Config ConfigHumidity (
+    BME280_OSRS_T_1X, BME280_OSRS_P_SKIP, BME280_OSRS_H_1X,
+    BME280_FILTER_OFF, BME280_T_SB_1K, BME280_MODE_SLEEP );
+
+// Indoor navigation: normal mode, t_sb 0.5 ms, 25 Hz, filter 16.
+constexpr Config ConfigIndoorNav (
+    BME280_OSRS_T_2X, BME280_OSRS_P_16X, BME280_OSRS_H_1X,
+    BME280_FILTER_16, BME280_T_SB_0_5, BME280_MODE_NORMAL );
+
+// Gaming: normal mode, t_sb 0.5 ms, 83 Hz, humidity skipped, filter 16.
+constexpr Config ConfigGaming (
+    BME280_OSRS_T_1X, BME280_OSRS_P_4X, BME280_OSRS_H_SKIP,
+    BME280_FILTER_16, BME280_T_SB_0_5, BME280_MODE_NORMAL );
+
+static_assert(ConfigWeather.IsValid(),   "ConfigWeather is not a valid configuration");
+static_assert(ConfigHumidity.IsValid(),  "ConfigHumidity is not a valid configuration");
+static_assert(ConfigIndoorNav.IsValid(), "ConfigIndoorNav is not a valid configuration");
+static_assert(ConfigGaming.IsValid(),    "ConfigGaming is not a valid configuration");
+
+} // namespace bosch_bme280
+
+#endif /* BME280_CONFIG_HPP_ */
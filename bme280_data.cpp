@@ -1,4 +1,3 @@
-```
 /*
  * bme280_data.cpp
  *
@@ -10,7 +9,8 @@
  */
 
 
-#include <chrono>            // time()
+#include <new>               // bad_alloc
+#include <stdlib.h>          // posix_memalign, free
 
 #include "bme280_data.hpp"
 
@@ -60,11 +60,234 @@ CalParams::CalParams()
     loaded = false;
 }
 
+/*
+ * CalParams::CalParams(const uint8_t* tpcal, const uint8_t* hucal)
+ *
+ * Description:
+ *   Constructor. Decodes calibration parameters from raw calibration
+ *   ROM bytes, as read from the device or kept in a capture file.
+ *   Sets loaded = true.
+ *
+ * Parameters:
+ *   tpcal - BME280_TPCAL_SIZE bytes, from 0x88 - 0xA1
+ *   hucal - BME280_HUCAL_SIZE bytes, from 0xE1 - 0xE7
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_data.hpp
+ */
+CalParams::CalParams(const uint8_t* tpcal, const uint8_t* hucal)
+{
+    tfine = 0;
+
+    t1 =          (((uint16_t)tpcal[1] << 8) | (uint16_t)tpcal[0]);
+    t2 = (int16_t)(((uint16_t)tpcal[3] << 8) | (uint16_t)tpcal[2]);
+    t3 = (int16_t)(((uint16_t)tpcal[5] << 8) | (uint16_t)tpcal[4]);
+
+    p1 =          (((uint16_t)tpcal[7]  << 8) | (uint16_t)tpcal[6]);
+    p2 = (int16_t)(((uint16_t)tpcal[9]  << 8) | (uint16_t)tpcal[8]);
+    p3 = (int16_t)(((uint16_t)tpcal[11] << 8) | (uint16_t)tpcal[10]);
+    p4 = (int16_t)(((uint16_t)tpcal[13] << 8) | (uint16_t)tpcal[12]);
+    p5 = (int16_t)(((uint16_t)tpcal[15] << 8) | (uint16_t)tpcal[14]);
+    p6 = (int16_t)(((uint16_t)tpcal[17] << 8) | (uint16_t)tpcal[16]);
+    p7 = (int16_t)(((uint16_t)tpcal[19] << 8) | (uint16_t)tpcal[18]);
+    p8 = (int16_t)(((uint16_t)tpcal[21] << 8) | (uint16_t)tpcal[20]);
+    p9 = (int16_t)(((uint16_t)tpcal[23] << 8) | (uint16_t)tpcal[22]);
+
+    h1 = tpcal[25];
+
+    h2 = (int16_t)(((uint16_t)hucal[1] << 8) | (uint16_t)hucal[0]);
+    h3 = hucal[2];
+
+    int16_t h4_msb = (int16_t)(int8_t)hucal[3] * 16;
+    int16_t h4_lsb = (int16_t)(hucal[4] & 0x0F);
+    h4 = h4_msb | h4_lsb;
+
+    int16_t h5_msb = (int16_t)(int8_t)hucal[5] * 16;
+    int16_t h5_lsb = (int16_t)(hucal[4] >> 4);
+    h5 = h5_msb | h5_lsb;
+
+    h6 = (int8_t)hucal[6];
+
+    loaded = true;
+}
+
+/*
+ * PreparedCalibration::PreparedCalibration()
+ *
+ * Description:
+ *   Constructor. Initializes all coefficients to zero,
+ *   loaded = false.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_data.hpp
+ */
+PreparedCalibration::PreparedCalibration()
+{
+    t1_1024 = 0.0;
+    t1_8192 = 0.0;
+    t2      = 0.0;
+    t3      = 0.0;
+
+    p1      = 0.0;
+    p2_2e34 = 0.0;
+    p3_2e53 = 0.0;
+    p4_16   = 0.0;
+    p5_8192 = 0.0;
+    p6_2e29 = 0.0;
+    p7_16   = 0.0;
+    p8_2e19 = 0.0;
+    p9_2e35 = 0.0;
+
+    h1_2e19 = 0.0;
+    h2_2e16 = 0.0;
+    h3_2e26 = 0.0;
+    h4_64   = 0.0;
+    h5_2e14 = 0.0;
+    h6_2e26 = 0.0;
+
+    loaded = false;
+}
+
+/*
+ * PreparedCalibration::PreparedCalibration(const CalParams& cp)
+ *
+ * Description:
+ *   Constructor. Converts calibration parameters to double and folds
+ *   in the constant scale factors used by double compensation.
+ *
+ *   Every scale factor is a power of two, so each product below is
+ *   exact.
+ *
+ * Parameters:
+ *   cp - calibration parameters, loaded from the device
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_data.hpp
+ */
+PreparedCalibration::PreparedCalibration(const CalParams& cp)
+{
+    t1_1024 = (double)cp.t1 * (1.0 / 1024.0);
+    t1_8192 = (double)cp.t1 * (1.0 / 8192.0);
+    t2      = (double)cp.t2;
+    t3      = (double)cp.t3;
+
+    p1      = (double)cp.p1;
+    p2_2e34 = (double)cp.p2 * (1.0 / 17179869184.0);
+    p3_2e53 = (double)cp.p3 * (1.0 / 9007199254740992.0);
+    p4_16   = (double)cp.p4 * 16.0;
+    p5_8192 = (double)cp.p5 * (1.0 / 8192.0);
+    p6_2e29 = (double)cp.p6 * (1.0 / 536870912.0);
+    p7_16   = (double)cp.p7 * (1.0 / 16.0);
+    p8_2e19 = (double)cp.p8 * (1.0 / 524288.0);
+    p9_2e35 = (double)cp.p9 * (1.0 / 34359738368.0);
+
+    h1_2e19 = (double)cp.h1 * (1.0 / 524288.0);
+    h2_2e16 = (double)cp.h2 * (1.0 / 65536.0);
+    h3_2e26 = (double)cp.h3 * (1.0 / 67108864.0);
+    h4_64   = (double)cp.h4 * 64.0;
+    h5_2e14 = (double)cp.h5 * (1.0 / 16384.0);
+    h6_2e26 = (double)cp.h6 * (1.0 / 67108864.0);
+
+    loaded = cp.loaded;
+}
+
+/*
+ * PreparedFloatCalibration::PreparedFloatCalibration()
+ *
+ * Description:
+ *   Constructor. Initializes all coefficients to zero,
+ *   loaded = false.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_data.hpp
+ */
+PreparedFloatCalibration::PreparedFloatCalibration()
+{
+    t1_1024 = 0.0f;
+    t1_8192 = 0.0f;
+    t2      = 0.0f;
+    t3      = 0.0f;
+
+    p1      = 0.0f;
+    p2_2e34 = 0.0f;
+    p3_2e53 = 0.0f;
+    p4_16   = 0.0f;
+    p5_8192 = 0.0f;
+    p6_2e29 = 0.0f;
+    p7_16   = 0.0f;
+    p8_2e19 = 0.0f;
+    p9_2e35 = 0.0f;
+
+    h1_2e19 = 0.0f;
+    h2_2e16 = 0.0f;
+    h3_2e26 = 0.0f;
+    h4_64   = 0.0f;
+    h5_2e14 = 0.0f;
+    h6_2e26 = 0.0f;
+
+    loaded = false;
+}
+
+/*
+ * PreparedFloatCalibration::PreparedFloatCalibration(const PreparedCalibration& pc)
+ *
+ * Description:
+ *   Constructor. Rounds prepared double coefficients to float.
+ *
+ * Parameters:
+ *   pc - prepared double coefficients
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_data.hpp
+ */
+PreparedFloatCalibration::PreparedFloatCalibration(const PreparedCalibration& pc)
+{
+    t1_1024 = (float)pc.t1_1024;
+    t1_8192 = (float)pc.t1_8192;
+    t2      = (float)pc.t2;
+    t3      = (float)pc.t3;
+
+    p1      = (float)pc.p1;
+    p2_2e34 = (float)pc.p2_2e34;
+    p3_2e53 = (float)pc.p3_2e53;
+    p4_16   = (float)pc.p4_16;
+    p5_8192 = (float)pc.p5_8192;
+    p6_2e29 = (float)pc.p6_2e29;
+    p7_16   = (float)pc.p7_16;
+    p8_2e19 = (float)pc.p8_2e19;
+    p9_2e35 = (float)pc.p9_2e35;
+
+    h1_2e19 = (float)pc.h1_2e19;
+    h2_2e16 = (float)pc.h2_2e16;
+    h3_2e26 = (float)pc.h3_2e26;
+    h4_64   = (float)pc.h4_64;
+    h5_2e14 = (float)pc.h5_2e14;
+    h6_2e26 = (float)pc.h6_2e26;
+
+    loaded = pc.loaded;
+}
+
 /*
  * TPH32SensorData::TPH32SensorData()
  *
  * Description:
- *   Constructor. Initializes the timestamp to the present moment.
+ *   Constructor. Zeroes all members. Times are filled in when data
+ *   is read, so construction costs no clock reads.
  *
  * Namespace:
  *   bosch_bme280
@@ -74,7 +297,10 @@ CalParams::CalParams()
  */
 TPH32SensorData::TPH32SensorData()
 {
-    timestamp   = time(nullptr);
+    timestamp   = 0;
+    xfer_start  = 0;
+    xfer_end    = 0;
+    sampled     = 0;
     temperature = 0;
     pressure    = 0;
     humidity    = 0;
@@ -84,7 +310,8 @@ TPH32SensorData::TPH32SensorData()
  * TPH32CompData::TPH32CompData()
  *
  * Description:
- *   Constructor. Initializes the timestamp to the present moment.
+ *   Constructor. Zeroes all members. Times are filled in when data
+ *   is read, so construction costs no clock reads.
  *
  * Namespace:
  *   bosch_bme280
@@ -94,17 +321,20 @@ TPH32SensorData::TPH32SensorData()
  */
 TPH32CompData::TPH32CompData()
 {
-    timestamp   = time(nullptr);
+    timestamp   = 0;
+    sampled     = 0;
     temperature = 0;
     pressure    = 0;
     humidity    = 0;
+    tfine       = 0;
 }
 
 /*
  * TPHDoubleCompData::TPHDoubleCompData()
  *
  * Description:
- *   Constructor. Initializes the timestamp to the present moment.
+ *   Constructor. Zeroes all members. Times are filled in when data
+ *   is read, so construction costs no clock reads.
  *
  * Namespace:
  *   bosch_bme280
@@ -114,11 +344,69 @@ TPH32CompData::TPH32CompData()
  */
 TPHDoubleCompData::TPHDoubleCompData()
 {
-    timestamp   = time(nullptr);
+    timestamp   = 0;
+    sampled     = 0;
     temperature = 0.0;
     pressure    = 0.0;
     humidity    = 0.0;
+    tfine       = 0;
+}
+
+/*
+ * TPHFloatCompData::TPHFloatCompData()
+ *
+ * Description:
+ *   Constructor. Zeroes all members. Times are filled in when data
+ *   is read, so construction costs no clock reads.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_data.hpp
+ */
+TPHFloatCompData::TPHFloatCompData()
+{
+    timestamp   = 0;
+    sampled     = 0;
+    temperature = 0.0f;
+    pressure    = 0.0f;
+    humidity    = 0.0f;
+    tfine       = 0;
+}
+
+/*
+ * void* AlignedAlloc(size_t size)
+ * void  AlignedFree(void* ptr)
+ *
+ * Description:
+ *   Heap allocation aligned for PreparedCalibration, for the class
+ *   operator new and operator new[] of types that hold one. Before
+ *   C++17, a plain new expression does not honor alignment beyond
+ *   that of max_align_t.
+ *
+ * Exceptions:
+ *   AlignedAlloc throws std::bad_alloc if memory is exhausted.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_data.hpp
+ */
+void* AlignedAlloc(size_t size)
+{
+    void* ptr = nullptr;
+
+    if (posix_memalign(&ptr, alignof(PreparedCalibration), size ? size : 1) != 0)
+        throw bad_alloc();
+
+    return ptr;
+}
+
+void AlignedFree(void* ptr)
+{
+    free(ptr);
 }
 
 } // namespace bosch_bme280
-```
@@ -1,4 +1,3 @@
-```
 /*
  * bme280_data.hpp
  *
@@ -14,12 +13,28 @@
 
 
 #include <chrono>            // time_t
-#include <stdint.h>          // uint16_t, int16_t
+#include <stddef.h>          // size_t
+#include <stdint.h>          // uint16_t, int16_t, int64_t
 
 
 namespace bosch_bme280
 {
 
+/*
+ * enum Channel
+ *
+ * Description:
+ *   Measurement channels, for code that handles temperature,
+ *   pressure, and humidity alike.
+ */
+enum Channel
+{
+    CH_TEMPERATURE = 0,
+    CH_PRESSURE,
+    CH_HUMIDITY,
+    CH_COUNT
+};
+
 /*
  * struct CalParams
  *
@@ -60,8 +75,113 @@ struct CalParams
     bool loaded;
 
     CalParams();
+    CalParams(const uint8_t* tpcal, const uint8_t* hucal);
+};
+
+/*
+ * struct PreparedCalibration
+ *
+ * Description:
+ *   Calibration parameters for double floating-point compensation,
+ *   converted to double once, with the constant power-of-two scale
+ *   factors of the compensation formulas already folded in. Scaling
+ *   by a power of two is exact, so pressure and humidity results
+ *   match the unprepared formulas bit for bit. Temperature is scaled
+ *   by 1/5120, which is not a power of two, and may differ by one
+ *   unit in the last place.
+ *
+ *   Members are grouped by channel and the structure is aligned to a
+ *   64-byte cache line. Built by BME280::LoadCalParams().
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_data.hpp
+ */
+struct alignas(64) PreparedCalibration
+{
+    // Temperature
+    double  t1_1024;        // t1 / 1024
+    double  t1_8192;        // t1 / 8192
+    double  t2;
+    double  t3;
+
+    // Pressure
+    double  p1;
+    double  p2_2e34;        // p2 / 2^34
+    double  p3_2e53;        // p3 / 2^53
+    double  p4_16;          // p4 * 16
+    double  p5_8192;        // p5 / 8192
+    double  p6_2e29;        // p6 / 2^29
+    double  p7_16;          // p7 / 16
+    double  p8_2e19;        // p8 / 2^19
+    double  p9_2e35;        // p9 / 2^35
+
+    // Humidity
+    double  h1_2e19;        // h1 / 2^19
+    double  h2_2e16;        // h2 / 2^16
+    double  h3_2e26;        // h3 / 2^26
+    double  h4_64;          // h4 * 64
+    double  h5_2e14;        // h5 / 2^14
+    double  h6_2e26;        // h6 / 2^26
+
+    bool loaded;
+
+    PreparedCalibration();
+    PreparedCalibration(const CalParams& cp);
+};
+
+/*
+ * struct PreparedFloatCalibration
+ *
+ * Description:
+ *   Single-precision counterpart of PreparedCalibration, for float
+ *   compensation. Coefficients carry the same power-of-two scale
+ *   factors as their double equivalents.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_data.hpp
+ */
+struct alignas(64) PreparedFloatCalibration
+{
+    // Temperature
+    float  t1_1024;         // t1 / 1024
+    float  t1_8192;         // t1 / 8192
+    float  t2;
+    float  t3;
+
+    // Pressure
+    float  p1;
+    float  p2_2e34;         // p2 / 2^34
+    float  p3_2e53;         // p3 / 2^53
+    float  p4_16;           // p4 * 16
+    float  p5_8192;         // p5 / 8192
+    float  p6_2e29;         // p6 / 2^29
+    float  p7_16;           // p7 / 16
+    float  p8_2e19;         // p8 / 2^19
+    float  p9_2e35;         // p9 / 2^35
+
+    // Humidity
+    float  h1_2e19;         // h1 / 2^19
+    float  h2_2e16;         // h2 / 2^16
+    float  h3_2e26;         // h3 / 2^26
+    float  h4_64;           // h4 * 64
+    float  h5_2e14;         // h5 / 2^14
+    float  h6_2e26;         // h6 / 2^26
+
+    bool loaded;
+
+    PreparedFloatCalibration();
+    PreparedFloatCalibration(const PreparedCalibration& pc);
 };
 
+void* AlignedAlloc ( size_t size );
+void  AlignedFree  ( void* ptr );
+
 /*
  * struct SensorData
  *
@@ -69,6 +189,12 @@ struct CalParams
  *   A structure for BME280 uncompensated temperature, pressure,
  *   and humidity data.
  *
+ *   Times are steady_clock nanoseconds. xfer_start and xfer_end
+ *   bracket the bus transfer that read the data; sampled is the
+ *   driver's estimate of when the conversion took place, see
+ *   BME280::GetSensorData(). timestamp is sampled converted to wall
+ *   clock seconds.
+ *
  * Namespace:
  *   bosch_bme280
  *
@@ -77,7 +203,11 @@ struct CalParams
  */
 struct TPH32SensorData
 {
-    time_t  timestamp;
+    time_t  timestamp;        // wall clock, seconds
+
+    int64_t xfer_start;       // steady_clock, ns, data read begins
+    int64_t xfer_end;         // steady_clock, ns, data read ends
+    int64_t sampled;          // steady_clock, ns, conversion midpoint
 
     uint32_t  temperature;
     uint32_t  pressure;
@@ -92,7 +222,9 @@ struct TPH32SensorData
  *
  * Description:
  *   A structure for 32-bit, fixed-point compensated temperature,
- *   pressure, and humidity data.
+ *   pressure, and humidity data. Also carries the tfine value that
+ *   was used to compensate pressure and humidity, and the sample
+ *   time of the raw data.
  *
  * Namespace:
  *   bosch_bme280
@@ -102,12 +234,15 @@ struct TPH32SensorData
  */
 struct TPH32CompData
 {
-    time_t timestamp;
+    time_t  timestamp;
+    int64_t sampled;
 
     int32_t temperature;
     int32_t pressure;
     int32_t humidity;
 
+    int32_t tfine;
+
     TPH32CompData ( );
 };
 
@@ -118,7 +253,9 @@ struct TPH32CompData
  * Description:
  * Description:
  *   A structure for double floating-point compensated temperature,
- *   pressure, and humidity data.
+ *   pressure, and humidity data. Also carries the tfine value that
+ *   was used to compensate pressure and humidity, and the sample
+ *   time of the raw data.
  *
  * Namespace:
  *   bosch_bme280
@@ -128,17 +265,49 @@ struct TPH32CompData
  */
 struct TPHDoubleCompData
 {
-    time_t timestamp;
+    time_t  timestamp;
+    int64_t sampled;
 
     double temperature;
     double pressure;
     double humidity;
 
+    int32_t tfine;
+
     TPHDoubleCompData ( );
 };
 
 
+/*
+ * struct TPHFloatCompData
+ *
+ * Description:
+ *   A structure for single-precision floating-point compensated
+ *   temperature, pressure, and humidity data. Also carries the tfine
+ *   value that was used to compensate pressure and humidity, and the
+ *   sample time of the raw data.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_data.hpp
+ */
+struct TPHFloatCompData
+{
+    time_t  timestamp;
+    int64_t sampled;
+
+    float temperature;
+    float pressure;
+    float humidity;
+
+    int32_t tfine;
+
+    TPHFloatCompData ( );
+};
+
+
 } // namespace bosch_bme280
 
 #endif /* BME280_DATA_HPP_ */
-```
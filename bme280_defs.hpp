@@ -46,6 +46,7 @@
 // PTH Data Registers, Indexed
 #define BME280_DATA_START    0xF7
 #define BME280_DATA_SIZE        8
+#define BME280_STATDATA_SIZE   12  // status through hum_lsb, 0xF3 - 0xFE
 
 #define BME280_PMSB_NDX         0
 #define BME280_PLSB_NDX         1
@@ -144,6 +145,9 @@
 #define BME280_CAL_H5H_NDX      5
 #define BME280_CAL_H6_NDX       6
 
+// Raw Calibration, as kept by the driver: TPCAL bytes, then HUCAL bytes
+#define BME280_CAL_SIZE        33    // BME280_TPCAL_SIZE + BME280_HUCAL_SIZE
+
 
 
 // Configuration Settings, by Register
@@ -218,12 +222,46 @@
 
 
 // Status Register (0xF3) Mask
-#define BME280_STATUS_MSK    0x09  // 0000_1001
+#define BME280_STATUS_MSK        0x09  // 0000_1001
+#define BME280_STATUS_MEASURING  0x08  // 0000_1000  conversion running
+#define BME280_STATUS_IM_UPDATE  0x01  // 0000_0001  NVM data being copied
+#define BME280_POLL_INTERVAL      100  // Status poll interval, in microseconds.
 
 // Reset
 #define BME280_CMD_RESET     0xB6  // Reset command.
-#define BME280_RESET_DELAY      3  // Reset delay, in milliseconds.
-#define BME280_CONFIG_DELAY    43  // Configuration delay, in milliseconds.
+#define BME280_RESET_DELAY      3  // Longest wait for a reset, in milliseconds.
+#define BME280_CONFIG_DELAY    43  // Longest wait after configuration, in milliseconds.
+#define BME280_NVM_TIMEOUT     10  // NVM copy time limit after a reset, in milliseconds.
+#define BME280_NVM_MIN_DELAY 2000  // Wait after reset before the first status poll, in microseconds.
+#define BME280_XFER_RETRIES     1  // Retries after a failed bus transfer.
+
+// Streaming
+#define BME280_STREAM_DEPTH  1024  // Stream ring buffer capacity, in samples.
+#define BME280_STREAM_SLACK   500  // Wake-up lead ahead of a conversion end, in microseconds.
+
+// Capture Log
+#define BME280_LOG_VERSION      1  // Capture file format version.
+#define BME280_LOG_CHUNK    65536  // File growth step, in records.
+#define BME280_LOG_COMMIT     256  // Default records per automatic commit.
+
+// Replay
+#define BME280_REPLAY_CHUNK 65536  // Default records per replay task.
+#define BME280_REPLAY_BLOCK   256  // Records per compensation pass.
+
+// Archive
+#define BME280_ARCHIVE_VERSION  1  // Archive file format version.
+#define BME280_ARCHIVE_BLOCK 1024  // Samples per compressed block.
+
+// Rollups
+#define BME280_ROLLUP_SECONDS 3600  // 1 s buckets kept:  one hour.
+#define BME280_ROLLUP_MINUTES 1440  // 1 min buckets kept: one day.
+#define BME280_ROLLUP_HOURS    744  // 1 h buckets kept:  31 days.
+
+// SPI Interface
+#define BME280_SPI_READ      0x80  // Control byte bit 7: 1 = read, 0 = write.
+#define BME280_SPI_ADDR_MSK  0x7F  // Control byte register address bits.
+#define BME280_SPI_HZ    10000000  // Default SPI clock, in Hz (device maximum).
+#define BME280_SPI_MAX_XFER    64  // Largest single transfer, in bytes.
 
 
 
@@ -0,0 +1,910 @@
+/*
+ * bme280_emu.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    An in-process BME280 emulator.
+ *
+ *  Notes:
+ *    1. Measurement time is the data sheet typical value, see
+ *       MeasureTimeTyp() in bme280_time.cpp.
+ *    2. Noise is Gaussian, specified in raw LSB at 1x oversampling,
+ *       and is reduced by the square root of the oversampling ratio.
+ */
+
+
+#include <chrono>            // steady_clock, microseconds
+#include <errno.h>           // errno, EBADF, EIO, ENOTTY, ENXIO
+#include <cmath>             // sqrt, lround
+#include <fstream>           // ifstream
+#include <stdexcept>         // runtime_error, invalid_argument
+#include <string.h>          // memset, memcpy
+
+#include "bme280_emu.hpp"
+#include "bme280_time.hpp"
+
+
+using namespace std;
+using namespace std::chrono;
+
+
+// Emulator Defaults
+// --------------------------------
+// Raw values and calibration are the example values from the data
+// sheet, which compensate to about 25.08 degC and 100653 Pa. The
+// humidity calibration and raw value give about 55 %RH.
+#define BME280_EMU_UT        519888
+#define BME280_EMU_UP        415148
+#define BME280_EMU_UH         30000
+
+#define BME280_EMU_NVM_US      2000  // NVM copy after reset, microseconds
+
+static const uint8_t emu_tpcal[BME280_TPCAL_SIZE] =
+{
+    0x70, 0x6B, 0x43, 0x67, 0x18, 0xFC,     // t1 .. t3
+    0x7D, 0x8E, 0x43, 0xD6, 0xD0, 0x0B,     // p1 .. p3
+    0x27, 0x0B, 0x8C, 0x00, 0xF9, 0xFF,     // p4 .. p6
+    0x8C, 0x3C, 0xF8, 0xC6, 0x70, 0x17,     // p7 .. p9
+    0x00, 0x4B                              // (unused), h1
+};
+
+static const uint8_t emu_hucal[BME280_HUCAL_SIZE] =
+{
+    0x6A, 0x01, 0x00, 0x13, 0x29, 0x03, 0x1E  // h2 .. h6
+};
+
+// IIR filter coefficient, by filter register value.
+static const int emu_filter[8] = { 0, 2, 4, 8, 16, 16, 16, 16 };
+
+
+
+namespace bosch_bme280
+{
+
+// BME280Emulator Constructor
+// -----------------------------------------------------------------
+
+/*
+ * BME280Emulator::BME280Emulator(uint8_t addr)
+ *
+ * Description:
+ *   Constructor. Loads the default calibration ROM and raw values,
+ *   with no noise, and performs a power-on reset.
+ *
+ * Parameters:
+ *   addr - Optional. I2C address that Xfer() and Write() respond to.
+ *          Default value is BME280_I2C0.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+BME280Emulator::BME280Emulator(uint8_t addr) : gauss(0.0, 1.0)
+{
+    i2caddr  = addr;
+    unctemp  = BME280_EMU_UT;
+    uncpress = BME280_EMU_UP;
+    unchum   = BME280_EMU_UH;
+    noise_t  = 0.0;
+    noise_p  = 0.0;
+    noise_h  = 0.0;
+
+    memset(regs, 0, sizeof(regs));
+    memcpy(&regs[BME280_TPCAL_START], emu_tpcal, BME280_TPCAL_SIZE);
+    memcpy(&regs[BME280_HUCAL_START], emu_hucal, BME280_HUCAL_SIZE);
+
+    this->PowerOnReset();
+}
+
+
+
+// BME280Emulator Protected
+// -----------------------------------------------------------------
+
+/*
+ * void BME280Emulator::PowerOnReset()
+ *
+ * Description:
+ *   Sets control, status, and data registers to their reset values
+ *   and starts the NVM copy. Calibration registers are untouched.
+ */
+void BME280Emulator::PowerOnReset()
+{
+    regs[BME280_R_ID]       = BME280_ID;
+    regs[BME280_R_CTRL_HUM] = 0x00;
+    regs[BME280_R_STAT]     = 0x00;
+    regs[BME280_R_CTRL_MEA] = 0x00;
+    regs[BME280_R_CONF]     = 0x00;
+
+    regs[BME280_R_PMSB]  = 0x80;
+    regs[BME280_R_PLSB]  = 0x00;
+    regs[BME280_R_PXLSB] = 0x00;
+    regs[BME280_R_TMSB]  = 0x80;
+    regs[BME280_R_TLSB]  = 0x00;
+    regs[BME280_R_TXLSB] = 0x00;
+    regs[BME280_R_HMSB]  = 0x80;
+    regs[BME280_R_HLSB]  = 0x00;
+
+    osrs_h     = 0;
+    filt_valid = false;
+    measuring  = false;
+    nvm_end    = clock::now() + microseconds(BME280_EMU_NVM_US);
+}
+
+/*
+ * clock::duration BME280Emulator::MeasureTime() const
+ *
+ * Description:
+ *   Typical measurement time for the active oversampling settings.
+ */
+BME280Emulator::clock::duration BME280Emulator::MeasureTime() const
+{
+    return microseconds(MeasureTimeTyp(osrs_h, regs[BME280_R_CTRL_MEA]));
+}
+
+/*
+ * clock::duration BME280Emulator::StandbyTime() const
+ *
+ * Description:
+ *   Normal mode inactive duration (t_sb) for the active config.
+ */
+BME280Emulator::clock::duration BME280Emulator::StandbyTime() const
+{
+    return microseconds(bosch_bme280::StandbyTime(regs[BME280_R_CONF]));
+}
+
+/*
+ * void BME280Emulator::StartMeasure(clock::time_point start)
+ *
+ * Description:
+ *   Begins a measurement cycle at the given time.
+ */
+void BME280Emulator::StartMeasure(clock::time_point start)
+{
+    measuring = true;
+    meas_end  = start + this->MeasureTime();
+}
+
+/*
+ * uint32_t BME280Emulator::Sample(uint32_t value, double sigma, int osrs, uint32_t bits)
+ *
+ * Description:
+ *   Returns one noisy conversion of a raw value, limited to the
+ *   register width.
+ */
+uint32_t BME280Emulator::Sample(uint32_t value, double sigma, int osrs, uint32_t bits)
+{
+    double v = (double)value;
+
+    if (sigma > 0.0)
+        v += gauss(rng) * sigma / sqrt((double)osrs);
+
+    double vmax = (double)((1UL << bits) - 1);
+    if (v < 0.0)  v = 0.0;
+    if (v > vmax) v = vmax;
+
+    return (uint32_t)lround(v);
+}
+
+/*
+ * void BME280Emulator::Complete()
+ *
+ * Description:
+ *   Finishes a measurement: converts each enabled channel, applies
+ *   the IIR filter to temperature and pressure, and updates the data
+ *   registers.
+ */
+void BME280Emulator::Complete()
+{
+    int ost = OversampleRatio((regs[BME280_R_CTRL_MEA] & BME280_OSRS_T_MSK) >> 5);
+    int osp = OversampleRatio((regs[BME280_R_CTRL_MEA] & BME280_OSRS_P_MSK) >> 2);
+    int osh = OversampleRatio(osrs_h & BME280_OSRS_H_MSK);
+    int fc  = emu_filter[(regs[BME280_R_CONF] & BME280_FILTER_MSK) >> 2];
+
+    uint32_t t = 0x80000;
+    uint32_t p = 0x80000;
+    uint32_t h = 0x8000;
+
+    double st = ost ? (double)this->Sample(unctemp,  noise_t, ost, 20) : 0.0;
+    double sp = osp ? (double)this->Sample(uncpress, noise_p, osp, 20) : 0.0;
+
+    if (fc && filt_valid)
+    {
+        filt_t = (filt_t * (fc - 1) + st) / fc;
+        filt_p = (filt_p * (fc - 1) + sp) / fc;
+    }
+    else
+    {
+        filt_t = st;
+        filt_p = sp;
+    }
+    filt_valid = true;
+
+    if (ost) t = (uint32_t)lround(filt_t);
+    if (osp) p = (uint32_t)lround(filt_p);
+    if (osh) h = this->Sample(unchum, noise_h, osh, 16);
+
+    regs[BME280_R_PMSB]  = (uint8_t)(p >> 12);
+    regs[BME280_R_PLSB]  = (uint8_t)(p >>  4);
+    regs[BME280_R_PXLSB] = (uint8_t)(p <<  4);
+    regs[BME280_R_TMSB]  = (uint8_t)(t >> 12);
+    regs[BME280_R_TLSB]  = (uint8_t)(t >>  4);
+    regs[BME280_R_TXLSB] = (uint8_t)(t <<  4);
+    regs[BME280_R_HMSB]  = (uint8_t)(h >>  8);
+    regs[BME280_R_HLSB]  = (uint8_t)(h);
+
+    measuring = false;
+}
+
+/*
+ * void BME280Emulator::Advance(clock::time_point now)
+ *
+ * Description:
+ *   Brings the device state up to the given time: completes a
+ *   measurement that has run its course, returns a forced-mode
+ *   device to sleep, and runs normal-mode cycles that have elapsed
+ *   since the last access.
+ */
+void BME280Emulator::Advance(clock::time_point now)
+{
+    for (;;)
+    {
+        uint8_t mode = regs[BME280_R_CTRL_MEA] & BME280_MODE_MSK;
+
+        if (measuring)
+        {
+            if (now < meas_end)
+                break;
+
+            this->Complete();
+
+            if (mode == BME280_MODE_NORMAL)
+                next_start = meas_end + this->StandbyTime();
+            else
+                regs[BME280_R_CTRL_MEA] &= BME280_MODE_MSK_OUT;
+        }
+        else if (mode == BME280_MODE_NORMAL && now >= next_start)
+        {
+            this->StartMeasure(next_start);
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    uint8_t stat = 0;
+    if (measuring)     stat |= BME280_STATUS_MEASURING;
+    if (now < nvm_end) stat |= BME280_STATUS_IM_UPDATE;
+    regs[BME280_R_STAT] = stat;
+}
+
+/*
+ * void BME280Emulator::WriteReg(uint8_t regaddr, uint8_t value, clock::time_point now)
+ *
+ * Description:
+ *   Applies a write to a single register. Only the control, config,
+ *   and reset registers are writable.
+ */
+void BME280Emulator::WriteReg(uint8_t regaddr, uint8_t value, clock::time_point now)
+{
+    switch (regaddr)
+    {
+    case BME280_R_RESET:
+        if (value == BME280_CMD_RESET)
+            this->PowerOnReset();
+        break;
+
+    case BME280_R_CTRL_HUM:
+        regs[BME280_R_CTRL_HUM] = value & BME280_OSRS_H_MSK;
+        break;
+
+    case BME280_R_CONF:
+        regs[BME280_R_CONF] = value;
+        break;
+
+    case BME280_R_CTRL_MEA:
+        regs[BME280_R_CTRL_MEA] = value;
+        osrs_h = regs[BME280_R_CTRL_HUM];
+
+        if (measuring)
+            break;
+
+        if ((value & BME280_MODE_MSK) == BME280_MODE_FORCED ||
+            (value & BME280_MODE_MSK) == 0x02)
+        {
+            regs[BME280_R_CTRL_MEA] = (value & BME280_MODE_MSK_OUT) | BME280_MODE_FORCED;
+            this->StartMeasure(now);
+        }
+        else if ((value & BME280_MODE_MSK) == BME280_MODE_NORMAL)
+        {
+            this->StartMeasure(now);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+
+// BME280Emulator Public
+// -----------------------------------------------------------------
+
+/*
+ * void BME280Emulator::LoadCalibration(const std::string& path)
+ *
+ * Description:
+ *   Loads the calibration ROM from a file. The file holds the 26
+ *   bytes that the device keeps at 0x88 - 0xA1, followed by the 7
+ *   bytes at 0xE1 - 0xE7, the same bytes that BME280::LoadCalParams()
+ *   reads.
+ *
+ * Parameters:
+ *   path - calibration file path
+ *
+ * Exceptions:
+ *   Throws std::runtime_error if the file cannot be opened or is too
+ *   short.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+void BME280Emulator::LoadCalibration(const string& path)
+{
+    uint8_t cal[BME280_TPCAL_SIZE + BME280_HUCAL_SIZE];
+
+    ifstream calfile(path.c_str(), ios::in | ios::binary);
+    if (!calfile)
+        throw runtime_error("BME280Emulator: cannot open " + path);
+
+    calfile.read((char*)cal, sizeof(cal));
+    if (calfile.gcount() != (streamsize)sizeof(cal))
+        throw runtime_error("BME280Emulator: short calibration file " + path);
+
+    this->SetCalibration(cal, cal + BME280_TPCAL_SIZE);
+}
+
+/*
+ * void BME280Emulator::SetCalibration(const uint8_t* tpcal, const uint8_t* hucal)
+ *
+ * Description:
+ *   Loads the calibration ROM from memory.
+ *
+ * Parameters:
+ *   tpcal - BME280_TPCAL_SIZE bytes, for 0x88 - 0xA1
+ *   hucal - BME280_HUCAL_SIZE bytes, for 0xE1 - 0xE7
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+void BME280Emulator::SetCalibration(const uint8_t* tpcal, const uint8_t* hucal)
+{
+    lock_guard<mutex> lock(mtx);
+
+    memcpy(&regs[BME280_TPCAL_START], tpcal, BME280_TPCAL_SIZE);
+    memcpy(&regs[BME280_HUCAL_START], hucal, BME280_HUCAL_SIZE);
+}
+
+/*
+ * void BME280Emulator::SetRawValues(uint32_t temp, uint32_t press, uint32_t hum)
+ *
+ * Description:
+ *   Sets the noise-free raw values that subsequent conversions
+ *   report.
+ *
+ * Parameters:
+ *   temp  - 20-bit raw temperature
+ *   press - 20-bit raw pressure
+ *   hum   - 16-bit raw humidity
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+void BME280Emulator::SetRawValues(uint32_t temp, uint32_t press, uint32_t hum)
+{
+    lock_guard<mutex> lock(mtx);
+
+    unctemp  = temp  & 0xFFFFF;
+    uncpress = press & 0xFFFFF;
+    unchum   = hum   & 0xFFFF;
+}
+
+/*
+ * void BME280Emulator::SetNoise(double temp, double press, double hum, unsigned seed)
+ *
+ * Description:
+ *   Sets the measurement noise model.
+ *
+ * Parameters:
+ *   temp  - temperature noise standard deviation, raw LSB at 1x
+ *   press - pressure noise standard deviation, raw LSB at 1x
+ *   hum   - humidity noise standard deviation, raw LSB at 1x
+ *   seed  - Optional. Random number generator seed.
+ *           Default value is 1.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+void BME280Emulator::SetNoise(double temp, double press, double hum, unsigned seed)
+{
+    lock_guard<mutex> lock(mtx);
+
+    noise_t = temp;
+    noise_p = press;
+    noise_h = hum;
+    rng.seed(seed);
+}
+
+/*
+ * void BME280Emulator::Read(uint8_t regaddr, uint8_t* data, int len)
+ *
+ * Description:
+ *   Reads one or more consecutive registers. As on the device, the
+ *   address increments after each byte.
+ *
+ * Parameters:
+ *   regaddr - address of the first register to be read
+ *   data    - pointer to a buffer that will receive data
+ *   len     - the number of bytes to read
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+void BME280Emulator::Read(uint8_t regaddr, uint8_t* data, int len)
+{
+    lock_guard<mutex> lock(mtx);
+
+    this->Advance(clock::now());
+
+    for (int i = 0; i < len; i++)
+        data[i] = regs[(uint8_t)(regaddr + i)];
+
+    stats.reads++;
+    stats.bytes_read += len;
+}
+
+/*
+ * void BME280Emulator::Write(const uint8_t* data, int len)
+ *
+ * Description:
+ *   Writes to one or more registers. Outgoing bytes are organized in
+ *   {address, data} pairs.
+ *
+ * Parameters:
+ *   data - pointer to {address, data} pairs
+ *   len  - the total number of bytes
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+void BME280Emulator::Write(const uint8_t* data, int len)
+{
+    lock_guard<mutex> lock(mtx);
+
+    clock::time_point now = clock::now();
+    this->Advance(now);
+
+    for (int i = 0; i + 1 < len; i += 2)
+        this->WriteReg(data[i], data[i + 1], now);
+
+    stats.writes++;
+    stats.bytes_written += len;
+}
+
+/*
+ * EmuStats BME280Emulator::GetStats()
+ *
+ * Description:
+ *   Returns the bus activity counters. Dividing the transaction
+ *   count by the number of readings taken gives bus transactions
+ *   per reading.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+EmuStats BME280Emulator::GetStats()
+{
+    lock_guard<mutex> lock(mtx);
+
+    return stats;
+}
+
+/*
+ * void BME280Emulator::ResetStats()
+ *
+ * Description:
+ *   Clears the bus activity counters.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+void BME280Emulator::ResetStats()
+{
+    lock_guard<mutex> lock(mtx);
+
+    stats = EmuStats();
+}
+
+/*
+ * void BME280Emulator::Xfer(uint8_t* outbuff, int outlen, uint8_t* inbuff,
+ *                           int inlen, uint8_t addr)
+ *
+ * Description:
+ *   I2CBus-compatible write-then-read transfer. The first outgoing
+ *   byte is taken as the register address.
+ *
+ * Exceptions:
+ *   Throws std::runtime_error if addr does not match the emulated
+ *   device.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+void BME280Emulator::Xfer(uint8_t* outbuff, int outlen, uint8_t* inbuff, int inlen, uint8_t addr)
+{
+    if (addr != i2caddr || outlen < 1)
+        throw runtime_error("BME280Emulator: no device at address");
+
+    this->Read(outbuff[0], inbuff, inlen);
+}
+
+/*
+ * void BME280Emulator::Write(uint8_t* data, int len, uint8_t addr)
+ *
+ * Description:
+ *   I2CBus-compatible write.
+ *
+ * Exceptions:
+ *   Throws std::runtime_error if addr does not match the emulated
+ *   device.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+void BME280Emulator::Write(uint8_t* data, int len, uint8_t addr)
+{
+    if (addr != i2caddr)
+        throw runtime_error("BME280Emulator: no device at address");
+
+    this->Write((const uint8_t*)data, len);
+}
+
+/*
+ * void BME280Emulator::SpiFrame(const uint8_t* tx, uint8_t* rx, int len,
+ *                               bool threewire)
+ *
+ * Description:
+ *   One SPI transaction, from chip select low to chip select high.
+ *   The first byte is the control byte. With bit 7 set, the device
+ *   returns consecutive registers for the remaining bytes; with bit 7
+ *   clear, the frame is {control, data} pairs.
+ *
+ *   Bytes the device does not drive read as 0xFF: the control byte,
+ *   every byte of a write, and every byte of a read when threewire
+ *   does not match the config register spi3w_en bit.
+ *
+ * Parameters:
+ *   tx        - bytes sent by the master
+ *   rx        - receives the bytes returned
+ *   len       - frame length, in bytes
+ *   threewire - true if the master is wired for 3-wire SPI
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+void BME280Emulator::SpiFrame(const uint8_t* tx, uint8_t* rx, int len, bool threewire)
+{
+    if (len < 1) return;
+
+    lock_guard<mutex> lock(mtx);
+
+    clock::time_point now = clock::now();
+    this->Advance(now);
+
+    memset(rx, 0xFF, len);
+
+    if (tx[0] & BME280_SPI_READ)
+    {
+        bool driven = ((regs[BME280_R_CONF] & BME280_SPI3W_MSK) != 0) == threewire;
+
+        if (driven)
+            for (int i = 1; i < len; i++)
+                rx[i] = regs[(uint8_t)(tx[0] + i - 1)];
+
+        stats.reads++;
+        stats.bytes_read += len - 1;
+    }
+    else
+    {
+        for (int i = 0; i + 1 < len; i += 2)
+            this->WriteReg(tx[i] | BME280_SPI_READ, tx[i + 1], now);
+
+        stats.writes++;
+        stats.bytes_written += len;
+    }
+}
+
+
+
+// EmuSpiPort
+// -----------------------------------------------------------------
+
+/*
+ * void EmuSpiPort::Message(struct spi_ioc_transfer* xfers, int n)
+ *
+ * Description:
+ *   Carries out one spidev message against the emulator.
+ *
+ * Parameters:
+ *   xfers - message segments
+ *   n     - number of segments
+ *
+ * Exceptions:
+ *   Throws std::invalid_argument if a frame is longer than
+ *   2 * BME280_SPI_MAX_XFER bytes.
+ *   Throws std::runtime_error for a full-duplex segment on a 3-wire
+ *   port.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+void EmuSpiPort::Message(struct spi_ioc_transfer* xfers, int n)
+{
+    uint8_t tx[2 * BME280_SPI_MAX_XFER];
+    uint8_t rx[2 * BME280_SPI_MAX_XFER];
+    int     first = 0;
+    int     pos   = 0;
+
+    for (int k = 0; k < n; k++)
+    {
+        const struct spi_ioc_transfer& x = xfers[k];
+
+        if (pos + (int)x.len > (int)sizeof(tx))
+            throw invalid_argument("EmuSpiPort::Message(): frame too long");
+        if (spi3w && x.tx_buf && x.rx_buf)
+            throw runtime_error("EmuSpiPort::Message(): full-duplex transfer on a 3-wire bus");
+
+        if (x.tx_buf)
+            memcpy(&tx[pos], (const uint8_t*)(uintptr_t)x.tx_buf, x.len);
+        else
+            memset(&tx[pos], 0, x.len);
+        pos += x.len;
+
+        if (x.cs_change || k == n - 1)
+        {
+            emu->SpiFrame(tx, rx, pos, spi3w);
+
+            for (int j = first, off = 0; j <= k; off += xfers[j].len, j++)
+                if (xfers[j].rx_buf)
+                    memcpy((uint8_t*)(uintptr_t)xfers[j].rx_buf, &rx[off], xfers[j].len);
+
+            first = k + 1;
+            pos   = 0;
+        }
+    }
+}
+
+
+
+// EmuI2CSys
+// -----------------------------------------------------------------
+
+// The one descriptor EmuI2CSys hands out.
+static const int emu_fd = 0x280;
+
+/*
+ * int EmuI2CSys::Open(const char* path, int flags)
+ *
+ * Description:
+ *   Mock open(). Any path opens.
+ *
+ * Returns:
+ *   Returns the emulator's file descriptor.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+int EmuI2CSys::Open(const char* path, int flags)
+{
+    (void)path;
+    (void)flags;
+
+    return emu_fd;
+}
+
+/*
+ * int EmuI2CSys::Ioctl(int fd, unsigned long request, void* arg)
+ *
+ * Description:
+ *   Mock ioctl(), for I2C_FUNCS and I2C_RDWR. Messages of an I2C_RDWR
+ *   call are carried out in order; a failing message ends the call.
+ *
+ * Returns:
+ *   Returns zero (I2C_FUNCS) or the number of messages (I2C_RDWR), or
+ *   -1 with errno set.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+int EmuI2CSys::Ioctl(int fd, unsigned long request, void* arg)
+{
+    calls++;
+
+    if (fd != emu_fd)
+    {
+        errno = EBADF;
+        return -1;
+    }
+
+    if (failures > 0)
+    {
+        failures--;
+        errno = EIO;
+        return -1;
+    }
+
+    if (request == I2C_FUNCS)
+    {
+        *(unsigned long*)arg = I2C_FUNC_I2C;
+        return 0;
+    }
+
+    if (request != I2C_RDWR)
+    {
+        errno = ENOTTY;
+        return -1;
+    }
+
+    struct i2c_rdwr_ioctl_data* rdwr = (struct i2c_rdwr_ioctl_data*)arg;
+
+    try
+    {
+        for (uint32_t i = 0; i < rdwr->nmsgs; i++)
+        {
+            struct i2c_msg& msg = rdwr->msgs[i];
+
+            if (msg.flags & I2C_M_RD)
+            {
+                emu->Xfer(&regptr, 1, msg.buf, msg.len, (uint8_t)msg.addr);
+                regptr += msg.len;
+            }
+            else if (msg.len == 1)
+            {
+                // Register pointer only. No register is read or
+                // written, so the emulator does not count it.
+                if ((uint8_t)msg.addr != emu->Address())
+                    throw runtime_error("EmuI2CSys: no device at address");
+                regptr = msg.buf[0];
+            }
+            else
+            {
+                emu->Write(msg.buf, msg.len, (uint8_t)msg.addr);
+            }
+        }
+    }
+    catch (const runtime_error&)
+    {
+        errno = ENXIO;
+        return -1;
+    }
+
+    return (int)rdwr->nmsgs;
+}
+
+/*
+ * int EmuI2CSys::Close(int fd)
+ *
+ * Description:
+ *   Mock close().
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+int EmuI2CSys::Close(int fd)
+{
+    (void)fd;
+
+    return 0;
+}
+
+
+
+// EmulatedBME280
+// -----------------------------------------------------------------
+
+/*
+ * EmulatedBME280::EmulatedBME280(BME280Emulator* emulator)
+ *
+ * Description:
+ *   Constructor. Attaches the driver to an emulator. The driver has
+ *   no I2C bus.
+ *
+ * Parameters:
+ *   emulator - pointer to a BME280Emulator
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+EmulatedBME280::EmulatedBME280(BME280Emulator* emulator)
+  : BME280(nullptr, BME280_I2C0)
+{
+    emu = emulator;
+}
+
+/*
+ * void EmulatedBME280::GetRegs(uint8_t regaddr, uint8_t* data, int len)
+ *
+ * Description:
+ *   Reads consecutive emulator registers.
+ */
+void EmulatedBME280::GetRegs(uint8_t regaddr, uint8_t* data, int len)
+{
+    emu->Read(regaddr, data, len);
+}
+
+/*
+ * void EmulatedBME280::SetRegs(uint8_t* data, int len)
+ *
+ * Description:
+ *   Writes {address, data} pairs to the emulator.
+ */
+void EmulatedBME280::SetRegs(uint8_t* data, int len)
+{
+    emu->Write((const uint8_t*)data, len);
+}
+
+} // namespace bosch_bme280
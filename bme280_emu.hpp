@@ -0,0 +1,323 @@
+/*
+ * bme280_emu.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    An in-process BME280 emulator, for running the driver without
+ *    hardware.
+ *
+ *    BME280Emulator models the register map (0x88 - 0xFE), the
+ *    calibration ROM, the status register, forced and normal mode
+ *    conversion timing, the IIR filter, and measurement noise.
+ *    Conversions run against the steady clock, so a forced reading
+ *    is available only after the datasheet's typical measurement
+ *    time has elapsed.
+ *
+ *    EmulatedBME280 is a BME280 whose register accesses are routed
+ *    to an emulator instead of an I2C bus. EmuTransport and
+ *    EmuSpiPort attach an emulator to BME280Dev, directly or through
+ *    the SPI framing of bme280_spi.hpp. EmuI2CSys stands in for the
+ *    i2c-dev system calls of I2CRdwrTransport.
+ */
+
+#ifndef BME280_EMU_HPP_
+#define BME280_EMU_HPP_
+
+#include <chrono>            // steady_clock
+#include <mutex>             // mutex
+#include <random>            // mt19937, normal_distribution
+#include <stdint.h>          // uint8_t, uint32_t, uint64_t
+#include <string>            // string
+
+#include "bme280.hpp"
+#include "bme280_spi.hpp"
+#include "bme280_transport.hpp"
+
+
+namespace bosch_bme280
+{
+
+/*
+ * struct EmuStats
+ *
+ * Description:
+ *   Bus activity seen by a BME280Emulator. A transaction is one
+ *   Read() or Write() call, which corresponds to one I2C transfer
+ *   on real hardware.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+struct EmuStats
+{
+    uint64_t  reads;
+    uint64_t  writes;
+    uint64_t  bytes_read;
+    uint64_t  bytes_written;
+
+    EmuStats ( ) : reads(0), writes(0), bytes_read(0), bytes_written(0) { }
+};
+
+/*
+ * class BME280Emulator
+ *
+ * Description:
+ *   Emulates one BME280. Register reads and writes follow the I2C
+ *   conventions of the device: a read returns consecutive registers
+ *   starting at a given address, and a write consists of {address,
+ *   data} pairs.
+ *
+ *   Xfer() and Write() have the same signatures as the I2CBus
+ *   functions, so the emulator can stand in for a bus with a single
+ *   device at a fixed address. SpiFrame() takes one SPI transaction.
+ *
+ *   All public functions are thread safe.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+class BME280Emulator
+{
+
+  protected:
+
+	typedef std::chrono::steady_clock  clock;
+
+	std::mutex mtx;
+
+	uint8_t  i2caddr;
+	uint8_t  regs[256];
+
+	uint8_t  osrs_h;             // ctrl_hum, latched by a ctrl_meas write
+
+	uint32_t unctemp;            // noise-free raw values
+	uint32_t uncpress;
+	uint32_t unchum;
+
+	double   noise_t;            // noise standard deviation, in LSB at 1x
+	double   noise_p;
+	double   noise_h;
+
+	double   filt_t;             // IIR filter state
+	double   filt_p;
+	bool     filt_valid;
+
+	bool               measuring;
+	clock::time_point  meas_end;      // end of the current measurement
+	clock::time_point  next_start;    // normal mode: start of the next one
+	clock::time_point  nvm_end;       // end of the NVM copy after reset
+
+	std::mt19937                      rng;
+	std::normal_distribution<double>  gauss;
+
+	EmuStats stats;
+
+	void      PowerOnReset ();
+	void      Advance      ( clock::time_point now );
+	void      Complete     ();
+	void      StartMeasure ( clock::time_point start );
+	uint32_t  Sample       ( uint32_t value, double sigma, int osrs, uint32_t bits );
+	void      WriteReg     ( uint8_t regaddr, uint8_t value, clock::time_point now );
+
+	clock::duration  MeasureTime () const;
+	clock::duration  StandbyTime () const;
+
+  public:
+
+	BME280Emulator ( uint8_t addr = BME280_I2C0 );
+
+	void  LoadCalibration ( const std::string& path );
+	void  SetCalibration  ( const uint8_t* tpcal, const uint8_t* hucal );
+	void  SetRawValues    ( uint32_t temp, uint32_t press, uint32_t hum );
+	void  SetNoise        ( double temp, double press, double hum, unsigned seed = 1 );
+
+	void  Read  ( uint8_t regaddr, uint8_t* data, int len );
+	void  Write ( const uint8_t* data, int len );
+
+	EmuStats  GetStats   ();
+	void      ResetStats ();
+
+	uint8_t  Address () const { return i2caddr; }
+
+	void  Xfer  ( uint8_t* outbuff, int outlen, uint8_t* inbuff, int inlen, uint8_t addr );
+	void  Write ( uint8_t* data, int len, uint8_t addr );
+
+	void  SpiFrame ( const uint8_t* tx, uint8_t* rx, int len, bool threewire );
+
+}; // class BME280Emulator
+
+
+/*
+ * class EmulatedBME280
+ *
+ * Description:
+ *   A BME280 driver attached to a BME280Emulator rather than to an
+ *   I2C bus.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+class EmulatedBME280 : public BME280
+{
+
+  protected:
+
+	BME280Emulator* emu;
+
+	void  GetRegs  ( uint8_t regaddr, uint8_t* data, int len );
+	void  SetRegs  ( uint8_t* data, int len );
+
+  public:
+
+	EmulatedBME280 ( BME280Emulator* emulator );
+
+}; // class EmulatedBME280
+
+/*
+ * class EmuTransport
+ *
+ * Description:
+ *   Transport policy for BME280Dev (bme280_transport.hpp) that reads
+ *   and writes emulator registers directly. The emulator is not
+ *   owned.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+class EmuTransport
+{
+
+  protected:
+
+	BME280Emulator* emu;
+	uint8_t         i2caddr;
+
+  public:
+
+	EmuTransport ( BME280Emulator* emulator, uint8_t addr = BME280_I2C0 )
+	  : emu(emulator), i2caddr(addr) { }
+
+	void Read ( uint8_t regaddr, uint8_t* data, int len )
+	{
+	    emu->Read(regaddr, data, len);
+	}
+
+	void Write ( uint8_t* data, int len )
+	{
+	    emu->Write((const uint8_t*)data, len);
+	}
+
+	void ReadWrite ( uint8_t regaddr, uint8_t* data, int len, uint8_t* wdata, int wlen )
+	{
+	    emu->Read(regaddr, data, len);
+	    emu->Write((const uint8_t*)wdata, wlen);
+	}
+
+	uint8_t Address () const { return i2caddr; }
+
+}; // class EmuTransport
+
+/*
+ * class EmuSpiPort
+ *
+ * Description:
+ *   SpiTransport port (bme280_spi.hpp) that delivers spidev messages
+ *   to an emulator, in userspace. Segments are joined into one chip
+ *   select frame until a segment with cs_change set. As with spidev,
+ *   a 3-wire port rejects segments that both send and receive.
+ *
+ *   The emulated device drives its data line only when the wiring
+ *   matches its spi3w_en bit; otherwise reads return 0xFF.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+class EmuSpiPort
+{
+
+  protected:
+
+	BME280Emulator* emu;
+	bool            spi3w;
+	uint32_t        speed;
+
+  public:
+
+	EmuSpiPort ( BME280Emulator* emulator, bool threewire = false,
+	             uint32_t hz = BME280_SPI_HZ )
+	  : emu(emulator), spi3w(threewire), speed(hz) { }
+
+	void  Message ( struct spi_ioc_transfer* xfers, int n );
+
+	bool      ThreeWire () const { return spi3w; }
+	uint32_t  Speed     () const { return speed; }
+
+}; // class EmuSpiPort
+
+typedef SpiTransport<EmuSpiPort>  EmuSpiTransport;
+
+/*
+ * class EmuI2CSys
+ *
+ * Description:
+ *   Mock system call layer for I2CRdwrTransport (bme280_transport.hpp).
+ *   Open() hands out one fake descriptor, and Ioctl() carries out
+ *   I2C_FUNCS and I2C_RDWR against an emulator: a one-byte write
+ *   message sets the register pointer, a longer one writes {address,
+ *   data} pairs, and a read message reads from the pointer.
+ *
+ *   Calls() counts Ioctl() calls. Fail(n) makes the next n calls fail
+ *   with EIO. A message for another address fails with ENXIO.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_emu.hpp
+ */
+class EmuI2CSys
+{
+
+  protected:
+
+	BME280Emulator* emu;
+	uint8_t         regptr;
+	uint64_t        calls;
+	unsigned        failures;
+
+  public:
+
+	EmuI2CSys ( BME280Emulator* emulator )
+	  : emu(emulator), regptr(0), calls(0), failures(0) { }
+
+	int  Open  ( const char* path, int flags );
+	int  Ioctl ( int fd, unsigned long request, void* arg );
+	int  Close ( int fd );
+
+	uint64_t  Calls () const { return calls; }
+	void      Fail  ( unsigned n ) { failures = n; }
+
+}; // class EmuI2CSys
+
+typedef I2CRdwrTransport<EmuI2CSys>  EmuRdwrTransport;
+
+} // namespace bosch_bme280
+
+#endif /* BME280_EMU_HPP_ */
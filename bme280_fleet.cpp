@@ -0,0 +1,440 @@
+/*
+ * bme280_fleet.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Management of several BME280s spread across several I2C buses.
+ *
+ *  Notes:
+ *    1. Discovery probes BME280_I2C0 and BME280_I2C1 on each bus. An
+ *       address that does not acknowledge makes the transfer throw,
+ *       and an address that answers with a chip id other than
+ *       BME280_ID belongs to some other device. Either way it is
+ *       skipped.
+ *    2. A sample is a burst read on the bus worker followed by double
+ *       compensation on the pool, using calibration that was loaded
+ *       at discovery. The pool never touches a bus.
+ */
+
+
+#include <exception>         // exception_ptr, current_exception
+#include <memory>            // make_shared, shared_ptr
+#include <mutex>             // lock_guard
+
+#include "bme280_comp.hpp"
+#include "bme280_fleet.hpp"
+#include "bme280_time.hpp"
+
+
+using namespace std;
+
+
+namespace bosch_bme280
+{
+
+// BME280Fleet Constructor, Destructor
+// -----------------------------------------------------------------
+
+/*
+ * BME280Fleet::BME280Fleet(unsigned compthreads)
+ *
+ * Description:
+ *   Constructor. Starts the compensation pool. Buses are added with
+ *   AddBus().
+ *
+ * Parameters:
+ *   compthreads - Optional. Number of compensation threads; zero
+ *                 selects one per hardware thread.
+ *                 Default value is 0.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_fleet.hpp
+ */
+BME280Fleet::BME280Fleet(unsigned compthreads)
+  : pool(compthreads)
+{ }
+
+/*
+ * BME280Fleet::~BME280Fleet()
+ *
+ * Description:
+ *   Destructor. Completes outstanding samples, stops the workers,
+ *   and releases the devices.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_fleet.hpp
+ */
+BME280Fleet::~BME280Fleet()
+{ }
+
+
+// BME280Fleet Protected
+// -----------------------------------------------------------------
+
+/*
+ * std::unique_ptr<BME280> BME280Fleet::CreateDevice(I2CBus* bus, uint8_t addr)
+ *
+ * Description:
+ *   Creates the driver object for a device that may be present at
+ *   the given bus and address. Override to attach a different
+ *   BME280 subclass.
+ *
+ * Parameters:
+ *   bus  - the bus being probed
+ *   addr - the address being probed
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_fleet.hpp
+ */
+unique_ptr<BME280> BME280Fleet::CreateDevice(I2CBus* bus, uint8_t addr)
+{
+    return unique_ptr<BME280>(new BME280(bus, addr));
+}
+
+
+// BME280Fleet Public
+// -----------------------------------------------------------------
+
+/*
+ * size_t BME280Fleet::AddBus(I2CBus* bus)
+ *
+ * Description:
+ *   Starts a worker for the bus and discovers the BME280s on it.
+ *   Each device found has its chip id read and its calibration
+ *   loaded.
+ *
+ * Parameters:
+ *   bus - the I2C bus. Must outlive the fleet, and must not be used
+ *         other than through the fleet.
+ *
+ * Returns:
+ *   Returns the number of devices found on the bus.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_fleet.hpp
+ */
+size_t BME280Fleet::AddBus(I2CBus* bus)
+{
+    Bus b;
+    b.bus    = bus;
+    b.worker = unique_ptr<WorkQueue>(new WorkQueue(1));
+
+    const uint8_t addrs[] { BME280_I2C0, BME280_I2C1 };
+
+    future<vector<unique_ptr<BME280>>> found = b.worker->Submit([this, bus, &addrs]
+    {
+        vector<unique_ptr<BME280>> devs;
+
+        for (uint8_t addr : addrs)
+        {
+            unique_ptr<BME280> dev = this->CreateDevice(bus, addr);
+
+            try
+            {
+                if (dev->ReadChipId() != BME280_ID)
+                    continue;
+
+                dev->LoadCalParams();
+            }
+            catch (const exception&)
+            {
+                continue;
+            }
+
+            devs.push_back(move(dev));
+        }
+
+        return devs;
+    });
+
+    vector<unique_ptr<BME280>> devs = found.get();
+
+    size_t busid = buses.size();
+    buses.push_back(move(b));
+
+    for (size_t i = 0; i < devs.size(); i++)
+    {
+        Member m;
+        m.dev = move(devs[i]);
+        m.bus = busid;
+
+        members.push_back(move(m));
+    }
+
+    return devs.size();
+}
+
+/*
+ * size_t BME280Fleet::Count() const
+ *
+ * Description:
+ *   Returns the number of devices discovered.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_fleet.hpp
+ */
+size_t BME280Fleet::Count() const
+{
+    return members.size();
+}
+
+/*
+ * size_t BME280Fleet::BusCount() const
+ *
+ * Description:
+ *   Returns the number of buses added.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_fleet.hpp
+ */
+size_t BME280Fleet::BusCount() const
+{
+    return buses.size();
+}
+
+/*
+ * BME280* BME280Fleet::Device(size_t id)
+ *
+ * Description:
+ *   Returns a device. Direct calls on it bypass its bus worker, so
+ *   they must hold the device mutex and should be rare.
+ *
+ * Parameters:
+ *   id - device number, 0 to Count() - 1
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_fleet.hpp
+ */
+BME280* BME280Fleet::Device(size_t id)
+{
+    return members.at(id).dev.get();
+}
+
+/*
+ * size_t BME280Fleet::BusOf(size_t id) const
+ *
+ * Description:
+ *   Returns the number of the bus a device was found on.
+ *
+ * Parameters:
+ *   id - device number, 0 to Count() - 1
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_fleet.hpp
+ */
+size_t BME280Fleet::BusOf(size_t id) const
+{
+    return members.at(id).bus;
+}
+
+/*
+ * void BME280Fleet::ApplyConfig(const Config& cfg)
+ *
+ * Description:
+ *   Applies a configuration to every device. Buses are configured
+ *   in parallel. Returns when all devices are done.
+ *
+ * Parameters:
+ *   cfg - the new configuration
+ *
+ * Exceptions:
+ *   Rethrows the first exception raised by a device.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_fleet.hpp
+ */
+void BME280Fleet::ApplyConfig(const Config& cfg)
+{
+    vector<future<bool>> done;
+
+    for (size_t id = 0; id < members.size(); id++)
+    {
+        BME280* dev = members[id].dev.get();
+
+        done.push_back(buses[members[id].bus].worker->Submit([dev, cfg]
+        {
+            lock_guard<mutex> lock(dev->mtx);
+            return dev->ApplyConfig(cfg);
+        }));
+    }
+
+    for (size_t i = 0; i < done.size(); i++)
+        done[i].get();
+}
+
+/*
+ * StartupReport BME280Fleet::Start(const Config& cfg)
+ *
+ * Description:
+ *   Resets, calibrates, and configures every device. Each bus worker
+ *   runs StartDevices() over its own devices, so startup is
+ *   interleaved within a bus and parallel across buses. Returns when
+ *   all devices are done.
+ *
+ * Parameters:
+ *   cfg - configuration to apply
+ *
+ * Returns:
+ *   Returns device counts and status polls summed over the buses,
+ *   and the total elapsed time.
+ *
+ * Exceptions:
+ *   Throws std::invalid_argument if cfg.IsValid() is false.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_fleet.hpp
+ *   bme280_startup.hpp
+ */
+StartupReport BME280Fleet::Start(const Config& cfg)
+{
+    vector<vector<BME280*>> perbus(buses.size());
+
+    for (size_t id = 0; id < members.size(); id++)
+        perbus[members[id].bus].push_back(members[id].dev.get());
+
+    int64_t start = SteadyNanos();
+
+    vector<future<StartupReport>> done;
+    for (size_t b = 0; b < buses.size(); b++)
+    {
+        vector<BME280*> devs = perbus[b];
+        done.push_back(buses[b].worker->Submit([devs, cfg]
+        {
+            return StartDevices(devs, cfg);
+        }));
+    }
+
+    StartupReport total;
+    for (size_t i = 0; i < done.size(); i++)
+    {
+        StartupReport sr = done[i].get();
+        total.devices += sr.devices;
+        total.failed  += sr.failed;
+        total.polls   += sr.polls;
+    }
+    total.seconds = (SteadyNanos() - start) / 1e9;
+
+    return total;
+}
+
+/*
+ * std::future<TPHDoubleCompData> BME280Fleet::Sample(size_t id)
+ *
+ * Description:
+ *   Reads one device's data registers on its bus worker, then
+ *   compensates the result on the pool. The calibration parameters
+ *   are copied on the bus worker, under the device lock, so the pool
+ *   never touches the device. They are prepared on the pool thread:
+ *   PreparedCalibration is cache-line aligned, and a lambda capture
+ *   of one, held by std::function on the heap, would not be.
+ *
+ *   This reads whatever the device holds, which suits normal mode.
+ *   In forced mode, trigger the measurement first.
+ *
+ * Parameters:
+ *   id - device number, 0 to Count() - 1
+ *
+ * Returns:
+ *   Returns a future for the compensated sample. A bus error is
+ *   delivered through the future.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_fleet.hpp
+ */
+future<TPHDoubleCompData> BME280Fleet::Sample(size_t id)
+{
+    Member&    m    = members.at(id);
+    BME280*    dev  = m.dev.get();
+    WorkQueue* comp = &pool;
+
+    shared_ptr<promise<TPHDoubleCompData>> result = make_shared<promise<TPHDoubleCompData>>();
+
+    buses[m.bus].worker->Post([dev, comp, result]
+    {
+        TPH32SensorData sensdat;
+        CalParams       cp;
+
+        try
+        {
+            lock_guard<mutex> lock(dev->mtx);
+            sensdat = dev->GetSensorData();
+            cp      = dev->GetCalParams();
+        }
+        catch (...)
+        {
+            result->set_exception(current_exception());
+            return;
+        }
+
+        comp->Post([cp, sensdat, result]
+        {
+            PreparedCalibration pcal(cp);
+            result->set_value(CompDoubleData(pcal, sensdat));
+        });
+    });
+
+    return result->get_future();
+}
+
+/*
+ * std::vector<std::future<TPHDoubleCompData>> BME280Fleet::SampleAll()
+ *
+ * Description:
+ *   Samples every device, as Sample(). All requests are queued
+ *   before any completes, so the buses run concurrently.
+ *
+ * Returns:
+ *   Returns one future per device, indexed by device number.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_fleet.hpp
+ */
+vector<future<TPHDoubleCompData>> BME280Fleet::SampleAll()
+{
+    vector<future<TPHDoubleCompData>> results;
+
+    for (size_t id = 0; id < members.size(); id++)
+        results.push_back(this->Sample(id));
+
+    return results;
+}
+
+} // namespace bosch_bme280
@@ -0,0 +1,112 @@
+/*
+ * bme280_fleet.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Management of several BME280s spread across several I2C buses.
+ *
+ *    Each bus is owned by one worker thread, which carries out every
+ *    transaction on that bus in turn, so devices on one bus never
+ *    contend and devices on different buses proceed in parallel.
+ *    Compensation runs on a shared thread pool, off the bus workers.
+ *
+ *  Example:
+ *    BME280Fleet fleet;
+ *    fleet.AddBus(&bus1);
+ *    fleet.AddBus(&bus2);
+ *    fleet.Start(ConfigIndoorNav);
+ *
+ *    std::vector<std::future<TPHDoubleCompData>> results = fleet.SampleAll();
+ *    for (size_t id = 0; id < results.size(); id++)
+ *        TPHDoubleCompData compdat = results[id].get();
+ */
+
+#ifndef BME280_FLEET_HPP_
+#define BME280_FLEET_HPP_
+
+#include <deque>             // deque
+#include <future>            // future
+#include <memory>            // unique_ptr
+#include <stddef.h>          // size_t
+#include <stdint.h>          // uint8_t
+#include <vector>            // vector
+
+#include "bbb-i2c.hpp"       // I2CBus
+#include "bme280.hpp"
+#include "bme280_config.hpp"
+#include "bme280_data.hpp"
+#include "bme280_startup.hpp"
+#include "bme280_work.hpp"
+
+
+namespace bosch_bme280
+{
+
+/*
+ * class BME280Fleet
+ *
+ * Description:
+ *   Discovers BME280s on a set of I2C buses and samples them.
+ *
+ *   Devices are numbered in the order they are found. AddBus() must
+ *   not be called while samples are outstanding.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_fleet.hpp
+ */
+class BME280Fleet
+{
+
+  protected:
+
+	struct Member
+	{
+	    std::unique_ptr<BME280>  dev;
+	    size_t                   bus;
+	};
+
+	struct Bus
+	{
+	    I2CBus*                     bus;
+	    std::unique_ptr<WorkQueue>  worker;
+	};
+
+	// Declaration order matters: bus workers are joined first, then
+	// the pool they post to, and only then are the devices released.
+	std::deque<Member>  members;
+	WorkQueue           pool;
+	std::vector<Bus>    buses;
+
+	virtual std::unique_ptr<BME280>  CreateDevice ( I2CBus* bus, uint8_t addr );
+
+  public:
+
+	explicit BME280Fleet ( unsigned compthreads = 0 );
+	virtual ~BME280Fleet ();
+
+	BME280Fleet ( const BME280Fleet& ) = delete;
+	BME280Fleet& operator= ( const BME280Fleet& ) = delete;
+
+	size_t  AddBus ( I2CBus* bus );
+
+	size_t   Count    () const;
+	size_t   BusCount () const;
+	BME280*  Device   ( size_t id );
+	size_t   BusOf    ( size_t id ) const;
+
+	void           ApplyConfig ( const Config& cfg );
+	StartupReport  Start       ( const Config& cfg );
+
+	std::future<TPHDoubleCompData>               Sample    ( size_t id );
+	std::vector<std::future<TPHDoubleCompData>>  SampleAll ();
+
+}; // class BME280Fleet
+
+} // namespace bosch_bme280
+
+#endif /* BME280_FLEET_HPP_ */
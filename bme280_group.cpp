@@ -0,0 +1,267 @@
+/*
+ * bme280_group.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Synchronized forced mode triggering of a group of BME280s.
+ *
+ *  Notes:
+ *    1. Device mutexes are always taken in address order, so a group
+ *       cannot deadlock against another group that shares devices.
+ *    2. The trigger loop makes no calls that could read the bus:
+ *       Prepare() loads every shadow register set beforehand.
+ */
+
+
+#include <algorithm>         // find, max, sort
+#include <chrono>            // steady_clock, nanoseconds, microseconds
+#include <mutex>             // mutex, unique_lock
+#include <stdexcept>         // invalid_argument
+#include <thread>            // this_thread
+
+#include "bme280_group.hpp"
+#include "bme280_time.hpp"
+
+
+using namespace std;
+using namespace std::chrono;
+
+
+namespace bosch_bme280
+{
+
+/*
+ * BME280Group::BME280Group()
+ *
+ * Description:
+ *   Constructor. Devices are added with Add().
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_group.hpp
+ */
+BME280Group::BME280Group()
+  : twait(0)
+{ }
+
+/*
+ * size_t BME280Group::Add(BME280* dev)
+ *
+ * Description:
+ *   Adds a device to the group. Call Prepare() after the last Add()
+ *   and after any configuration change.
+ *
+ * Parameters:
+ *   dev - a device configured for forced mode, in sleep mode
+ *
+ * Returns:
+ *   Returns the device's index in GroupSample vectors.
+ *
+ * Exceptions:
+ *   Throws std::invalid_argument if dev is null or already in the
+ *   group; Trigger() would otherwise lock its mutex twice.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_group.hpp
+ */
+size_t BME280Group::Add(BME280* dev)
+{
+    if (dev == nullptr || find(devs.begin(), devs.end(), dev) != devs.end())
+        throw invalid_argument("BME280Group::Add(): null or duplicate device");
+
+    devs.push_back(dev);
+    lockorder.push_back(devs.size() - 1);
+
+    sort(lockorder.begin(), lockorder.end(),
+         [this](size_t a, size_t b) { return devs[a] < devs[b]; });
+
+    return devs.size() - 1;
+}
+
+/*
+ * size_t BME280Group::Size() const
+ *
+ * Description:
+ *   Returns the number of devices in the group.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_group.hpp
+ */
+size_t BME280Group::Size() const
+{
+    return devs.size();
+}
+
+/*
+ * void BME280Group::Prepare()
+ *
+ * Description:
+ *   Makes sure every device has valid shadow registers, and sizes
+ *   the shared wait from the slowest device's maximum measurement
+ *   time.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_group.hpp
+ */
+void BME280Group::Prepare()
+{
+    twait = 0;
+
+    for (size_t i = 0; i < devs.size(); i++)
+    {
+        lock_guard<mutex> lock(devs[i]->mtx);
+        twait = max(twait, devs[i]->MeasureTime(true));
+    }
+}
+
+/*
+ * void BME280Group::Trigger(GroupSample& gs)
+ *
+ * Description:
+ *   Locks all devices, then starts a forced measurement on each, back
+ *   to back. Records each trigger time and the group skew.
+ *
+ * Parameters:
+ *   gs - receives trigger times and skew
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_group.hpp
+ */
+void BME280Group::Trigger(GroupSample& gs)
+{
+    if (twait == 0) this->Prepare();
+
+    gs.trigger.assign(devs.size(), clock::time_point());
+    gs.data.assign(devs.size(), TPH32SensorData());
+
+    vector<unique_lock<mutex>> locks;
+    locks.reserve(devs.size());
+
+    for (size_t i = 0; i < lockorder.size(); i++)
+        locks.push_back(unique_lock<mutex>(devs[lockorder[i]]->mtx));
+
+    for (size_t i = 0; i < devs.size(); i++)
+    {
+        devs[i]->Force();
+        gs.trigger[i] = clock::now();
+    }
+
+    locks.clear();
+
+    if (devs.empty()) return;
+
+    clock::time_point first = *min_element(gs.trigger.begin(), gs.trigger.end());
+    clock::time_point last  = *max_element(gs.trigger.begin(), gs.trigger.end());
+
+    gs.skew = duration_cast<nanoseconds>(last - first).count();
+
+    stats.groups++;
+    stats.max_skew    = max(stats.max_skew, gs.skew);
+    stats.total_skew += gs.skew;
+}
+
+/*
+ * void BME280Group::Collect(GroupSample& gs)
+ *
+ * Description:
+ *   Waits until the slowest device's maximum measurement time has
+ *   passed since the last trigger, then reads every device. A device
+ *   still measuring is polled for up to another maximum measurement
+ *   time. Each sample time is the device's trigger time plus half
+ *   its typical measurement time.
+ *
+ * Parameters:
+ *   gs - a GroupSample filled in by Trigger(); receives the data
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_group.hpp
+ */
+void BME280Group::Collect(GroupSample& gs)
+{
+    if (devs.empty()) return;
+
+    clock::time_point last = *max_element(gs.trigger.begin(), gs.trigger.end());
+    this_thread::sleep_until(last + microseconds(twait));
+
+    for (size_t i = 0; i < devs.size(); i++)
+    {
+        lock_guard<mutex> lock(devs[i]->mtx);
+
+        uint8_t status;
+        gs.data[i] = devs[i]->GetSensorData(status);
+
+        while ((status & BME280_STATUS_MEASURING) &&
+               (clock::now() < last + microseconds(2 * twait)))
+        {
+            this_thread::sleep_for(microseconds(BME280_POLL_INTERVAL));
+            gs.data[i] = devs[i]->GetSensorData(status);
+        }
+
+        gs.data[i].sampled   = duration_cast<nanoseconds>(gs.trigger[i].time_since_epoch()).count() +
+                               (int64_t)devs[i]->MeasureTime() * 500;
+        gs.data[i].timestamp = WallSeconds(gs.data[i].sampled);
+    }
+}
+
+/*
+ * GroupSample BME280Group::Sample()
+ *
+ * Description:
+ *   Triggers the group and collects the results.
+ *
+ * Returns:
+ *   Returns raw data, trigger times, and skew.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_group.hpp
+ */
+GroupSample BME280Group::Sample()
+{
+    GroupSample gs;
+
+    this->Trigger(gs);
+    this->Collect(gs);
+
+    return gs;
+}
+
+/*
+ * GroupStats BME280Group::GetStats() const
+ *
+ * Description:
+ *   Returns trigger skew statistics over all group measurements.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_group.hpp
+ */
+GroupStats BME280Group::GetStats() const
+{
+    return stats;
+}
+
+} // namespace bosch_bme280
@@ -0,0 +1,135 @@
+/*
+ * bme280_group.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Synchronized forced mode triggering of a group of BME280s.
+ *
+ *    A group trigger locks every device first, then issues the
+ *    forced mode writes back to back. Each write is built from the
+ *    device's shadow ctrl_meas, so there are no reads between them.
+ *    The completion time of each write is recorded as that device's
+ *    trigger time. After one shared wait, sized for the slowest
+ *    device, all results are collected.
+ *
+ *  Example:
+ *    BME280Group group;
+ *    group.Add(&dev1);
+ *    group.Add(&dev2);
+ *    group.Prepare();
+ *
+ *    GroupSample gs = group.Sample();
+ *    // gs.skew is the spread of trigger times, in nanoseconds
+ */
+
+#ifndef BME280_GROUP_HPP_
+#define BME280_GROUP_HPP_
+
+#include <chrono>            // steady_clock
+#include <stddef.h>          // size_t
+#include <stdint.h>          // int64_t, uint32_t, uint64_t
+#include <vector>            // vector
+
+#include "bme280.hpp"
+#include "bme280_data.hpp"
+
+
+namespace bosch_bme280
+{
+
+/*
+ * struct GroupSample
+ *
+ * Description:
+ *   The result of one group measurement. Vectors are indexed in the
+ *   order devices were added.
+ *
+ *     data    - raw samples
+ *     trigger - time at which each forced mode write completed
+ *     skew    - last trigger time minus first, in nanoseconds
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_group.hpp
+ */
+struct GroupSample
+{
+    std::vector<TPH32SensorData>                        data;
+    std::vector<std::chrono::steady_clock::time_point>  trigger;
+    int64_t                                             skew;
+
+    GroupSample ( ) : skew(0) { }
+};
+
+/*
+ * struct GroupStats
+ *
+ * Description:
+ *   Trigger skew over all group measurements, in nanoseconds.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_group.hpp
+ */
+struct GroupStats
+{
+    uint64_t  groups;
+    int64_t   max_skew;
+    int64_t   total_skew;
+
+    GroupStats ( ) : groups(0), max_skew(0), total_skew(0) { }
+};
+
+/*
+ * class BME280Group
+ *
+ * Description:
+ *   A set of forced mode devices measured together. The devices may
+ *   sit on one bus or several.
+ *
+ *   Member functions are not thread safe with respect to each other;
+ *   each device is locked through its own mutex while it is used.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_group.hpp
+ */
+class BME280Group
+{
+
+  protected:
+
+	typedef std::chrono::steady_clock  clock;
+
+	std::vector<BME280*>  devs;
+	std::vector<size_t>   lockorder;     // device indices, by address
+	uint32_t              twait;         // shared wait, microseconds
+	GroupStats            stats;
+
+  public:
+
+	BME280Group ();
+
+	size_t  Add     ( BME280* dev );
+	size_t  Size    () const;
+	void    Prepare ();
+
+	void         Trigger ( GroupSample& gs );
+	void         Collect ( GroupSample& gs );
+	GroupSample  Sample  ();
+
+	GroupStats   GetStats () const;
+
+}; // class BME280Group
+
+} // namespace bosch_bme280
+
+#endif /* BME280_GROUP_HPP_ */
@@ -0,0 +1,574 @@
+/*
+ * bme280_log.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Append-only capture log of raw BME280 samples.
+ *
+ *  Notes:
+ *    1. The committed count is an aligned 8-byte field in the first
+ *       page of the file, so its update cannot be torn. Records are
+ *       flushed (msync, MS_SYNC) before the count that covers them,
+ *       and the count is flushed before Commit() returns.
+ *    2. Commit() blocks until storage acknowledges the writes. At
+ *       high sample rates, a larger commit interval, or a writer
+ *       thread fed from a BME280Stream, keeps acquisition clear of
+ *       the flush.
+ */
+
+
+#include <algorithm>         // min
+#include <fcntl.h>           // open
+#include <stdexcept>         // runtime_error
+#include <string.h>          // memcpy, memcmp, memset
+#include <sys/mman.h>        // mmap, munmap, msync
+#include <sys/stat.h>        // fstat
+#include <unistd.h>          // close, ftruncate, sysconf
+
+#include "bme280_log.hpp"
+#include "bme280_time.hpp"
+
+
+using namespace std;
+
+
+namespace bosch_bme280
+{
+
+static const char capmagic[8] { 'B', 'M', 'E', '2', '8', '0', 'C', 'L' };
+
+
+// CaptureWriter Constructor, Destructor
+// -----------------------------------------------------------------
+
+/*
+ * CaptureWriter::CaptureWriter(const std::string& path, BME280* dev, uint32_t commit)
+ *
+ * Description:
+ *   Constructor. Creates (or truncates) a capture file and writes
+ *   its header from the device's calibration and configuration.
+ *
+ *   The device may be read to fetch calibration and shadow
+ *   registers; if it is shared, hold its mutex while constructing.
+ *
+ * Parameters:
+ *   path   - capture file path
+ *   dev    - the device the samples will come from
+ *   commit - Optional. Records per automatic commit, or zero to
+ *            commit only by calling Commit().
+ *            Default value is BME280_LOG_COMMIT.
+ *
+ * Exceptions:
+ *   Throws std::runtime_error if the file cannot be created,
+ *   mapped, or its header flushed.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+CaptureWriter::CaptureWriter(const string& path, BME280* dev, uint32_t commit)
+  : fd(-1), map(nullptr), mapsize(0), capacity(0), count(0), committed(0),
+    commit_every(commit)
+{
+    CaptureHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+
+    memcpy(hdr.magic, capmagic, sizeof(capmagic));
+    hdr.version     = BME280_LOG_VERSION;
+    hdr.header_size = sizeof(CaptureHeader);
+    hdr.record_size = sizeof(CaptureRecord);
+
+    Config cfg = dev->GetConfig();
+    hdr.chipid    = dev->GetChipId();
+    hdr.i2caddr   = dev->GetAddress();
+    hdr.ctrl_hum  = cfg.CtrlHum();
+    hdr.ctrl_meas = cfg.CtrlMeas();
+    hdr.config    = cfg.ConfReg();
+
+    dev->GetRawCalibration(hdr.calib);
+
+    hdr.wall_offset = WallOffset();
+    hdr.committed   = 0;
+
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        throw runtime_error("CaptureWriter: cannot create " + path);
+
+    try
+    {
+        this->Grow();
+    }
+    catch (...)
+    {
+        close(fd);
+        throw;
+    }
+
+    memcpy(map, &hdr, sizeof(hdr));
+
+    if (msync(map, sizeof(hdr), MS_SYNC) != 0)
+    {
+        munmap(map, mapsize);
+        close(fd);
+        throw runtime_error("CaptureWriter: cannot flush header of " + path);
+    }
+}
+
+/*
+ * CaptureWriter::~CaptureWriter()
+ *
+ * Description:
+ *   Destructor. Commits outstanding records, then trims the file to
+ *   the committed records. If the commit fails, the records it
+ *   covered are trimmed off.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+CaptureWriter::~CaptureWriter()
+{
+    if (map)
+    {
+        try
+        {
+            this->Commit();
+        }
+        catch (...)
+        {
+        }
+        munmap(map, mapsize);
+    }
+
+    if (fd >= 0)
+    {
+        // If trimming fails the unused tail stays; readers ignore it.
+        int rc = ftruncate(fd, sizeof(CaptureHeader) + committed * sizeof(CaptureRecord));
+        (void)rc;
+
+        close(fd);
+    }
+}
+
+
+// CaptureWriter Protected
+// -----------------------------------------------------------------
+
+/*
+ * CaptureHeader* CaptureWriter::Header()
+ *
+ * Description:
+ *   Returns the mapped file header.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+CaptureHeader* CaptureWriter::Header()
+{
+    return (CaptureHeader*)map;
+}
+
+/*
+ * CaptureRecord* CaptureWriter::Records()
+ *
+ * Description:
+ *   Returns the first mapped record.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+CaptureRecord* CaptureWriter::Records()
+{
+    return (CaptureRecord*)(map + sizeof(CaptureHeader));
+}
+
+/*
+ * void CaptureWriter::Grow()
+ *
+ * Description:
+ *   Extends the file by BME280_LOG_CHUNK records and maps it again.
+ *   Pages already written stay in the page cache across the remap.
+ *
+ * Exceptions:
+ *   Throws std::runtime_error if the file cannot be extended or
+ *   mapped.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+void CaptureWriter::Grow()
+{
+    uint64_t newcap  = capacity + BME280_LOG_CHUNK;
+    size_t   newsize = sizeof(CaptureHeader) + newcap * sizeof(CaptureRecord);
+
+    if (ftruncate(fd, newsize) != 0)
+        throw runtime_error("CaptureWriter: cannot extend file");
+
+    void* newmap = mmap(nullptr, newsize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (newmap == MAP_FAILED)
+        throw runtime_error("CaptureWriter: cannot map file");
+
+    if (map)
+        munmap(map, mapsize);
+
+    map      = (uint8_t*)newmap;
+    mapsize  = newsize;
+    capacity = newcap;
+}
+
+
+// CaptureWriter Public
+// -----------------------------------------------------------------
+
+/*
+ * void CaptureWriter::Append(const TPH32SensorData& sensdat)
+ *
+ * Description:
+ *   Appends one raw sample. Commits automatically every commit
+ *   interval records.
+ *
+ * Parameters:
+ *   sensdat - raw data, as returned by BME280::GetSensorData()
+ *
+ * Exceptions:
+ *   Throws std::runtime_error if the file cannot be grown, or if an
+ *   automatic commit fails. The record is kept either way.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+void CaptureWriter::Append(const TPH32SensorData& sensdat)
+{
+    if (count == capacity) this->Grow();
+
+    int64_t xfer = sensdat.xfer_end - sensdat.xfer_start;
+
+    CaptureRecord& r = this->Records()[count];
+    r.sampled     = sensdat.sampled;
+    r.temperature = sensdat.temperature;
+    r.pressure    = sensdat.pressure;
+    r.humidity    = sensdat.humidity;
+    r.xfer_ns     = (xfer < 0) ? 0 : (uint32_t)min<int64_t>(xfer, UINT32_MAX);
+
+    count++;
+
+    if (commit_every && (count - committed >= commit_every))
+        this->Commit();
+}
+
+/*
+ * void CaptureWriter::Commit()
+ *
+ * Description:
+ *   Flushes records appended since the last commit, then records
+ *   them as committed in the header and flushes the header.
+ *
+ * Exceptions:
+ *   Throws std::runtime_error if either flush fails. The committed
+ *   count, in the header and in Committed(), is then left as it was,
+ *   and a later Commit() tries again.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+void CaptureWriter::Commit()
+{
+    if (count == committed) return;
+
+    size_t page  = (size_t)sysconf(_SC_PAGESIZE);
+    size_t first = sizeof(CaptureHeader) + committed * sizeof(CaptureRecord);
+    size_t last  = sizeof(CaptureHeader) + count     * sizeof(CaptureRecord);
+
+    first &= ~(page - 1);
+    if (msync(map + first, last - first, MS_SYNC) != 0)
+        throw runtime_error("CaptureWriter: cannot flush records");
+
+    this->Header()->committed = count;
+    if (msync(map, page, MS_SYNC) != 0)
+    {
+        this->Header()->committed = committed;
+        throw runtime_error("CaptureWriter: cannot flush header");
+    }
+
+    committed = count;
+}
+
+/*
+ * uint64_t CaptureWriter::Count() const
+ *
+ * Description:
+ *   Returns the number of records appended.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+uint64_t CaptureWriter::Count() const
+{
+    return count;
+}
+
+/*
+ * uint64_t CaptureWriter::Committed() const
+ *
+ * Description:
+ *   Returns the number of records committed.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+uint64_t CaptureWriter::Committed() const
+{
+    return committed;
+}
+
+
+// CaptureReader
+// -----------------------------------------------------------------
+
+/*
+ * CaptureReader::CaptureReader(const std::string& path)
+ *
+ * Description:
+ *   Constructor. Maps a capture file and checks its header. Only
+ *   committed records are visible.
+ *
+ * Parameters:
+ *   path - capture file path
+ *
+ * Exceptions:
+ *   Throws std::runtime_error if the file cannot be opened or mapped,
+ *   or is not a capture file of this version.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+CaptureReader::CaptureReader(const string& path)
+  : map(nullptr), mapsize(0), count(0)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw runtime_error("CaptureReader: cannot open " + path);
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || ((size_t)st.st_size < sizeof(CaptureHeader)))
+    {
+        close(fd);
+        throw runtime_error("CaptureReader: short capture file " + path);
+    }
+
+    void* m = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (m == MAP_FAILED)
+        throw runtime_error("CaptureReader: cannot map " + path);
+
+    map     = (const uint8_t*)m;
+    mapsize = st.st_size;
+
+    const CaptureHeader& hdr = this->Header();
+
+    if ((memcmp(hdr.magic, capmagic, sizeof(capmagic)) != 0) ||
+        (hdr.version     != BME280_LOG_VERSION) ||
+        (hdr.header_size != sizeof(CaptureHeader)) ||
+        (hdr.record_size != sizeof(CaptureRecord)))
+    {
+        munmap((void*)map, mapsize);
+        throw runtime_error("CaptureReader: not a capture file " + path);
+    }
+
+    uint64_t fits = (mapsize - sizeof(CaptureHeader)) / sizeof(CaptureRecord);
+    count = min(hdr.committed, fits);
+}
+
+/*
+ * CaptureReader::~CaptureReader()
+ *
+ * Description:
+ *   Destructor. Unmaps the file.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+CaptureReader::~CaptureReader()
+{
+    munmap((void*)map, mapsize);
+}
+
+/*
+ * const CaptureHeader& CaptureReader::Header() const
+ *
+ * Description:
+ *   Returns the file header.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+const CaptureHeader& CaptureReader::Header() const
+{
+    return *(const CaptureHeader*)map;
+}
+
+/*
+ * uint64_t CaptureReader::Size() const
+ *
+ * Description:
+ *   Returns the number of committed records.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+uint64_t CaptureReader::Size() const
+{
+    return count;
+}
+
+/*
+ * const CaptureRecord* CaptureReader::begin() const
+ * const CaptureRecord* CaptureReader::end() const
+ *
+ * Description:
+ *   Return the first record and one past the last committed record.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+const CaptureRecord* CaptureReader::begin() const
+{
+    return (const CaptureRecord*)(map + sizeof(CaptureHeader));
+}
+
+const CaptureRecord* CaptureReader::end() const
+{
+    return this->begin() + count;
+}
+
+/*
+ * const CaptureRecord& CaptureReader::operator[](uint64_t i) const
+ *
+ * Description:
+ *   Returns record i. Not range checked.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+const CaptureRecord& CaptureReader::operator[](uint64_t i) const
+{
+    return this->begin()[i];
+}
+
+/*
+ * CalParams CaptureReader::GetCalParams() const
+ *
+ * Description:
+ *   Decodes the calibration parameters stored in the header.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+CalParams CaptureReader::GetCalParams() const
+{
+    const CaptureHeader& hdr = this->Header();
+
+    return CalParams(hdr.calib, hdr.calib + BME280_TPCAL_SIZE);
+}
+
+/*
+ * Config CaptureReader::GetConfig() const
+ *
+ * Description:
+ *   Returns the device configuration stored in the header.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+Config CaptureReader::GetConfig() const
+{
+    const CaptureHeader& hdr = this->Header();
+
+    return Config::FromRegs(hdr.ctrl_hum, hdr.ctrl_meas, hdr.config);
+}
+
+/*
+ * TPH32SensorData CaptureReader::GetSensorData(uint64_t i) const
+ *
+ * Description:
+ *   Returns record i as raw sensor data, ready for compensation.
+ *   The sample time is that of the writing process's steady clock;
+ *   the time stamp is converted with the header's wall_offset.
+ *   Transfer start and end are not kept, and read as zero.
+ *
+ * Parameters:
+ *   i - record number, less than Size()
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+TPH32SensorData CaptureReader::GetSensorData(uint64_t i) const
+{
+    const CaptureRecord& r = (*this)[i];
+
+    TPH32SensorData sensdat;
+    sensdat.sampled     = r.sampled;
+    sensdat.timestamp   = (time_t)((r.sampled + this->Header().wall_offset) / 1000000000);
+    sensdat.temperature = r.temperature;
+    sensdat.pressure    = r.pressure;
+    sensdat.humidity    = r.humidity;
+
+    return sensdat;
+}
+
+} // namespace bosch_bme280
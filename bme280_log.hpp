@@ -0,0 +1,214 @@
+/*
+ * bme280_log.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Append-only capture log of raw BME280 samples.
+ *
+ *    A capture file holds uncompensated data, so it can be
+ *    compensated again later, by any method. The file starts with a
+ *    128-byte CaptureHeader that carries the device's raw calibration
+ *    ROM bytes and its configuration registers, followed by
+ *    fixed-size 24-byte CaptureRecords. Multi-byte fields are in
+ *    host byte order (little-endian on the BeagleBone).
+ *
+ *    CaptureWriter appends through a shared memory mapping. The file
+ *    grows BME280_LOG_CHUNK records at a time. A commit flushes the
+ *    new records to storage and only then advances the committed
+ *    record count in the header, so after a crash the file holds
+ *    every record up to the last commit, and the reader ignores
+ *    anything past it.
+ *
+ *    CaptureReader maps a file read-only; records are read in place.
+ *
+ *  Example:
+ *    CaptureWriter log("/var/log/bme280.cap", &dev);
+ *    log.Append(dev.GetSensorData());
+ *    ...
+ *    CaptureReader cap("/var/log/bme280.cap");
+ *    CalParams cp = cap.GetCalParams();
+ *    for (const CaptureRecord& r : cap) { ... }
+ */
+
+#ifndef BME280_LOG_HPP_
+#define BME280_LOG_HPP_
+
+#include <stddef.h>          // size_t
+#include <stdint.h>          // uint8_t, uint32_t, uint64_t, int64_t
+#include <string>            // string
+
+#include "bme280.hpp"
+#include "bme280_config.hpp"
+#include "bme280_data.hpp"
+#include "bme280_defs.hpp"
+
+
+namespace bosch_bme280
+{
+
+/*
+ * struct CaptureHeader
+ *
+ * Description:
+ *   Capture file header.
+ *
+ *     magic       - "BME280CL"
+ *     version     - BME280_LOG_VERSION
+ *     header_size - sizeof(CaptureHeader)
+ *     record_size - sizeof(CaptureRecord)
+ *     calib       - calibration ROM bytes, see BME280::GetRawCalibration()
+ *     wall_offset - steady clock to wall clock offset, in ns, of the
+ *                   process that wrote the file
+ *     committed   - number of valid records
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+struct CaptureHeader
+{
+    char      magic[8];
+    uint32_t  version;
+    uint32_t  header_size;
+    uint32_t  record_size;
+
+    uint8_t   chipid;
+    uint8_t   i2caddr;
+    uint8_t   ctrl_hum;
+    uint8_t   ctrl_meas;
+    uint8_t   config;
+    uint8_t   reserved0[3];
+
+    uint8_t   calib[BME280_CAL_SIZE];
+    uint8_t   reserved1[3];
+
+    int64_t   wall_offset;
+    uint64_t  committed;
+
+    uint8_t   reserved2[48];
+};
+
+static_assert(sizeof(CaptureHeader) == 128, "CaptureHeader layout");
+
+/*
+ * struct CaptureRecord
+ *
+ * Description:
+ *   One raw sample.
+ *
+ *     sampled - steady clock, ns, conversion midpoint
+ *     xfer_ns - duration of the data read, in ns
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+struct CaptureRecord
+{
+    int64_t   sampled;
+    uint32_t  temperature;
+    uint32_t  pressure;
+    uint32_t  humidity;
+    uint32_t  xfer_ns;
+};
+
+static_assert(sizeof(CaptureRecord) == 24, "CaptureRecord layout");
+
+/*
+ * class CaptureWriter
+ *
+ * Description:
+ *   Creates a capture file and appends records to it. Not thread
+ *   safe; use one writer per file, from one thread.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+class CaptureWriter
+{
+
+  protected:
+
+	int       fd;
+	uint8_t*  map;
+	size_t    mapsize;
+	uint64_t  capacity;       // records the file has room for
+	uint64_t  count;          // records appended
+	uint64_t  committed;      // records committed
+	uint32_t  commit_every;
+
+	CaptureHeader*  Header  ();
+	CaptureRecord*  Records ();
+	void            Grow    ();
+
+  public:
+
+	CaptureWriter ( const std::string& path, BME280* dev, uint32_t commit=BME280_LOG_COMMIT );
+	~CaptureWriter ();
+
+	CaptureWriter ( const CaptureWriter& ) = delete;
+	CaptureWriter& operator= ( const CaptureWriter& ) = delete;
+
+	void      Append    ( const TPH32SensorData& sensdat );
+	void      Commit    ();
+	uint64_t  Count     () const;
+	uint64_t  Committed () const;
+
+}; // class CaptureWriter
+
+/*
+ * class CaptureReader
+ *
+ * Description:
+ *   Maps a capture file read-only. Records are accessed in place,
+ *   through begin()/end() or operator[], and stay valid for the
+ *   life of the reader.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_log.hpp
+ */
+class CaptureReader
+{
+
+  protected:
+
+	const uint8_t*  map;
+	size_t          mapsize;
+	uint64_t        count;
+
+  public:
+
+	CaptureReader ( const std::string& path );
+	~CaptureReader ();
+
+	CaptureReader ( const CaptureReader& ) = delete;
+	CaptureReader& operator= ( const CaptureReader& ) = delete;
+
+	const CaptureHeader&  Header () const;
+	uint64_t              Size   () const;
+
+	const CaptureRecord*  begin () const;
+	const CaptureRecord*  end   () const;
+	const CaptureRecord&  operator[] ( uint64_t i ) const;
+
+	CalParams        GetCalParams  () const;
+	Config           GetConfig     () const;
+	TPH32SensorData  GetSensorData ( uint64_t i ) const;
+
+}; // class CaptureReader
+
+} // namespace bosch_bme280
+
+#endif /* BME280_LOG_HPP_ */
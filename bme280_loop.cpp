@@ -0,0 +1,715 @@
+/*
+ * bme280_loop.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Event loop and non-blocking device operations for the BME280.
+ */
+
+
+#include <errno.h>           // errno, EINTR
+#include <stdexcept>         // runtime_error
+#include <sys/epoll.h>       // epoll_create1, epoll_ctl, epoll_wait
+#include <sys/eventfd.h>     // eventfd
+#include <sys/resource.h>    // getrusage
+#include <sys/timerfd.h>     // timerfd_create, timerfd_settime
+#include <thread>            // thread
+#include <unistd.h>          // read, write, close
+
+#include "bme280_comp.hpp"
+#include "bme280_loop.hpp"
+#include "bme280_time.hpp"
+
+
+using namespace std;
+
+
+namespace bosch_bme280
+{
+
+/*
+ * BME280Loop::BME280Loop()
+ *
+ * Description:
+ *   Constructor. Creates the epoll instance, the timerfd, and the
+ *   eventfd.
+ *
+ * Exceptions:
+ *   Throws std::runtime_error if any of them cannot be created.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_loop.hpp
+ */
+BME280Loop::BME280Loop()
+  : seq(0), armed(0), stopping(false), wakeups(0)
+{
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    tfd  = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    efd  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    struct epoll_event ev;
+    bool ok = (epfd >= 0) && (tfd >= 0) && (efd >= 0);
+
+    if (ok)
+    {
+        ev.events  = EPOLLIN;
+        ev.data.fd = tfd;
+        ok = (epoll_ctl(epfd, EPOLL_CTL_ADD, tfd, &ev) == 0);
+    }
+    if (ok)
+    {
+        ev.events  = EPOLLIN;
+        ev.data.fd = efd;
+        ok = (epoll_ctl(epfd, EPOLL_CTL_ADD, efd, &ev) == 0);
+    }
+
+    if (!ok)
+    {
+        if (epfd >= 0) close(epfd);
+        if (tfd  >= 0) close(tfd);
+        if (efd  >= 0) close(efd);
+        throw runtime_error("BME280Loop: cannot create event loop");
+    }
+}
+
+/*
+ * BME280Loop::~BME280Loop()
+ *
+ * Description:
+ *   Destructor. Pending timers and posted work are discarded.
+ */
+BME280Loop::~BME280Loop()
+{
+    close(efd);
+    close(tfd);
+    close(epfd);
+}
+
+/*
+ * void BME280Loop::Arm()
+ *
+ * Description:
+ *   Sets the timerfd for the earliest timer, if it is not already
+ *   set for it, or disarms it when there are no timers.
+ */
+void BME280Loop::Arm()
+{
+    int64_t due = timers.empty() ? 0 : timers.top().due;
+    if (due == armed) return;
+
+    if (due > 0 && due <= SteadyNanos())
+    {
+        // Already due; a zero-length epoll_wait will pick it up.
+        due = 1;
+    }
+
+    struct itimerspec its = {};
+    its.it_value.tv_sec  = due / 1000000000;
+    its.it_value.tv_nsec = due % 1000000000;
+
+    timerfd_settime(tfd, TFD_TIMER_ABSTIME, &its, nullptr);
+    armed = timers.empty() ? 0 : timers.top().due;
+}
+
+/*
+ * void BME280Loop::Wake()
+ *
+ * Description:
+ *   Wakes the loop thread from epoll_wait().
+ */
+void BME280Loop::Wake()
+{
+    uint64_t one = 1;
+    ssize_t rc = write(efd, &one, sizeof(one));
+    (void)rc;
+}
+
+/*
+ * void BME280Loop::At(int64_t due, std::function<void()> fn)
+ *
+ * Description:
+ *   Runs fn on the loop thread once the steady clock reaches due.
+ *   Timers with the same due time run in the order they were set.
+ *
+ * Parameters:
+ *   due - steady clock time, in nanoseconds
+ *   fn  - handler
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_loop.hpp
+ */
+void BME280Loop::At(int64_t due, function<void()> fn)
+{
+    Timer t;
+    t.due = (due > 0) ? due : 1;
+    t.seq = seq++;
+    t.fn  = std::move(fn);
+
+    timers.push(std::move(t));
+}
+
+/*
+ * void BME280Loop::After(uint32_t us, std::function<void()> fn)
+ *
+ * Description:
+ *   Runs fn on the loop thread after a delay.
+ *
+ * Parameters:
+ *   us - delay, in microseconds
+ *   fn - handler
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_loop.hpp
+ */
+void BME280Loop::After(uint32_t us, function<void()> fn)
+{
+    this->At(SteadyNanos() + (int64_t)us * 1000, std::move(fn));
+}
+
+/*
+ * void BME280Loop::Post(std::function<void()> fn)
+ *
+ * Description:
+ *   Runs fn on the loop thread as soon as possible. Thread safe.
+ *
+ * Parameters:
+ *   fn - handler
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_loop.hpp
+ */
+void BME280Loop::Post(function<void()> fn)
+{
+    {
+        lock_guard<mutex> lock(mtx);
+        posted.push_back(std::move(fn));
+    }
+    this->Wake();
+}
+
+/*
+ * size_t BME280Loop::Poll(int timeout_ms)
+ *
+ * Description:
+ *   Waits once for timers or posted work, then runs posted handlers
+ *   and every timer that has come due.
+ *
+ * Parameters:
+ *   timeout_ms - Optional. Longest wait, in milliseconds; -1 waits
+ *                until something is ready.
+ *                Default value is -1.
+ *
+ * Returns:
+ *   Returns the number of handlers run.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_loop.hpp
+ */
+size_t BME280Loop::Poll(int timeout_ms)
+{
+    struct epoll_event evs[2];
+    uint64_t count;
+    size_t   ran = 0;
+
+    this->Arm();
+
+    int n = epoll_wait(epfd, evs, 2, timeout_ms);
+    if (n < 0 && errno != EINTR)
+        throw runtime_error("BME280Loop: epoll_wait failed");
+
+    wakeups++;
+
+    for (int i = 0; i < n; i++)
+    {
+        ssize_t rc = read(evs[i].data.fd, &count, sizeof(count));
+        (void)rc;
+        if (evs[i].data.fd == tfd) armed = 0;
+    }
+
+    vector<function<void()>> work;
+    {
+        lock_guard<mutex> lock(mtx);
+        work.swap(posted);
+    }
+    for (size_t i = 0; i < work.size(); i++, ran++)
+        work[i]();
+
+    int64_t now = SteadyNanos();
+    while (!timers.empty() && timers.top().due <= now)
+    {
+        function<void()> fn = std::move(const_cast<Timer&>(timers.top()).fn);
+        timers.pop();
+        fn();
+        ran++;
+    }
+
+    return ran;
+}
+
+/*
+ * void BME280Loop::Run()
+ *
+ * Description:
+ *   Runs the loop on the calling thread until Stop() is called.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_loop.hpp
+ */
+void BME280Loop::Run()
+{
+    while (!stopping.load())
+        this->Poll(-1);
+
+    stopping = false;
+}
+
+/*
+ * void BME280Loop::Stop()
+ *
+ * Description:
+ *   Makes Run() return once the current handler finishes. Thread
+ *   safe.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_loop.hpp
+ */
+void BME280Loop::Stop()
+{
+    stopping = true;
+    this->Wake();
+}
+
+/*
+ * size_t BME280Loop::Timers() const
+ *
+ * Description:
+ *   Returns the number of pending timers.
+ */
+size_t BME280Loop::Timers() const
+{
+    return timers.size();
+}
+
+/*
+ * uint64_t BME280Loop::Wakeups() const
+ *
+ * Description:
+ *   Returns the number of epoll_wait() calls so far.
+ */
+uint64_t BME280Loop::Wakeups() const
+{
+    return wakeups;
+}
+
+
+
+// BME280Async
+// -----------------------------------------------------------------
+
+/*
+ * BME280Async::BME280Async(BME280Loop* evloop, BME280* device)
+ *
+ * Description:
+ *   Constructor. Neither the loop nor the device is owned.
+ *
+ * Parameters:
+ *   evloop - the event loop that runs the device's operations
+ *   device - the device
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_loop.hpp
+ */
+BME280Async::BME280Async(BME280Loop* evloop, BME280* device)
+{
+    loop = evloop;
+    dev  = device;
+}
+
+/*
+ * void BME280Async::Fail(DoneHandler done, std::exception_ptr err)
+ *
+ * Description:
+ *   Delivers an error from the loop, rather than from inside the
+ *   call that started the operation.
+ */
+void BME280Async::Fail(DoneHandler done, exception_ptr err)
+{
+    loop->At(0, [done, err]() { done(err); });
+}
+
+/*
+ * void BME280Async::Read(ReadHandler done)
+ *
+ * Description:
+ *   Starts a forced measurement. done receives the compensated
+ *   sample once the conversion completes, with the same timing and
+ *   time stamp as ForceAndRead().
+ *
+ * Parameters:
+ *   done - completion handler
+ *
+ * Initial Conditions:
+ *   The device must be configured for forced mode, in sleep mode.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_loop.hpp
+ */
+void BME280Async::Read(ReadHandler done)
+{
+    int64_t  start;
+    uint32_t ttyp, tmax;
+
+    try
+    {
+        lock_guard<mutex> lock(dev->mtx);
+
+        dev->GetCalParams();
+        dev->Force();
+        start = SteadyNanos();
+        ttyp  = dev->MeasureTime();
+        tmax  = dev->MeasureTime(true);
+    }
+    catch (...)
+    {
+        exception_ptr err = current_exception();
+        this->Fail([done](exception_ptr e) { done(TPHDoubleCompData(), e); }, err);
+        return;
+    }
+
+    loop->At(start + (int64_t)ttyp * 1000,
+             [this, start, ttyp, tmax, done]() { this->PollReady(start, ttyp, tmax, done); });
+}
+
+/*
+ * void BME280Async::PollReady(int64_t start, uint32_t ttyp, uint32_t tmax,
+ *                             ReadHandler done)
+ *
+ * Description:
+ *   Reads status and data in one burst, and copies the calibration
+ *   under the same lock. While the measuring bit is set, and the
+ *   maximum measurement time has not passed, polls again after
+ *   BME280_POLL_INTERVAL.
+ */
+void BME280Async::PollReady(int64_t start, uint32_t ttyp, uint32_t tmax, ReadHandler done)
+{
+    TPHDoubleCompData compdat;
+
+    try
+    {
+        uint8_t             status;
+        TPH32SensorData     sensdat;
+        PreparedCalibration pcal;
+        {
+            lock_guard<mutex> lock(dev->mtx);
+            sensdat = dev->GetSensorData(status);
+            pcal    = dev->GetPreparedCalibration();
+        }
+
+        if ((status & BME280_STATUS_MEASURING) &&
+            (SteadyNanos() < start + (int64_t)tmax * 1000))
+        {
+            loop->After(BME280_POLL_INTERVAL,
+                        [this, start, ttyp, tmax, done]() { this->PollReady(start, ttyp, tmax, done); });
+            return;
+        }
+
+        compdat = CompDoubleData(pcal, sensdat);
+        compdat.sampled   = start + (int64_t)ttyp * 500;
+        compdat.timestamp = WallSeconds(compdat.sampled);
+    }
+    catch (...)
+    {
+        done(TPHDoubleCompData(), current_exception());
+        return;
+    }
+
+    done(compdat, nullptr);
+}
+
+/*
+ * void BME280Async::Reset(DoneHandler done)
+ *
+ * Description:
+ *   Resets the device. As Reset(), status is first polled after
+ *   BME280_NVM_MIN_DELAY, then every BME280_POLL_INTERVAL until the
+ *   NVM copy is done. done receives a std::runtime_error if the copy
+ *   has not finished BME280_NVM_TIMEOUT after the reset.
+ *
+ * Parameters:
+ *   done - completion handler
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_loop.hpp
+ */
+void BME280Async::Reset(DoneHandler done)
+{
+    try
+    {
+        lock_guard<mutex> lock(dev->mtx);
+        dev->BeginReset();
+    }
+    catch (...)
+    {
+        this->Fail(done, current_exception());
+        return;
+    }
+
+    int64_t due = SteadyNanos() + (int64_t)BME280_NVM_TIMEOUT * 1000000;
+
+    loop->After(BME280_NVM_MIN_DELAY, [this, due, done]() { this->PollReset(due, done); });
+}
+
+/*
+ * void BME280Async::PollReset(int64_t due, DoneHandler done)
+ *
+ * Description:
+ *   Reads the status register. While the NVM copy is running, or the
+ *   read fails, and due has not passed, polls again after
+ *   BME280_POLL_INTERVAL.
+ */
+void BME280Async::PollReset(int64_t due, DoneHandler done)
+{
+    bool busy = true;
+
+    try
+    {
+        lock_guard<mutex> lock(dev->mtx);
+        busy = (dev->ReadStatus() & BME280_STATUS_IM_UPDATE) != 0;
+    }
+    catch (...)
+    {
+        // A device coming out of reset may not answer at once.
+    }
+
+    if (!busy)
+    {
+        done(nullptr);
+        return;
+    }
+
+    if (SteadyNanos() >= due)
+    {
+        done(make_exception_ptr(runtime_error("BME280Async::Reset(): NVM copy did not finish")));
+        return;
+    }
+
+    loop->After(BME280_POLL_INTERVAL, [this, due, done]() { this->PollReset(due, done); });
+}
+
+/*
+ * void BME280Async::Configure(const Config& cfg, DoneHandler done)
+ *
+ * Description:
+ *   Applies a configuration, as ApplyConfig(). Configuration writes
+ *   take effect at once and need no settle time, as for SetConfig(),
+ *   so done runs on the next loop pass. In normal mode, the first
+ *   measurement is ready after MeasureTime(true).
+ *
+ * Parameters:
+ *   cfg  - the new configuration
+ *   done - completion handler
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_loop.hpp
+ */
+void BME280Async::Configure(const Config& cfg, DoneHandler done)
+{
+    try
+    {
+        lock_guard<mutex> lock(dev->mtx);
+        dev->ApplyConfig(cfg);
+    }
+    catch (...)
+    {
+        this->Fail(done, current_exception());
+        return;
+    }
+
+    loop->After(0, [done]() { done(nullptr); });
+}
+
+
+
+// Benchmarks
+// -----------------------------------------------------------------
+
+// Context switches of the whole process so far.
+static void ContextSwitches(uint64_t& voluntary, uint64_t& involuntary)
+{
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+
+    voluntary   = ru.ru_nvcsw;
+    involuntary = ru.ru_nivcsw;
+}
+
+/*
+ * LoopBench BenchBlocking(const std::vector<BME280*>& devs, unsigned rounds)
+ *
+ * Description:
+ *   Reads every device rounds times with the blocking API, one thread
+ *   per device calling ForceAndRead().
+ *
+ * Parameters:
+ *   devs   - devices, configured for forced mode
+ *   rounds - samples per device
+ *
+ * Returns:
+ *   Returns thread count, elapsed time, and context switches.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_loop.hpp
+ */
+LoopBench BenchBlocking(const vector<BME280*>& devs, unsigned rounds)
+{
+    LoopBench lb;
+    uint64_t  vol0, invol0;
+    atomic<uint64_t> samples(0);
+
+    ContextSwitches(vol0, invol0);
+    int64_t start = SteadyNanos();
+
+    vector<thread> threads;
+    for (size_t i = 0; i < devs.size(); i++)
+    {
+        BME280* dev = devs[i];
+        threads.push_back(thread([dev, rounds, &samples]()
+        {
+            for (unsigned r = 0; r < rounds; r++)
+            {
+                lock_guard<mutex> lock(dev->mtx);
+                dev->ForceAndRead();
+                samples++;
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    lb.seconds = (SteadyNanos() - start) / 1e9;
+    ContextSwitches(lb.voluntary, lb.involuntary);
+    lb.voluntary   -= vol0;
+    lb.involuntary -= invol0;
+
+    lb.devices = devs.size();
+    lb.threads = devs.size();
+    lb.samples = samples;
+
+    return lb;
+}
+
+/*
+ * LoopBench BenchEventLoop(const std::vector<BME280*>& devs, unsigned rounds)
+ *
+ * Description:
+ *   Reads every device rounds times with BME280Async, all on the
+ *   calling thread. Each device starts its next read as soon as the
+ *   last one completes.
+ *
+ * Parameters:
+ *   devs   - devices, configured for forced mode
+ *   rounds - samples per device
+ *
+ * Returns:
+ *   Returns thread count, elapsed time, and context switches.
+ *
+ * Exceptions:
+ *   Rethrows the first read error.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_loop.hpp
+ */
+LoopBench BenchEventLoop(const vector<BME280*>& devs, unsigned rounds)
+{
+    LoopBench lb;
+    uint64_t  vol0, invol0;
+
+    BME280Loop          loop;
+    vector<BME280Async> adevs;
+    vector<unsigned>    left(devs.size(), rounds);
+    size_t              active = 0;
+    exception_ptr       failure;
+
+    for (size_t i = 0; i < devs.size(); i++)
+        adevs.push_back(BME280Async(&loop, devs[i]));
+
+    function<void(size_t)> next = [&](size_t i)
+    {
+        adevs[i].Read([&, i](const TPHDoubleCompData&, exception_ptr err)
+        {
+            if (err && !failure) failure = err;
+            lb.samples++;
+
+            if (--left[i] > 0 && !failure)
+                next(i);
+            else if (--active == 0)
+                loop.Stop();
+        });
+    };
+
+    ContextSwitches(vol0, invol0);
+    int64_t start = SteadyNanos();
+
+    if (rounds > 0)
+    {
+        for (size_t i = 0; i < devs.size(); i++, active++)
+            next(i);
+        if (active > 0)
+            loop.Run();
+    }
+
+    lb.seconds = (SteadyNanos() - start) / 1e9;
+    ContextSwitches(lb.voluntary, lb.involuntary);
+    lb.voluntary   -= vol0;
+    lb.involuntary -= invol0;
+
+    if (failure) rethrow_exception(failure);
+
+    lb.devices = devs.size();
+    lb.threads = 1;
+
+    return lb;
+}
+
+} // namespace bosch_bme280
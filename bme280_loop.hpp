@@ -0,0 +1,331 @@
+/*
+ * bme280_loop.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Single-threaded, non-blocking operation of many BME280s.
+ *
+ *    BME280Loop is an event loop on epoll. Timers are kept in a heap
+ *    and share one timerfd, armed for the earliest; an eventfd lets
+ *    other threads post work. BME280Async wraps one device and turns
+ *    each blocking wait of the driver into a loop timer:
+ *
+ *      Read()      - Force(), a timer for the typical measurement
+ *                    time, then status polls until the sample is
+ *                    ready, as ForceAndRead()
+ *      Reset()     - BeginReset(), then status polls until the NVM
+ *                    copy is done, as Reset()
+ *      Configure() - ApplyConfig(); configuration writes need no
+ *                    settle time, as for SetConfig()
+ *
+ *    Register transfers still run synchronously on the loop thread.
+ *    They are short; it is the measurement and settling waits that
+ *    would otherwise cost a thread, or a serialized sleep, per device.
+ *
+ *    Completion handlers run on the loop thread, never from inside
+ *    the call that started the operation. Errors are passed to the
+ *    handler as an exception_ptr.
+ *
+ *    With C++20 coroutines, ReadAsync(), ResetAsync(),
+ *    ConfigureAsync(), and BME280Loop::Delay() return awaitables, and
+ *    BME280Task is a fire-and-forget coroutine type:
+ *
+ *      BME280Task Monitor ( BME280Async& dev )
+ *      {
+ *          co_await dev.ConfigureAsync(ConfigWeather);
+ *          for (;;)
+ *          {
+ *              TPHDoubleCompData compdat = co_await dev.ReadAsync();
+ *              ...
+ *              co_await dev.Loop()->Delay(1000000);
+ *          }
+ *      }
+ *
+ *  Example:
+ *    BME280Loop loop;
+ *    BME280Async adev(&loop, &dev);
+ *    adev.Read([](const TPHDoubleCompData& compdat, std::exception_ptr err) { ... });
+ *    loop.Run();
+ */
+
+#ifndef BME280_LOOP_HPP_
+#define BME280_LOOP_HPP_
+
+#include <atomic>            // atomic
+#include <exception>         // exception_ptr, rethrow_exception, terminate
+#include <functional>        // function
+#include <mutex>             // mutex
+#include <queue>             // priority_queue
+#include <stddef.h>          // size_t
+#include <stdint.h>          // int64_t, uint32_t, uint64_t
+#include <vector>            // vector
+
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>         // coroutine_handle, suspend_never
+#endif
+
+#include "bme280.hpp"
+#include "bme280_config.hpp"
+#include "bme280_data.hpp"
+
+
+namespace bosch_bme280
+{
+
+/*
+ * class BME280Loop
+ *
+ * Description:
+ *   An epoll event loop with one-shot timers. Times are steady clock
+ *   nanoseconds, as SteadyNanos().
+ *
+ *   At() and After() may be called before Run(), or from handlers on
+ *   the loop thread. Post() and Stop() may be called from any thread.
+ *   An exception thrown by a handler propagates out of Poll() or
+ *   Run().
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_loop.hpp
+ */
+class BME280Loop
+{
+
+  protected:
+
+	struct Timer
+	{
+	    int64_t                due;
+	    uint64_t               seq;
+	    std::function<void()>  fn;
+	};
+
+	struct Later
+	{
+	    bool operator() ( const Timer& a, const Timer& b ) const
+	    { return (a.due != b.due) ? (a.due > b.due) : (a.seq > b.seq); }
+	};
+
+	int  epfd;
+	int  tfd;                // timerfd, armed for the earliest timer
+	int  efd;                // eventfd, for Post() and Stop()
+
+	std::priority_queue<Timer, std::vector<Timer>, Later>  timers;
+	uint64_t  seq;
+	int64_t   armed;         // due time tfd is set for, or 0
+
+	std::mutex                          mtx;
+	std::vector<std::function<void()>>  posted;
+	std::atomic<bool>                   stopping;
+	uint64_t                            wakeups;
+
+	void  Arm ();
+	void  Wake ();
+
+  public:
+
+	BME280Loop ();
+	~BME280Loop ();
+
+	BME280Loop ( const BME280Loop& ) = delete;
+	BME280Loop& operator= ( const BME280Loop& ) = delete;
+
+	void  At    ( int64_t due, std::function<void()> fn );
+	void  After ( uint32_t us, std::function<void()> fn );
+	void  Post  ( std::function<void()> fn );
+
+	size_t  Poll ( int timeout_ms = -1 );
+	void    Run  ();
+	void    Stop ();
+
+	size_t    Timers  () const;
+	uint64_t  Wakeups () const;
+
+#if defined(__cpp_impl_coroutine)
+	struct DelayAwaiter
+	{
+	    BME280Loop*  loop;
+	    uint32_t     us;
+
+	    bool  await_ready  () const noexcept { return false; }
+	    void  await_suspend ( std::coroutine_handle<> h )
+	    { loop->After(us, [h]() { h.resume(); }); }
+	    void  await_resume () const noexcept { }
+	};
+
+	DelayAwaiter Delay ( uint32_t us ) { return DelayAwaiter { this, us }; }
+#endif
+
+}; // class BME280Loop
+
+/*
+ * class BME280Async
+ *
+ * Description:
+ *   Non-blocking operations on one device, driven by a BME280Loop.
+ *   Each step locks the device mutex for its transfers only. Start
+ *   one operation at a time per device.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_loop.hpp
+ */
+class BME280Async
+{
+
+  public:
+
+	typedef std::function<void(const TPHDoubleCompData&, std::exception_ptr)>  ReadHandler;
+	typedef std::function<void(std::exception_ptr)>                            DoneHandler;
+
+  protected:
+
+	BME280Loop* loop;
+	BME280*     dev;
+
+	void  PollReady ( int64_t start, uint32_t ttyp, uint32_t tmax, ReadHandler done );
+	void  PollReset ( int64_t due, DoneHandler done );
+	void  Fail      ( DoneHandler done, std::exception_ptr err );
+
+  public:
+
+	BME280Async ( BME280Loop* evloop, BME280* device );
+
+	void  Read      ( ReadHandler done );
+	void  Reset     ( DoneHandler done );
+	void  Configure ( const Config& cfg, DoneHandler done );
+
+	BME280Loop*  Loop   () { return loop; }
+	BME280*      Device () { return dev; }
+
+#if defined(__cpp_impl_coroutine)
+	struct ReadAwaiter
+	{
+	    BME280Async*        adev;
+	    TPHDoubleCompData   result;
+	    std::exception_ptr  err;
+
+	    bool  await_ready () const noexcept { return false; }
+
+	    void  await_suspend ( std::coroutine_handle<> h )
+	    {
+	        adev->Read([this, h](const TPHDoubleCompData& compdat, std::exception_ptr e)
+	        {
+	            result = compdat;
+	            err    = e;
+	            h.resume();
+	        });
+	    }
+
+	    TPHDoubleCompData  await_resume ()
+	    {
+	        if (err) std::rethrow_exception(err);
+	        return result;
+	    }
+	};
+
+	struct DoneAwaiter
+	{
+	    BME280Async*        adev;
+	    Config              cfg;
+	    bool                reset;
+	    std::exception_ptr  err;
+
+	    bool  await_ready () const noexcept { return false; }
+
+	    void  await_suspend ( std::coroutine_handle<> h )
+	    {
+	        DoneHandler done = [this, h](std::exception_ptr e) { err = e; h.resume(); };
+
+	        if (reset)
+	            adev->Reset(done);
+	        else
+	            adev->Configure(cfg, done);
+	    }
+
+	    void  await_resume ()
+	    {
+	        if (err) std::rethrow_exception(err);
+	    }
+	};
+
+	ReadAwaiter  ReadAsync      ()                  { return ReadAwaiter { this, TPHDoubleCompData(), nullptr }; }
+	DoneAwaiter  ResetAsync     ()                  { return DoneAwaiter { this, Config(), true, nullptr }; }
+	DoneAwaiter  ConfigureAsync ( const Config& c ) { return DoneAwaiter { this, c, false, nullptr }; }
+#endif
+
+}; // class BME280Async
+
+#if defined(__cpp_impl_coroutine)
+/*
+ * struct BME280Task
+ *
+ * Description:
+ *   Return type for a fire-and-forget coroutine that runs on a
+ *   BME280Loop. The coroutine starts at once and frees itself when
+ *   it finishes. An exception that escapes it terminates the
+ *   program, so catch inside.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_loop.hpp
+ */
+struct BME280Task
+{
+    struct promise_type
+    {
+        BME280Task           get_return_object   () { return BME280Task(); }
+        std::suspend_never   initial_suspend     () noexcept { return std::suspend_never(); }
+        std::suspend_never   final_suspend       () noexcept { return std::suspend_never(); }
+        void                 return_void         () { }
+        void                 unhandled_exception () { std::terminate(); }
+    };
+};
+#endif
+
+/*
+ * struct LoopBench
+ *
+ * Description:
+ *   Result of BenchBlocking() and BenchEventLoop().
+ *
+ *     devices     - devices read
+ *     threads     - threads that waited on the devices
+ *     samples     - samples read
+ *     seconds     - elapsed time
+ *     voluntary   - voluntary context switches, whole process
+ *     involuntary - involuntary context switches, whole process
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_loop.hpp
+ */
+struct LoopBench
+{
+    size_t    devices;
+    size_t    threads;
+    uint64_t  samples;
+    double    seconds;
+    uint64_t  voluntary;
+    uint64_t  involuntary;
+
+    LoopBench ( )
+      : devices(0), threads(0), samples(0), seconds(0.0), voluntary(0), involuntary(0) { }
+};
+
+LoopBench  BenchBlocking  ( const std::vector<BME280*>& devs, unsigned rounds );
+LoopBench  BenchEventLoop ( const std::vector<BME280*>& devs, unsigned rounds );
+
+} // namespace bosch_bme280
+
+#endif /* BME280_LOOP_HPP_ */
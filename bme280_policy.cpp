@@ -0,0 +1,87 @@
+/*
+ * bme280_policy.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Benchmark of the compensation precision policies.
+ */
+
+
+#include <stddef.h>          // size_t
+#include <stdint.h>          // int64_t
+#include <vector>            // vector
+
+#include "bme280_policy.hpp"
+#include "bme280_time.hpp"
+
+
+namespace bosch_bme280
+{
+
+/*
+ * template <class Policy>
+ * static double bench_policy(const CalParams& cp, const TPH32SensorData* sensdat,
+ *                            size_t count, unsigned rounds)
+ *
+ * Description:
+ *   Returns the time per sample of Compensator<Policy> over the
+ *   samples, in nanoseconds. Calibration is prepared outside the
+ *   timed loop.
+ */
+template <class Policy>
+static double bench_policy(const CalParams& cp, const TPH32SensorData* sensdat,
+                           size_t count, unsigned rounds)
+{
+    Compensator<Policy>                     comp(cp);
+    std::vector<typename Policy::CompData>  compdat(count);
+
+    int64_t start = SteadyNanos();
+    for (unsigned r = 0; r < rounds; r++)
+        comp(sensdat, count, &compdat[0]);
+
+    return (double)(SteadyNanos() - start) / ((double)count * rounds);
+}
+
+/*
+ * PolicyBench BenchPolicies(const CalParams& cp, const TPH32SensorData* sensdat,
+ *                           size_t count, unsigned rounds)
+ *
+ * Description:
+ *   Compensates the same samples with each of the four precision
+ *   policies, rounds times each, and times them.
+ *
+ * Parameters:
+ *   cp      - calibration parameters
+ *   sensdat - pointer to an array of uncompensated samples
+ *   count   - the number of samples
+ *   rounds  - number of timed passes over the samples
+ *
+ * Returns:
+ *   Per-sample time of each policy.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_policy.hpp
+ */
+PolicyBench BenchPolicies(const CalParams& cp, const TPH32SensorData* sensdat,
+                          size_t count, unsigned rounds)
+{
+    PolicyBench pb;
+    pb.samples = count;
+
+    if (count == 0 || rounds == 0)
+        return pb;
+
+    pb.fixed32 = bench_policy<Fixed32Policy> (cp, sensdat, count, rounds);
+    pb.fixed64 = bench_policy<Fixed64Policy> (cp, sensdat, count, rounds);
+    pb.single  = bench_policy<FloatPolicy>   (cp, sensdat, count, rounds);
+    pb.dbl     = bench_policy<DoublePolicy>  (cp, sensdat, count, rounds);
+
+    return pb;
+}
+
+} // namespace bosch_bme280
@@ -0,0 +1,249 @@
+/*
+ * bme280_policy.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Compile-time selection of BME280 compensation precision.
+ *
+ *    Each policy names a calibration type, an output type, the type
+ *    of one compensated value, and the three compensation functions
+ *    for one precision. Compensator<P> binds a policy to a device's
+ *    calibration; the choice between precisions is made by the type
+ *    parameter, so there is no runtime dispatch.
+ *
+ *      Fixed32Policy - 32-bit fixed-point.
+ *      Fixed64Policy - 32-bit fixed-point temperature and humidity,
+ *                      64-bit fixed-point pressure (1/100 Pa).
+ *      FloatPolicy   - single-precision floating point.
+ *      DoublePolicy  - double floating point.
+ *
+ *    FloatPolicy and DoublePolicy share one engine: the header
+ *    templates CompPreparedTemp/Press/Humid<T>() of bme280_comp.hpp,
+ *    instantiated for float and double, which inline fully into
+ *    Compensator<P>. The fixed-point policies forward to the integer
+ *    kernels in bme280_comp.cpp, whose shifts and rounding must
+ *    reproduce Bosch's results exactly and do not follow the float
+ *    formulas; each fixed-point sample costs three direct calls.
+ *    Either way the precision is fixed at compile time.
+ *
+ *    BenchPolicies() times the four against each other.
+ *
+ *  Example:
+ *    Compensator<FloatPolicy> comp(dev.GetCalParams());
+ *    TPHFloatCompData compdat = comp(dev.GetSensorData());
+ */
+
+#ifndef BME280_POLICY_HPP_
+#define BME280_POLICY_HPP_
+
+#include <stddef.h>          // size_t
+#include <stdint.h>          // int32_t, uint32_t
+
+#include "bme280_comp.hpp"
+#include "bme280_data.hpp"
+
+
+namespace bosch_bme280
+{
+
+/*
+ * struct Fixed32Policy
+ *
+ * Description:
+ *   32-bit fixed-point compensation. Outputs are 1/100 degC, Pa, and
+ *   1/1024 %RH.
+ */
+struct Fixed32Policy
+{
+    typedef CalParams      Calibration;
+    typedef TPH32CompData  CompData;
+    typedef int32_t        Value;
+
+    static Calibration Prepare ( const CalParams& cp )
+    { return cp; }
+
+    static int32_t Temp ( const Calibration& c, uint32_t unctemp, int32_t& tfine )
+    { return Comp32FixedTemp(c, unctemp, tfine); }
+
+    static int32_t Press ( const Calibration& c, uint32_t uncpress, int32_t tfine )
+    { return (int32_t)Comp32FixedPress(c, uncpress, tfine); }
+
+    static int32_t Humid ( const Calibration& c, uint32_t unchum, int32_t tfine )
+    { return (int32_t)Comp32FixedHumid(c, unchum, tfine); }
+};
+
+/*
+ * struct Fixed64Policy
+ *
+ * Description:
+ *   Bosch high-precision integer compensation. As Fixed32Policy,
+ *   except that pressure uses 64-bit arithmetic and is returned in
+ *   1/100 Pa.
+ */
+struct Fixed64Policy
+{
+    typedef CalParams      Calibration;
+    typedef TPH32CompData  CompData;
+    typedef int32_t        Value;
+
+    static Calibration Prepare ( const CalParams& cp )
+    { return cp; }
+
+    static int32_t Temp ( const Calibration& c, uint32_t unctemp, int32_t& tfine )
+    { return Comp32FixedTemp(c, unctemp, tfine); }
+
+    static int32_t Press ( const Calibration& c, uint32_t uncpress, int32_t tfine )
+    { return (int32_t)Comp64FixedPress(c, uncpress, tfine); }
+
+    static int32_t Humid ( const Calibration& c, uint32_t unchum, int32_t tfine )
+    { return (int32_t)Comp32FixedHumid(c, unchum, tfine); }
+};
+
+/*
+ * struct FloatPolicy
+ *
+ * Description:
+ *   Single-precision floating-point compensation. Outputs are degC,
+ *   Pa, and %RH.
+ */
+struct FloatPolicy
+{
+    typedef PreparedFloatCalibration  Calibration;
+    typedef TPHFloatCompData          CompData;
+    typedef float                     Value;
+
+    static Calibration Prepare ( const CalParams& cp )
+    { return PreparedFloatCalibration(PreparedCalibration(cp)); }
+
+    static float Temp ( const Calibration& c, uint32_t unctemp, int32_t& tfine )
+    { return CompFloatTemp(c, unctemp, tfine); }
+
+    static float Press ( const Calibration& c, uint32_t uncpress, int32_t tfine )
+    { return CompFloatPress(c, uncpress, tfine); }
+
+    static float Humid ( const Calibration& c, uint32_t unchum, int32_t tfine )
+    { return CompFloatHumid(c, unchum, tfine); }
+};
+
+/*
+ * struct DoublePolicy
+ *
+ * Description:
+ *   Double floating-point compensation. Outputs are degC, Pa, and
+ *   %RH.
+ */
+struct DoublePolicy
+{
+    typedef PreparedCalibration  Calibration;
+    typedef TPHDoubleCompData    CompData;
+    typedef double               Value;
+
+    static Calibration Prepare ( const CalParams& cp )
+    { return PreparedCalibration(cp); }
+
+    static double Temp ( const Calibration& c, uint32_t unctemp, int32_t& tfine )
+    { return CompDoubleTemp(c, unctemp, tfine); }
+
+    static double Press ( const Calibration& c, uint32_t uncpress, int32_t tfine )
+    { return CompDoublePress(c, uncpress, tfine); }
+
+    static double Humid ( const Calibration& c, uint32_t unchum, int32_t tfine )
+    { return CompDoubleHumid(c, unchum, tfine); }
+};
+
+
+/*
+ * template <class Policy> class Compensator
+ *
+ * Description:
+ *   Holds calibration prepared for one policy and compensates raw
+ *   samples with it. Member functions are const and keep no state
+ *   between samples, so one Compensator may be shared by threads.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_policy.hpp
+ */
+template <class Policy>
+class Compensator
+{
+  public:
+
+	typedef typename Policy::Calibration  Calibration;
+	typedef typename Policy::CompData     CompData;
+
+  protected:
+
+	Calibration cal;
+
+  public:
+
+	explicit Compensator ( const CalParams& cp )
+	  : cal(Policy::Prepare(cp))
+	{ }
+
+	const Calibration& GetCalibration () const
+	{ return cal; }
+
+	CompData operator() ( const TPH32SensorData& sensdat ) const
+	{
+	    CompData compdat;
+
+	    compdat.timestamp   = sensdat.timestamp;
+	    compdat.sampled     = sensdat.sampled;
+	    compdat.temperature = Policy::Temp  (cal, sensdat.temperature, compdat.tfine);
+	    compdat.pressure    = Policy::Press (cal, sensdat.pressure,    compdat.tfine);
+	    compdat.humidity    = Policy::Humid (cal, sensdat.humidity,    compdat.tfine);
+
+	    return compdat;
+	}
+
+	void operator() ( const TPH32SensorData* sensdat, size_t count, CompData* compdat ) const
+	{
+	    for (size_t i = 0; i < count; i++)
+	        compdat[i] = (*this)(sensdat[i]);
+	}
+
+}; // class Compensator
+
+/*
+ * struct PolicyBench
+ *
+ * Description:
+ *   Result of BenchPolicies(). Time per sample of Compensator<P>
+ *   for each policy, in nanoseconds.
+ *
+ *     samples - samples per round
+ *     fixed32 - Fixed32Policy
+ *     fixed64 - Fixed64Policy
+ *     single  - FloatPolicy
+ *     dbl     - DoublePolicy
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_policy.hpp
+ */
+struct PolicyBench
+{
+    size_t  samples;
+    double  fixed32;
+    double  fixed64;
+    double  single;
+    double  dbl;
+
+    PolicyBench ( )
+      : samples(0), fixed32(0.0), fixed64(0.0), single(0.0), dbl(0.0) { }
+};
+
+PolicyBench  BenchPolicies ( const CalParams& cp, const TPH32SensorData* sensdat,
+                             size_t count, unsigned rounds );
+
+} // namespace bosch_bme280
+
+#endif /* BME280_POLICY_HPP_ */
@@ -0,0 +1,58 @@
+/*
+ * bme280_replay.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Parallel offline compensation of captured raw samples. The
+ *    replay engine itself is a template, in bme280_replay.hpp.
+ */
+
+
+#include <fstream>           // ofstream
+#include <stdexcept>         // runtime_error
+
+#include "bme280_replay.hpp"
+
+
+using namespace std;
+
+
+namespace bosch_bme280
+{
+
+/*
+ * void WriteColumn(const std::string& path, const void* data, size_t size)
+ *
+ * Description:
+ *   Writes one output column to a file, replacing the file.
+ *
+ * Parameters:
+ *   path - output file path
+ *   data - column data
+ *   size - column size, in bytes
+ *
+ * Exceptions:
+ *   Throws std::runtime_error if the file cannot be written.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_replay.hpp
+ */
+void WriteColumn(const string& path, const void* data, size_t size)
+{
+    ofstream colfile(path.c_str(), ios::out | ios::binary | ios::trunc);
+    if (!colfile)
+        throw runtime_error("WriteColumn: cannot create " + path);
+
+    colfile.write((const char*)data, size);
+    colfile.close();
+
+    if (!colfile)
+        throw runtime_error("WriteColumn: cannot write " + path);
+}
+
+} // namespace bosch_bme280
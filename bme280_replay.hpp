@@ -0,0 +1,262 @@
+/*
+ * bme280_replay.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Parallel offline compensation of captured raw samples.
+ *
+ *    BME280Replay<Policy> splits an array of CaptureRecords into
+ *    chunks and compensates the chunks on a WorkQueue thread pool,
+ *    into columns: one array each for sample time, temperature,
+ *    pressure, and humidity. Every sample is compensated by the same
+ *    Policy functions that Compensator<Policy> uses, so the results
+ *    are identical to compensating the samples one at a time, in
+ *    order, whatever the chunking or thread count.
+ *
+ *    Chunks write disjoint ranges of preallocated columns, so the
+ *    threads share nothing but the read-only calibration, and
+ *    throughput scales with the number of cores.
+ *
+ *  Example:
+ *    CaptureReader cap("bme280.cap");
+ *    BME280Replay<Fixed64Policy> replay(cap.GetCalParams());
+ *    ReplayColumns<Fixed64Policy> cols;
+ *    ReplayStats rs = replay.Run(cap, cols);
+ *    cols.Write("bme280");      // bme280.sampled, bme280.temperature, ...
+ */
+
+#ifndef BME280_REPLAY_HPP_
+#define BME280_REPLAY_HPP_
+
+#include <algorithm>         // min
+#include <future>            // future
+#include <stddef.h>          // size_t
+#include <stdint.h>          // int32_t, int64_t, uint64_t
+#include <string>            // string
+#include <vector>            // vector
+
+#include "bme280_data.hpp"
+#include "bme280_defs.hpp"
+#include "bme280_log.hpp"
+#include "bme280_policy.hpp"
+#include "bme280_time.hpp"
+#include "bme280_work.hpp"
+
+
+namespace bosch_bme280
+{
+
+void  WriteColumn ( const std::string& path, const void* data, size_t size );
+
+/*
+ * struct ReplayStats
+ *
+ * Description:
+ *   Results of one replay run.
+ *
+ *     samples - samples compensated
+ *     chunks  - tasks the samples were split into
+ *     threads - pool threads
+ *     seconds - elapsed time
+ *     rate    - samples per second
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_replay.hpp
+ */
+struct ReplayStats
+{
+    uint64_t  samples;
+    size_t    chunks;
+    size_t    threads;
+    double    seconds;
+    double    rate;
+
+    ReplayStats ( )
+      : samples(0), chunks(0), threads(0), seconds(0.0), rate(0.0) { }
+};
+
+/*
+ * template <class Policy> struct ReplayColumns
+ *
+ * Description:
+ *   Columnar replay output. Element i of every column belongs to
+ *   record i. Values are in the units of the policy.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_replay.hpp
+ */
+template <class Policy>
+struct ReplayColumns
+{
+    typedef typename Policy::Value  Value;
+
+    std::vector<int64_t>  sampled;
+    std::vector<Value>    temperature;
+    std::vector<Value>    pressure;
+    std::vector<Value>    humidity;
+
+    void Resize ( size_t n )
+    {
+        sampled.resize(n);
+        temperature.resize(n);
+        pressure.resize(n);
+        humidity.resize(n);
+    }
+
+    size_t Size () const
+    { return sampled.size(); }
+
+    /*
+     * Writes each column to its own file, prefix.sampled,
+     * prefix.temperature, prefix.pressure, and prefix.humidity, as a
+     * bare array in host byte order. Throws std::runtime_error on
+     * failure.
+     */
+    void Write ( const std::string& prefix ) const
+    {
+        WriteColumn(prefix + ".sampled",     sampled.data(),     sampled.size()     * sizeof(int64_t));
+        WriteColumn(prefix + ".temperature", temperature.data(), temperature.size() * sizeof(Value));
+        WriteColumn(prefix + ".pressure",    pressure.data(),    pressure.size()    * sizeof(Value));
+        WriteColumn(prefix + ".humidity",    humidity.data(),    humidity.size()    * sizeof(Value));
+    }
+};
+
+/*
+ * template <class Policy> class BME280Replay
+ *
+ * Description:
+ *   Compensates captured records in parallel with one policy.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_replay.hpp
+ */
+template <class Policy>
+class BME280Replay
+{
+
+  public:
+
+	typedef typename Policy::Calibration  Calibration;
+	typedef typename Policy::Value        Value;
+
+  protected:
+
+	Calibration  cal;
+	size_t       chunk;
+	WorkQueue    pool;
+
+	/*
+	 * Compensates records [begin, end) into the columns. Each block
+	 * is done in three passes, temperature first, with tfine kept in
+	 * a small buffer, as Comp32FixedBatch() does.
+	 */
+	void Compensate ( const CaptureRecord* recs, size_t begin, size_t end,
+	                  ReplayColumns<Policy>& out ) const
+	{
+	    int32_t tfine[BME280_REPLAY_BLOCK];
+
+	    int64_t* sampled = out.sampled.data();
+	    Value*   temp    = out.temperature.data();
+	    Value*   press   = out.pressure.data();
+	    Value*   humid   = out.humidity.data();
+
+	    for (size_t b = begin; b < end; b += BME280_REPLAY_BLOCK)
+	    {
+	        size_t n = std::min<size_t>(BME280_REPLAY_BLOCK, end - b);
+	        const CaptureRecord* r = recs + b;
+
+	        for (size_t i = 0; i < n; i++)
+	        {
+	            sampled[b + i] = r[i].sampled;
+	            temp[b + i]    = Policy::Temp(cal, r[i].temperature, tfine[i]);
+	        }
+	        for (size_t i = 0; i < n; i++)
+	            press[b + i] = Policy::Press(cal, r[i].pressure, tfine[i]);
+	        for (size_t i = 0; i < n; i++)
+	            humid[b + i] = Policy::Humid(cal, r[i].humidity, tfine[i]);
+	    }
+	}
+
+  public:
+
+	/*
+	 * Constructor. nthreads is the pool size; zero means one per
+	 * hardware thread. chunksize is the number of records per task.
+	 */
+	explicit BME280Replay ( const CalParams& cp, unsigned nthreads = 0,
+	                        size_t chunksize = BME280_REPLAY_CHUNK )
+	  : cal(Policy::Prepare(cp)),
+	    chunk(chunksize ? chunksize : BME280_REPLAY_CHUNK),
+	    pool(nthreads)
+	{ }
+
+	BME280Replay ( const BME280Replay& ) = delete;
+	BME280Replay& operator= ( const BME280Replay& ) = delete;
+
+	/*
+	 * The calibration may be cache-line aligned; see AlignedAlloc().
+	 */
+	static void* operator new      ( size_t size ) { return AlignedAlloc(size); }
+	static void* operator new[]    ( size_t size ) { return AlignedAlloc(size); }
+	static void  operator delete   ( void* ptr )   { AlignedFree(ptr); }
+	static void  operator delete[] ( void* ptr )   { AlignedFree(ptr); }
+
+	/*
+	 * Compensates count records into out, which is resized to count.
+	 * Returns when every chunk is done. Rethrows the first exception
+	 * thrown by a chunk, if any.
+	 */
+	ReplayStats Run ( const CaptureRecord* recs, size_t count, ReplayColumns<Policy>& out )
+	{
+	    ReplayStats rs;
+	    int64_t     start = SteadyNanos();
+
+	    out.Resize(count);
+
+	    std::vector<std::future<void>> done;
+	    for (size_t b = 0; b < count; b += chunk)
+	    {
+	        size_t e = std::min(count, b + chunk);
+	        done.push_back(pool.Submit([this, recs, b, e, &out] {
+	            this->Compensate(recs, b, e, out);
+	        }));
+	    }
+
+	    for (size_t i = 0; i < done.size(); i++)
+	        done[i].wait();
+	    for (size_t i = 0; i < done.size(); i++)
+	        done[i].get();
+
+	    rs.samples = count;
+	    rs.chunks  = done.size();
+	    rs.threads = pool.Threads();
+	    rs.seconds = (double)(SteadyNanos() - start) / 1e9;
+	    rs.rate    = (rs.seconds > 0.0) ? (double)count / rs.seconds : 0.0;
+
+	    return rs;
+	}
+
+	/*
+	 * Compensates every committed record of a capture file.
+	 */
+	ReplayStats Run ( const CaptureReader& cap, ReplayColumns<Policy>& out )
+	{
+	    return this->Run(cap.begin(), (size_t)cap.Size(), out);
+	}
+
+}; // class BME280Replay
+
+} // namespace bosch_bme280
+
+#endif /* BME280_REPLAY_HPP_ */
@@ -0,0 +1,108 @@
+/*
+ * bme280_ring.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    A fixed-capacity single-producer, single-consumer ring buffer.
+ *
+ *    Push() and Pop() are wait-free: each touches only its own index
+ *    plus one acquire load of the other side's index, and neither
+ *    ever waits. The two indices live on separate cache lines so the
+ *    producer and consumer do not contend for one line.
+ */
+
+#ifndef BME280_RING_HPP_
+#define BME280_RING_HPP_
+
+#include <atomic>            // atomic, memory_order
+#include <stddef.h>          // size_t
+
+
+namespace bosch_bme280
+{
+
+/*
+ * template <class T, size_t N> class SpscRing
+ *
+ * Description:
+ *   Ring buffer of N elements of type T. N must be a power of two.
+ *   Exactly one thread may call Push() and exactly one thread may
+ *   call Pop(); Size() and Empty() may be called from either.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_ring.hpp
+ */
+template <class T, size_t N>
+class SpscRing
+{
+	static_assert((N >= 2) && ((N & (N - 1)) == 0), "SpscRing capacity must be a power of two");
+
+  protected:
+
+	alignas(64) std::atomic<size_t> head;    // next slot to write, producer owned
+	alignas(64) std::atomic<size_t> tail;    // next slot to read,  consumer owned
+	alignas(64) T buf[N];
+
+  public:
+
+	SpscRing ( ) : head(0), tail(0) { }
+
+	SpscRing ( const SpscRing& ) = delete;
+	SpscRing& operator= ( const SpscRing& ) = delete;
+
+	static constexpr size_t Capacity () { return N; }
+
+	/*
+	 * Appends one element. Returns false, leaving the buffer
+	 * unchanged, if the buffer is full.
+	 */
+	bool Push ( const T& item )
+	{
+	    size_t h = head.load(std::memory_order_relaxed);
+
+	    if (h - tail.load(std::memory_order_acquire) == N)
+	        return false;
+
+	    buf[h & (N - 1)] = item;
+	    head.store(h + 1, std::memory_order_release);
+
+	    return true;
+	}
+
+	/*
+	 * Removes the oldest element. Returns false if the buffer is
+	 * empty.
+	 */
+	bool Pop ( T& item )
+	{
+	    size_t t = tail.load(std::memory_order_relaxed);
+
+	    if (head.load(std::memory_order_acquire) == t)
+	        return false;
+
+	    item = buf[t & (N - 1)];
+	    tail.store(t + 1, std::memory_order_release);
+
+	    return true;
+	}
+
+	size_t Size () const
+	{
+	    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+	}
+
+	bool Empty () const
+	{
+	    return this->Size() == 0;
+	}
+
+}; // class SpscRing
+
+} // namespace bosch_bme280
+
+#endif /* BME280_RING_HPP_ */
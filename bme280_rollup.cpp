@@ -0,0 +1,513 @@
+/*
+ * bme280_rollup.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Incremental multi-resolution aggregation of compensated samples.
+ *
+ *  Notes:
+ *    1. Buckets are numbered by start time / width. A ring entry also
+ *       records the bucket number it holds, so an entry left over
+ *       from an earlier lap of the ring, or never written because no
+ *       samples arrived, is recognized and skipped.
+ *    2. At any moment each level has one open bucket. A lower level's
+ *       open bucket has not yet been merged upward, so the statistics
+ *       of a bucket are its own, plus every lower open bucket that
+ *       falls within it. Bucket() assembles that.
+ */
+
+
+#include <algorithm>         // min, max
+#include <cmath>             // sqrt
+
+#include "bme280_rollup.hpp"
+#include "bme280_time.hpp"
+
+
+using namespace std;
+
+
+namespace bosch_bme280
+{
+
+static const int64_t reswidth[RES_COUNT] { 1000000LL, 60000000LL, 3600000000LL };
+
+static inline int64_t FloorDiv(int64_t a, int64_t b)
+{
+    int64_t q = a / b;
+    return ((a % b) < 0) ? q - 1 : q;
+}
+
+
+// Aggregate
+// -----------------------------------------------------------------
+
+/*
+ * Aggregate::Aggregate()
+ *
+ * Description:
+ *   Constructor. An empty aggregate; all statistics read zero.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_rollup.hpp
+ */
+Aggregate::Aggregate()
+  : count(0), min(0.0), max(0.0), mean(0.0), m2(0.0)
+{ }
+
+/*
+ * void Aggregate::Add(double x)
+ *
+ * Description:
+ *   Adds one value (Welford's update).
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_rollup.hpp
+ */
+void Aggregate::Add(double x)
+{
+    if (count == 0)
+    {
+        min = max = x;
+    }
+    else
+    {
+        min = (x < min) ? x : min;
+        max = (x > max) ? x : max;
+    }
+
+    count++;
+
+    double d = x - mean;
+    mean += d / (double)count;
+    m2   += d * (x - mean);
+}
+
+/*
+ * void Aggregate::Merge(const Aggregate& a)
+ *
+ * Description:
+ *   Combines another aggregate with this one (Chan's formula).
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_rollup.hpp
+ */
+void Aggregate::Merge(const Aggregate& a)
+{
+    if (a.count == 0) return;
+
+    if (count == 0)
+    {
+        *this = a;
+        return;
+    }
+
+    double n  = (double)(count + a.count);
+    double d  = a.mean - mean;
+
+    mean += d * (double)a.count / n;
+    m2   += a.m2 + d * d * (double)count * (double)a.count / n;
+    min   = (a.min < min) ? a.min : min;
+    max   = (a.max > max) ? a.max : max;
+
+    count += a.count;
+}
+
+/*
+ * double Aggregate::Variance() const
+ * double Aggregate::StdDev() const
+ *
+ * Description:
+ *   Return the population variance and standard deviation, or zero
+ *   if there are no values.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_rollup.hpp
+ */
+double Aggregate::Variance() const
+{
+    return count ? m2 / (double)count : 0.0;
+}
+
+double Aggregate::StdDev() const
+{
+    return sqrt(this->Variance());
+}
+
+
+// BME280Rollup Constructor
+// -----------------------------------------------------------------
+
+/*
+ * BME280Rollup::BME280Rollup(size_t seconds, size_t minutes, size_t hours)
+ *
+ * Description:
+ *   Constructor. Allocates the bucket rings.
+ *
+ * Parameters:
+ *   seconds - Optional. Number of 1 second buckets kept.
+ *             Default value is BME280_ROLLUP_SECONDS.
+ *   minutes - Optional. Number of 1 minute buckets kept.
+ *             Default value is BME280_ROLLUP_MINUTES.
+ *   hours   - Optional. Number of 1 hour buckets kept.
+ *             Default value is BME280_ROLLUP_HOURS.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_rollup.hpp
+ */
+BME280Rollup::BME280Rollup(size_t seconds, size_t minutes, size_t hours)
+  : dropped(0)
+{
+    size_t sizes[RES_COUNT] { seconds, minutes, hours };
+
+    for (int l = 0; l < RES_COUNT; l++)
+    {
+        Level& L = levels[l];
+
+        L.width   = reswidth[l];
+        L.ring.assign(sizes[l] ? sizes[l] : 1, RollupBucket());
+        L.slot.assign(L.ring.size(), -1);
+        L.current = -1;
+    }
+}
+
+
+// BME280Rollup Protected
+// -----------------------------------------------------------------
+
+/*
+ * void BME280Rollup::Advance(int lvl, int64_t bucket)
+ *
+ * Description:
+ *   Makes bucket the open bucket of a level. The bucket it replaces
+ *   is stored in the ring and merged into the level above.
+ *
+ * Parameters:
+ *   lvl    - level (Resolution)
+ *   bucket - bucket number
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_rollup.hpp
+ */
+void BME280Rollup::Advance(int lvl, int64_t bucket)
+{
+    Level& L = levels[lvl];
+
+    if (L.current == bucket) return;
+
+    if (L.current >= 0)
+    {
+        size_t i = (size_t)(L.current % (int64_t)L.ring.size());
+
+        L.ring[i] = L.open;
+        L.slot[i] = L.current;
+
+        if (lvl + 1 < RES_COUNT)
+        {
+            Level& U = levels[lvl + 1];
+
+            this->Advance(lvl + 1, FloorDiv(L.open.start, U.width));
+            U.open.Merge(L.open);
+        }
+    }
+
+    L.open       = RollupBucket();
+    L.open.start = bucket * L.width;
+    L.current    = bucket;
+}
+
+/*
+ * RollupBucket BME280Rollup::Bucket(int lvl, int64_t bucket) const
+ *
+ * Description:
+ *   Returns the statistics of one bucket, including samples still
+ *   held in lower levels' open buckets. A bucket no longer in the
+ *   ring, or without samples, is returned empty.
+ *
+ * Parameters:
+ *   lvl    - level (Resolution)
+ *   bucket - bucket number
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_rollup.hpp
+ */
+RollupBucket BME280Rollup::Bucket(int lvl, int64_t bucket) const
+{
+    const Level& L = levels[lvl];
+
+    RollupBucket b;
+    b.start = bucket * L.width;
+
+    size_t i = (size_t)(bucket % (int64_t)L.ring.size());
+
+    if (L.current == bucket)
+        b.Merge(L.open);
+    else if (L.slot[i] == bucket)
+        b.Merge(L.ring[i]);
+
+    for (int k = 0; k < lvl; k++)
+    {
+        const Level& K = levels[k];
+
+        if ((K.current >= 0) && (FloorDiv(K.open.start, L.width) == bucket))
+            b.Merge(K.open);
+    }
+
+    return b;
+}
+
+/*
+ * int64_t BME280Rollup::Newest(int lvl) const
+ *
+ * Description:
+ *   Returns the number of the newest bucket of a level that holds
+ *   samples, or -1 if there are none.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_rollup.hpp
+ */
+int64_t BME280Rollup::Newest(int lvl) const
+{
+    if (levels[0].current < 0) return -1;
+
+    return FloorDiv(levels[0].open.start, levels[lvl].width);
+}
+
+/*
+ * RollupBucket BME280Rollup::Range(int lvl, int64_t b0, int64_t b1) const
+ *
+ * Description:
+ *   Combines buckets b0 through b1 of a level, limited to the
+ *   buckets still in the ring.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_rollup.hpp
+ */
+RollupBucket BME280Rollup::Range(int lvl, int64_t b0, int64_t b1) const
+{
+    RollupBucket r;
+    r.start = b0 * levels[lvl].width;
+
+    int64_t newest = this->Newest(lvl);
+    if (newest < 0) return r;
+
+    b1 = min(b1, newest);
+    b0 = max(b0, newest - (int64_t)levels[lvl].ring.size() + 1);
+
+    for (int64_t b = b0; b <= b1; b++)
+        r.Merge(this->Bucket(lvl, b));
+
+    return r;
+}
+
+
+// BME280Rollup Public
+// -----------------------------------------------------------------
+
+/*
+ * void BME280Rollup::Add(int64_t t, double temperature, double pressure, double humidity)
+ *
+ * Description:
+ *   Adds one sample.
+ *
+ * Parameters:
+ *   t - wall clock time, microseconds since the epoch
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_rollup.hpp
+ */
+void BME280Rollup::Add(int64_t t, double temperature, double pressure, double humidity)
+{
+    lock_guard<mutex> lock(mtx);
+
+    int64_t sec = FloorDiv(t, levels[RES_SECOND].width);
+
+    if ((levels[RES_SECOND].current >= 0) && (sec < levels[RES_SECOND].current))
+    {
+        dropped++;
+        return;
+    }
+
+    this->Advance(RES_SECOND, sec);
+
+    RollupBucket& b = levels[RES_SECOND].open;
+    b.ch[CH_TEMPERATURE].Add(temperature);
+    b.ch[CH_PRESSURE].Add(pressure);
+    b.ch[CH_HUMIDITY].Add(humidity);
+}
+
+/*
+ * void BME280Rollup::Add(const TPH32CompData& compdat)
+ * void BME280Rollup::Add(const TPHDoubleCompData& compdat)
+ *
+ * Description:
+ *   Adds one compensated sample, in its own units. The time is the
+ *   sample time converted to the wall clock, or the time stamp if
+ *   there is no sample time.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_rollup.hpp
+ */
+void BME280Rollup::Add(const TPH32CompData& compdat)
+{
+    int64_t t = compdat.sampled ? WallMicros(compdat.sampled) :
+                                  (int64_t)compdat.timestamp * 1000000;
+
+    this->Add(t, (double)compdat.temperature, (double)compdat.pressure,
+                 (double)compdat.humidity);
+}
+
+void BME280Rollup::Add(const TPHDoubleCompData& compdat)
+{
+    int64_t t = compdat.sampled ? WallMicros(compdat.sampled) :
+                                  (int64_t)compdat.timestamp * 1000000;
+
+    this->Add(t, compdat.temperature, compdat.pressure, compdat.humidity);
+}
+
+/*
+ * RollupBucket BME280Rollup::Query(Resolution res, int64_t t0, int64_t t1)
+ *
+ * Description:
+ *   Returns statistics over every bucket of one resolution that
+ *   overlaps a time range. The range is widened to whole buckets,
+ *   and limited to the buckets still kept.
+ *
+ * Parameters:
+ *   res - bucket resolution
+ *   t0  - range start, wall clock microseconds
+ *   t1  - range end, wall clock microseconds, inclusive
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_rollup.hpp
+ */
+RollupBucket BME280Rollup::Query(Resolution res, int64_t t0, int64_t t1)
+{
+    lock_guard<mutex> lock(mtx);
+
+    int64_t w = levels[res].width;
+
+    return this->Range(res, FloorDiv(t0, w), FloorDiv(t1, w));
+}
+
+/*
+ * RollupBucket BME280Rollup::Last(Resolution res, size_t n)
+ *
+ * Description:
+ *   Returns statistics over the last n buckets of one resolution,
+ *   counting the bucket of the newest sample as the last. This is a
+ *   rolling window: Last(RES_SECOND, 60) covers the last minute, to
+ *   within one second.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_rollup.hpp
+ */
+RollupBucket BME280Rollup::Last(Resolution res, size_t n)
+{
+    lock_guard<mutex> lock(mtx);
+
+    int64_t newest = this->Newest(res);
+
+    return this->Range(res, newest - (int64_t)n + 1, newest);
+}
+
+/*
+ * size_t BME280Rollup::Series(Resolution res, int64_t t0, int64_t t1,
+ *                             std::vector<RollupBucket>& out)
+ *
+ * Description:
+ *   Appends each bucket of one resolution that overlaps a time range
+ *   and holds samples, oldest first.
+ *
+ * Returns:
+ *   Returns the number of buckets appended.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_rollup.hpp
+ */
+size_t BME280Rollup::Series(Resolution res, int64_t t0, int64_t t1, vector<RollupBucket>& out)
+{
+    lock_guard<mutex> lock(mtx);
+
+    size_t  before = out.size();
+    int64_t w      = levels[res].width;
+    int64_t newest = this->Newest(res);
+
+    if (newest < 0) return 0;
+
+    int64_t b0 = max(FloorDiv(t0, w), newest - (int64_t)levels[res].ring.size() + 1);
+    int64_t b1 = min(FloorDiv(t1, w), newest);
+
+    for (int64_t b = b0; b <= b1; b++)
+    {
+        RollupBucket bk = this->Bucket(res, b);
+        if (bk.ch[CH_TEMPERATURE].count)
+            out.push_back(bk);
+    }
+
+    return out.size() - before;
+}
+
+/*
+ * uint64_t BME280Rollup::Dropped()
+ *
+ * Description:
+ *   Returns the number of samples dropped for arriving out of order.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_rollup.hpp
+ */
+uint64_t BME280Rollup::Dropped()
+{
+    lock_guard<mutex> lock(mtx);
+    return dropped;
+}
+
+} // namespace bosch_bme280
@@ -0,0 +1,181 @@
+/*
+ * bme280_rollup.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Incremental multi-resolution aggregation of compensated samples.
+ *
+ *    BME280Rollup keeps count, minimum, maximum, mean, and variance
+ *    for each channel in 1 second, 1 minute, and 1 hour buckets.
+ *    Each resolution is a fixed ring of buckets, allocated once. A
+ *    sample updates only the open 1 second bucket; when a second
+ *    closes, its bucket is merged into the open minute, and when a
+ *    minute closes, into the open hour. Queries combine buckets, so
+ *    no query ever rescans samples.
+ *
+ *    Mean and variance are kept in Welford form and merged with
+ *    Chan's formula, which stays accurate where sum-of-squares does
+ *    not.
+ *
+ *    Values keep the units of the data they come from: a rollup fed
+ *    TPH32CompData holds 1/100 degC, Pa (or 1/100 Pa from the 64-bit
+ *    path), and 1/1024 %RH. Feed one rollup from one kind of data.
+ *
+ *  Example:
+ *    BME280Rollup roll;
+ *    roll.Add(dev.GetCompDoubleData());           // each sample
+ *    ...
+ *    RollupBucket hour = roll.Last(RES_MINUTE, 60);
+ *    double tmax = hour.ch[CH_TEMPERATURE].max;
+ */
+
+#ifndef BME280_ROLLUP_HPP_
+#define BME280_ROLLUP_HPP_
+
+#include <mutex>             // mutex
+#include <stddef.h>          // size_t
+#include <stdint.h>          // int64_t, uint64_t
+#include <vector>            // vector
+
+#include "bme280_data.hpp"
+#include "bme280_defs.hpp"
+
+
+namespace bosch_bme280
+{
+
+/*
+ * enum Resolution
+ *
+ * Description:
+ *   Rollup bucket widths.
+ */
+enum Resolution
+{
+    RES_SECOND = 0,
+    RES_MINUTE,
+    RES_HOUR,
+    RES_COUNT
+};
+
+/*
+ * struct Aggregate
+ *
+ * Description:
+ *   Running statistics of one channel. m2 is the sum of squared
+ *   differences from the mean. Variance() is the population
+ *   variance.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_rollup.hpp
+ */
+struct Aggregate
+{
+    uint64_t  count;
+    double    min;
+    double    max;
+    double    mean;
+    double    m2;
+
+    Aggregate ( );
+
+    void    Add      ( double x );
+    void    Merge    ( const Aggregate& a );
+    double  Variance () const;
+    double  StdDev   () const;
+};
+
+/*
+ * struct RollupBucket
+ *
+ * Description:
+ *   Statistics of every channel over one bucket, or over a query
+ *   range. start is the bucket start, wall clock microseconds.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_rollup.hpp
+ */
+struct RollupBucket
+{
+    int64_t    start;
+    Aggregate  ch[CH_COUNT];
+
+    RollupBucket ( )
+      : start(0) { }
+
+    void Merge ( const RollupBucket& b )
+    {
+        for (int c = 0; c < CH_COUNT; c++)
+            ch[c].Merge(b.ch[c]);
+    }
+};
+
+/*
+ * class BME280Rollup
+ *
+ * Description:
+ *   Multi-resolution rollups of one sample stream. Samples are
+ *   expected in time order; a sample older than the open second is
+ *   dropped and counted. Thread safe: one thread may add while
+ *   others query.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_rollup.hpp
+ */
+class BME280Rollup
+{
+
+  protected:
+
+	struct Level
+	{
+	    int64_t                    width;     // microseconds
+	    std::vector<RollupBucket>  ring;
+	    std::vector<int64_t>       slot;      // bucket number held by each ring entry
+	    RollupBucket               open;
+	    int64_t                    current;   // bucket number of open, or -1
+	};
+
+	Level       levels[RES_COUNT];
+	uint64_t    dropped;
+	std::mutex  mtx;
+
+	void          Advance ( int lvl, int64_t bucket );
+	RollupBucket  Bucket  ( int lvl, int64_t bucket ) const;
+	int64_t       Newest  ( int lvl ) const;
+	RollupBucket  Range   ( int lvl, int64_t b0, int64_t b1 ) const;
+
+  public:
+
+	BME280Rollup ( size_t seconds = BME280_ROLLUP_SECONDS,
+	               size_t minutes = BME280_ROLLUP_MINUTES,
+	               size_t hours   = BME280_ROLLUP_HOURS );
+
+	BME280Rollup ( const BME280Rollup& ) = delete;
+	BME280Rollup& operator= ( const BME280Rollup& ) = delete;
+
+	void  Add ( int64_t t, double temperature, double pressure, double humidity );
+	void  Add ( const TPH32CompData& compdat );
+	void  Add ( const TPHDoubleCompData& compdat );
+
+	RollupBucket  Query   ( Resolution res, int64_t t0, int64_t t1 );
+	RollupBucket  Last    ( Resolution res, size_t n );
+	size_t        Series  ( Resolution res, int64_t t0, int64_t t1, std::vector<RollupBucket>& out );
+	uint64_t      Dropped ();
+
+}; // class BME280Rollup
+
+} // namespace bosch_bme280
+
+#endif /* BME280_ROLLUP_HPP_ */
@@ -0,0 +1,415 @@
+/*
+ * bme280_sched.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Earliest-deadline-first scheduling of forced mode measurements
+ *    for several BME280s that share one bus.
+ *
+ *  Notes:
+ *    1. The read for a job is scheduled at the data sheet maximum
+ *       measurement time after its trigger, so it normally needs no
+ *       status polling. If the measuring bit is still set, the read
+ *       is retried after BME280_POLL_INTERVAL.
+ *    2. A job and its two transactions share one deadline. Since
+ *       triggers are released at the start of a job, a trigger for a
+ *       sensor with an early deadline runs ahead of reads that are
+ *       due later, which is what makes conversions overlap.
+ */
+
+
+#include <algorithm>         // min
+#include <chrono>            // steady_clock, microseconds
+#include <exception>         // exception
+#include <stdexcept>         // invalid_argument, logic_error
+
+#include "bme280_sched.hpp"
+#include "bme280_time.hpp"
+
+
+using namespace std;
+using namespace std::chrono;
+
+
+namespace bosch_bme280
+{
+
+// BME280Scheduler Constructor, Destructor
+// -----------------------------------------------------------------
+
+/*
+ * BME280Scheduler::BME280Scheduler()
+ *
+ * Description:
+ *   Constructor. Sensors are added with Add().
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_sched.hpp
+ */
+BME280Scheduler::BME280Scheduler()
+  : running(false)
+{ }
+
+/*
+ * BME280Scheduler::~BME280Scheduler()
+ *
+ * Description:
+ *   Destructor. Stops the scheduler if it is running.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_sched.hpp
+ */
+BME280Scheduler::~BME280Scheduler()
+{
+    this->Stop();
+}
+
+
+// BME280Scheduler Protected
+// -----------------------------------------------------------------
+
+/*
+ * void BME280Scheduler::Release(clock::time_point now)
+ *
+ * Description:
+ *   Releases every job whose release time has come. A job released
+ *   while the previous job of the same sensor is still in progress
+ *   is skipped.
+ *
+ * Parameters:
+ *   now - current time
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_sched.hpp
+ */
+void BME280Scheduler::Release(clock::time_point now)
+{
+    for (size_t i = 0; i < tasks.size(); i++)
+    {
+        Task& t = tasks[i];
+
+        while (t.next_release <= now)
+        {
+            lock_guard<mutex> lock(mtx);
+
+            t.stats.jobs++;
+
+            if (t.state != Idle)
+            {
+                t.stats.skipped++;
+            }
+            else
+            {
+                t.state   = Pending;
+                t.release = t.next_release;
+                t.due     = t.release + t.deadline;
+            }
+
+            t.next_release += t.period;
+        }
+    }
+}
+
+/*
+ * void BME280Scheduler::Trigger(Task& t)
+ *
+ * Description:
+ *   Starts the conversion for a pending job.
+ *
+ * Parameters:
+ *   t - the task
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_sched.hpp
+ */
+void BME280Scheduler::Trigger(Task& t)
+{
+    {
+        lock_guard<mutex> lock(t.dev->mtx);
+        t.dev->Force();
+    }
+
+    t.trigger = clock::now();
+    t.ready   = t.trigger + t.tmeas;
+    t.state   = Converting;
+}
+
+/*
+ * void BME280Scheduler::Collect(size_t id, Task& t)
+ *
+ * Description:
+ *   Reads the result of a converting job, records its timing, and
+ *   delivers it to the task callback. The sample time is the trigger
+ *   time plus half the typical measurement time.
+ *
+ * Parameters:
+ *   id - sensor number
+ *   t  - the task
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_sched.hpp
+ */
+void BME280Scheduler::Collect(size_t id, Task& t)
+{
+    TPH32SensorData sensdat;
+    uint8_t         status;
+    {
+        lock_guard<mutex> lock(t.dev->mtx);
+        sensdat = t.dev->GetSensorData(status);
+    }
+
+    if (status & BME280_STATUS_MEASURING)
+    {
+        t.ready = clock::now() + microseconds(BME280_POLL_INTERVAL);
+        return;
+    }
+
+    clock::time_point now = clock::now();
+    t.state = Idle;
+
+    sensdat.sampled   = duration_cast<nanoseconds>(t.trigger.time_since_epoch()).count() + t.ttyp / 2;
+    sensdat.timestamp = WallSeconds(sensdat.sampled);
+
+    int64_t response = duration_cast<microseconds>(now - t.release).count();
+    int64_t lateness = duration_cast<microseconds>(now - t.due).count();
+    {
+        lock_guard<mutex> lock(mtx);
+
+        t.stats.completed++;
+        if (lateness > 0)
+            t.stats.missed++;
+
+        t.stats.max_response = max(t.stats.max_response, response);
+        t.stats.max_lateness = max(t.stats.max_lateness, lateness);
+    }
+
+    if (t.cb)
+        t.cb(id, sensdat);
+}
+
+/*
+ * void BME280Scheduler::Run()
+ *
+ * Description:
+ *   Scheduler thread. Releases jobs, runs the ready transaction with
+ *   the earliest deadline, and sleeps when nothing is ready.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_sched.hpp
+ */
+void BME280Scheduler::Run()
+{
+    for (;;)
+    {
+        {
+            lock_guard<mutex> lock(mtx);
+            if (!running) return;
+        }
+
+        clock::time_point now = clock::now();
+        this->Release(now);
+
+        size_t            best = tasks.size();
+        clock::time_point wake = clock::time_point::max();
+
+        for (size_t i = 0; i < tasks.size(); i++)
+        {
+            Task& t = tasks[i];
+
+            wake = min(wake, t.next_release);
+
+            bool ready = (t.state == Pending) ||
+                         ((t.state == Converting) && (t.ready <= now));
+
+            if ((t.state == Converting) && !ready)
+                wake = min(wake, t.ready);
+
+            if (ready && ((best == tasks.size()) || (t.due < tasks[best].due)))
+                best = i;
+        }
+
+        if (best == tasks.size())
+        {
+            unique_lock<mutex> lock(mtx);
+            cv.wait_until(lock, wake, [this] { return !running; });
+            continue;
+        }
+
+        Task& t = tasks[best];
+
+        try
+        {
+            if (t.state == Pending)
+                this->Trigger(t);
+            else
+                this->Collect(best, t);
+        }
+        catch (const exception&)
+        {
+            lock_guard<mutex> lock(mtx);
+            t.stats.errors++;
+            t.state = Idle;
+        }
+    }
+}
+
+
+// BME280Scheduler Public
+// -----------------------------------------------------------------
+
+/*
+ * size_t BME280Scheduler::Add(BME280* dev, const Config& cfg,
+ *                             uint32_t period, uint32_t deadline, Callback cb)
+ *
+ * Description:
+ *   Adds a sensor. Must be called before Start().
+ *
+ * Parameters:
+ *   dev      - the device. Should not be used elsewhere while the
+ *              scheduler runs.
+ *   cfg      - a valid forced mode (or sleep mode) configuration
+ *   period   - job period, in microseconds
+ *   deadline - deadline relative to each release, in microseconds
+ *   cb       - called with each result, on the scheduler thread
+ *
+ * Returns:
+ *   Returns the sensor number, as passed to the callback.
+ *
+ * Exceptions:
+ *   Throws std::invalid_argument if cfg is not a valid forced mode
+ *   configuration, or if period or deadline is zero.
+ *   Throws std::logic_error if the scheduler is running.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_sched.hpp
+ */
+size_t BME280Scheduler::Add(BME280* dev, const Config& cfg, uint32_t period, uint32_t deadline, Callback cb)
+{
+    if (!cfg.IsValid() || (cfg.mode == BME280_MODE_NORMAL))
+        throw invalid_argument("BME280Scheduler::Add(): configuration is not forced mode");
+    if ((period == 0) || (deadline == 0))
+        throw invalid_argument("BME280Scheduler::Add(): zero period or deadline");
+    if (worker.joinable())
+        throw logic_error("BME280Scheduler::Add(): scheduler is running");
+
+    Task t;
+    t.dev      = dev;
+    t.cfg      = cfg;
+    t.period   = microseconds(period);
+    t.deadline = microseconds(deadline);
+    t.tmeas    = microseconds(MeasureTimeMax(cfg.CtrlHum(), cfg.CtrlMeas()));
+    t.ttyp     = (int64_t)MeasureTimeTyp(cfg.CtrlHum(), cfg.CtrlMeas()) * 1000;
+    t.cb       = cb;
+    t.state    = Idle;
+
+    tasks.push_back(t);
+
+    return tasks.size() - 1;
+}
+
+/*
+ * void BME280Scheduler::Start()
+ *
+ * Description:
+ *   Applies each sensor's configuration, releases the first job of
+ *   every sensor, and starts the scheduler thread. Does nothing if
+ *   the scheduler is already running.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_sched.hpp
+ */
+void BME280Scheduler::Start()
+{
+    if (worker.joinable()) return;
+
+    for (size_t i = 0; i < tasks.size(); i++)
+    {
+        lock_guard<mutex> lock(tasks[i].dev->mtx);
+        tasks[i].dev->ApplyConfig(tasks[i].cfg);
+    }
+
+    clock::time_point start = clock::now();
+
+    for (size_t i = 0; i < tasks.size(); i++)
+    {
+        tasks[i].state        = Idle;
+        tasks[i].next_release = start;
+    }
+
+    running = true;
+    worker  = thread(&BME280Scheduler::Run, this);
+}
+
+/*
+ * void BME280Scheduler::Stop()
+ *
+ * Description:
+ *   Stops the scheduler thread. A job in progress is abandoned.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_sched.hpp
+ */
+void BME280Scheduler::Stop()
+{
+    if (!worker.joinable()) return;
+
+    {
+        lock_guard<mutex> lock(mtx);
+        running = false;
+    }
+    cv.notify_all();
+
+    worker.join();
+}
+
+/*
+ * SchedStats BME280Scheduler::GetStats(size_t id)
+ *
+ * Description:
+ *   Returns a snapshot of one sensor's scheduling counters.
+ *
+ * Parameters:
+ *   id - sensor number, as returned by Add()
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_sched.hpp
+ */
+SchedStats BME280Scheduler::GetStats(size_t id)
+{
+    lock_guard<mutex> lock(mtx);
+    return tasks.at(id).stats;
+}
+
+} // namespace bosch_bme280
@@ -0,0 +1,163 @@
+/*
+ * bme280_sched.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Earliest-deadline-first scheduling of forced mode measurements
+ *    for several BME280s that share one bus.
+ *
+ *    Each sensor has a period, a relative deadline, and a forced mode
+ *    configuration. Every period a job is released; the job is a
+ *    trigger transaction (Force()) followed, one maximum measurement
+ *    time later, by a read transaction. Whenever the bus is free, the
+ *    scheduler runs the ready transaction whose job has the earliest
+ *    deadline. Triggers are single writes, so a burst of them costs
+ *    little bus time, and the conversions then run side by side.
+ *
+ *  Example:
+ *    BME280Scheduler sched;
+ *    sched.Add(&nav,  navcfg,        40000,    40000, OnSample);  // 25 Hz
+ *    sched.Add(&wx,   ConfigWeather, 60000000, 1000000, OnSample); // 1/min
+ *    sched.Start();
+ */
+
+#ifndef BME280_SCHED_HPP_
+#define BME280_SCHED_HPP_
+
+#include <chrono>            // steady_clock
+#include <condition_variable>  // condition_variable
+#include <functional>        // function
+#include <mutex>             // mutex
+#include <stddef.h>          // size_t
+#include <stdint.h>          // uint32_t, uint64_t, int64_t
+#include <thread>            // thread
+#include <vector>            // vector
+
+#include "bme280.hpp"
+#include "bme280_config.hpp"
+#include "bme280_data.hpp"
+
+
+namespace bosch_bme280
+{
+
+/*
+ * struct SchedStats
+ *
+ * Description:
+ *   Per-sensor scheduling counters. Times are in microseconds.
+ *
+ *     jobs         - jobs released
+ *     completed    - jobs whose data was delivered
+ *     missed       - completed jobs that finished after their deadline
+ *     skipped      - jobs dropped because the previous job of the same
+ *                    sensor was still in progress
+ *     errors       - jobs abandoned because a transfer threw
+ *     max_response - longest release-to-delivery time
+ *     max_lateness - greatest completion time past the deadline, or
+ *                    least time short of it if no deadline was missed
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_sched.hpp
+ */
+struct SchedStats
+{
+    uint64_t  jobs;
+    uint64_t  completed;
+    uint64_t  missed;
+    uint64_t  skipped;
+    uint64_t  errors;
+    int64_t   max_response;
+    int64_t   max_lateness;
+
+    SchedStats ( )
+      : jobs(0), completed(0), missed(0), skipped(0), errors(0),
+        max_response(0), max_lateness(INT64_MIN) { }
+};
+
+/*
+ * class BME280Scheduler
+ *
+ * Description:
+ *   Runs periodic forced mode measurements for a set of sensors on
+ *   one thread, in earliest-deadline-first order.
+ *
+ *   Sensors are added before Start(). Callbacks run on the scheduler
+ *   thread and should return quickly; slow work delays every sensor.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_sched.hpp
+ */
+class BME280Scheduler
+{
+
+  public:
+
+	typedef std::function<void(size_t id, const TPH32SensorData& sensdat)>  Callback;
+
+  protected:
+
+	typedef std::chrono::steady_clock  clock;
+
+	enum JobState { Idle, Pending, Converting };
+
+	struct Task
+	{
+	    BME280*            dev;
+	    Config             cfg;
+	    clock::duration    period;
+	    clock::duration    deadline;
+	    clock::duration    tmeas;         // maximum measurement time
+	    int64_t            ttyp;          // typical, in ns
+	    Callback           cb;
+
+	    JobState           state;
+	    clock::time_point  next_release;
+	    clock::time_point  release;
+	    clock::time_point  due;           // absolute deadline of the job
+	    clock::time_point  trigger;
+	    clock::time_point  ready;         // conversion complete
+
+	    SchedStats         stats;
+	};
+
+	std::vector<Task>        tasks;
+
+	std::mutex               mtx;         // guards running, stats
+	std::condition_variable  cv;
+	bool                     running;
+	std::thread              worker;
+
+	void  Run      ();
+	void  Release  ( clock::time_point now );
+	void  Trigger  ( Task& t );
+	void  Collect  ( size_t id, Task& t );
+
+  public:
+
+	BME280Scheduler ();
+	~BME280Scheduler ();
+
+	BME280Scheduler ( const BME280Scheduler& ) = delete;
+	BME280Scheduler& operator= ( const BME280Scheduler& ) = delete;
+
+	size_t  Add ( BME280* dev, const Config& cfg, uint32_t period, uint32_t deadline, Callback cb );
+
+	void  Start ();
+	void  Stop  ();
+
+	SchedStats  GetStats ( size_t id );
+
+}; // class BME280Scheduler
+
+} // namespace bosch_bme280
+
+#endif /* BME280_SCHED_HPP_ */
@@ -0,0 +1,97 @@
+/*
+ * bme280_spi.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    SPI transport for the BME280, on Linux spidev. The transfer code
+ *    is inline, in bme280_spi.hpp.
+ */
+
+
+#include <fcntl.h>           // open
+#include <unistd.h>          // close
+
+#include "bme280_spi.hpp"
+
+
+using namespace std;
+
+
+namespace bosch_bme280
+{
+
+/*
+ * SpiDevPort::SpiDevPort(const std::string& path, uint32_t hz, bool threewire)
+ *
+ * Description:
+ *   Constructor. Opens a spidev device and sets its mode, word size,
+ *   and clock rate.
+ *
+ * Parameters:
+ *   path      - spidev device file, such as "/dev/spidev1.0"
+ *   hz        - Optional. SPI clock, in Hz.
+ *               Default value is BME280_SPI_HZ.
+ *   threewire - Optional. True for a 3-wire bus.
+ *               Default value is false.
+ *
+ * Exceptions:
+ *   Throws std::runtime_error if the device cannot be opened or
+ *   configured.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_spi.hpp
+ */
+SpiDevPort::SpiDevPort(const string& path, uint32_t hz, bool threewire)
+{
+    spi3w = threewire;
+    speed = hz;
+
+    fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0)
+        throw runtime_error("SpiDevPort: cannot open " + path);
+
+    uint8_t mode = SPI_MODE_0;
+    uint8_t bits = 8;
+    if (spi3w) mode |= SPI_3WIRE;
+
+    if (ioctl(fd, SPI_IOC_WR_MODE, &mode) < 0 ||
+        ioctl(fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+        ioctl(fd, SPI_IOC_WR_MAX_SPEED_HZ, &speed) < 0)
+    {
+        close(fd);
+        throw runtime_error("SpiDevPort: cannot configure " + path);
+    }
+}
+
+/*
+ * SpiDevPort::SpiDevPort(SpiDevPort&& other)
+ *
+ * Description:
+ *   Move constructor. other is left without a file descriptor.
+ */
+SpiDevPort::SpiDevPort(SpiDevPort&& other)
+{
+    fd       = other.fd;
+    spi3w    = other.spi3w;
+    speed    = other.speed;
+    other.fd = -1;
+}
+
+/*
+ * SpiDevPort::~SpiDevPort()
+ *
+ * Description:
+ *   Destructor. Closes the spidev device.
+ */
+SpiDevPort::~SpiDevPort()
+{
+    if (fd >= 0)
+        close(fd);
+}
+
+} // namespace bosch_bme280
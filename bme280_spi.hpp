@@ -0,0 +1,275 @@
+/*
+ * bme280_spi.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    SPI transport for the BME280, on Linux spidev.
+ *
+ *    Each SPI transaction starts with a control byte: the register
+ *    address with bit 7 replacing the address MSB, 1 for a read and
+ *    0 for a write. A read clocks out consecutive registers for as
+ *    long as chip select is held. A write is a sequence of {control,
+ *    data} pairs under one chip select.
+ *
+ *    In 4-wire mode a register read is a single full-duplex transfer
+ *    of len + 1 bytes. In 3-wire mode the device shares one data
+ *    line, so a read is a one-byte write followed by a len-byte read,
+ *    both in one spidev message.
+ *
+ *    ReadWrite() sends the read and the write as two chip select
+ *    frames of one message.
+ *
+ *    A port carries the messages:
+ *
+ *      void      Message   ( struct spi_ioc_transfer* xfers, int n );
+ *      bool      ThreeWire () const;
+ *      uint32_t  Speed     () const;
+ *
+ *    SpiDevPort is the kernel spidev device; EmuSpiPort (bme280_emu.hpp)
+ *    is a userspace stand-in built on BME280Emulator.
+ *
+ *  3-Wire Mode:
+ *    The device powers up, and comes out of a soft reset, in 4-wire
+ *    mode. A 3-wire transport therefore writes config with spi3w_en
+ *    set before its first transfer, and again before the first
+ *    transfer after a reset. Writes reach the device in either mode.
+ *    That first write also returns t_sb and filter to their reset
+ *    values. Every later config write has spi3w_en forced on.
+ *
+ *  Example:
+ *    BME280Dev<SpiDevTransport> dev("/dev/spidev1.0");
+ *    dev.LoadCalParams();
+ *    dev.ApplyConfig(ConfigGaming);
+ */
+
+#ifndef BME280_SPI_HPP_
+#define BME280_SPI_HPP_
+
+#include <linux/spi/spidev.h>  // spi_ioc_transfer, SPI_IOC_MESSAGE
+#include <stdexcept>           // runtime_error, invalid_argument
+#include <stdint.h>            // uint8_t, uint32_t, uintptr_t
+#include <string.h>            // memset, memcpy
+#include <string>              // string
+#include <sys/ioctl.h>         // ioctl
+#include <utility>             // forward
+
+#include "bme280_defs.hpp"
+
+
+namespace bosch_bme280
+{
+
+/*
+ * class SpiDevPort
+ *
+ * Description:
+ *   A Linux spidev device, opened in SPI mode 0 with 8-bit words,
+ *   and with SPI_3WIRE for a 3-wire bus. Owns its file descriptor.
+ *   Movable, not copyable.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_spi.hpp
+ */
+class SpiDevPort
+{
+
+  protected:
+
+	int      fd;
+	bool     spi3w;
+	uint32_t speed;
+
+  public:
+
+	SpiDevPort ( const std::string& path, uint32_t hz = BME280_SPI_HZ,
+	             bool threewire = false );
+	SpiDevPort ( SpiDevPort&& other );
+	~SpiDevPort ();
+
+	SpiDevPort ( const SpiDevPort& ) = delete;
+	SpiDevPort& operator= ( const SpiDevPort& ) = delete;
+
+	void Message ( struct spi_ioc_transfer* xfers, int n )
+	{
+	    unsigned long req = _IOC(_IOC_WRITE, SPI_IOC_MAGIC, 0,
+	                             n * sizeof(struct spi_ioc_transfer));
+
+	    if (ioctl(fd, req, xfers) < 0)
+	        throw std::runtime_error("SpiDevPort: transfer failed");
+	}
+
+	bool      ThreeWire () const { return spi3w; }
+	uint32_t  Speed     () const { return speed; }
+
+}; // class SpiDevPort
+
+/*
+ * class SpiTransport<Port>
+ *
+ * Description:
+ *   BME280Dev transport policy for a device on an SPI port.
+ *   Constructor arguments are passed on to the Port constructor.
+ *   Address() is zero; SPI has no device address.
+ *
+ *   Transfers are limited to BME280_SPI_MAX_XFER bytes, well above
+ *   the driver's largest (the 26-byte calibration block).
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_spi.hpp
+ */
+template <class Port>
+class SpiTransport
+{
+
+  protected:
+
+	Port port;
+	bool rearm;              // 3-wire: spi3w_en must be written first
+
+	void Segment ( struct spi_ioc_transfer& xfer, const uint8_t* tx, uint8_t* rx, int len )
+	{
+	    memset(&xfer, 0, sizeof(xfer));
+	    xfer.tx_buf        = (uintptr_t)tx;
+	    xfer.rx_buf        = (uintptr_t)rx;
+	    xfer.len           = len;
+	    xfer.speed_hz      = port.Speed();
+	    xfer.bits_per_word = 8;
+	}
+
+	void Enable3W ()
+	{
+	    uint8_t tx[] { BME280_R_CONF & BME280_SPI_ADDR_MSK, BME280_SPI3W_EN };
+	    struct spi_ioc_transfer xfer;
+
+	    this->Segment(xfer, tx, nullptr, 2);
+	    port.Message(&xfer, 1);
+	    rearm = false;
+	}
+
+	// Sets up the segments of a register read; returns how many.
+	// A 4-wire read lands in rx, one byte past the control byte.
+	int ReadFrame ( struct spi_ioc_transfer* xfer, uint8_t* tx, uint8_t* rx,
+	                uint8_t regaddr, uint8_t* data, int len )
+	{
+	    if (len < 1 || len >= BME280_SPI_MAX_XFER)
+	        throw std::invalid_argument("SpiTransport: bad read length");
+
+	    tx[0] = regaddr | BME280_SPI_READ;
+
+	    if (port.ThreeWire())
+	    {
+	        this->Segment(xfer[0], tx, nullptr, 1);
+	        this->Segment(xfer[1], nullptr, data, len);
+	        return 2;
+	    }
+
+	    memset(&tx[1], 0, len);
+	    this->Segment(xfer[0], tx, rx, len + 1);
+	    return 1;
+	}
+
+	// Encodes {address, data} pairs into tx; returns the byte count.
+	// Sets reset if the pairs include a soft reset.
+	int WriteFrame ( uint8_t* tx, const uint8_t* data, int len, bool& reset )
+	{
+	    if (len < 2 || len > BME280_SPI_MAX_XFER)
+	        throw std::invalid_argument("SpiTransport: bad write length");
+
+	    int n = len & ~1;
+
+	    for (int i = 0; i < n; i += 2)
+	    {
+	        uint8_t regaddr = data[i];
+	        uint8_t value   = data[i + 1];
+
+	        if (regaddr == BME280_R_CONF && port.ThreeWire())
+	            value |= BME280_SPI3W_EN;
+	        if (regaddr == BME280_R_RESET && value == BME280_CMD_RESET)
+	            reset = true;
+
+	        tx[i]     = regaddr & BME280_SPI_ADDR_MSK;
+	        tx[i + 1] = value;
+	    }
+
+	    return n;
+	}
+
+  public:
+
+	template <class... Args>
+	explicit SpiTransport ( Args&&... args )
+	  : port(std::forward<Args>(args)...)
+	{
+	    rearm = port.ThreeWire();
+	}
+
+	void Read ( uint8_t regaddr, uint8_t* data, int len )
+	{
+	    uint8_t tx[BME280_SPI_MAX_XFER];
+	    uint8_t rx[BME280_SPI_MAX_XFER];
+	    struct spi_ioc_transfer xfer[2];
+
+	    int n = this->ReadFrame(xfer, tx, rx, regaddr, data, len);
+
+	    if (rearm) this->Enable3W();
+	    port.Message(xfer, n);
+
+	    if (!port.ThreeWire())
+	        memcpy(data, &rx[1], len);
+	}
+
+	void Write ( uint8_t* data, int len )
+	{
+	    uint8_t tx[BME280_SPI_MAX_XFER];
+	    bool    reset = false;
+	    struct spi_ioc_transfer xfer;
+
+	    this->Segment(xfer, tx, nullptr, this->WriteFrame(tx, data, len, reset));
+
+	    if (rearm) this->Enable3W();
+	    port.Message(&xfer, 1);
+
+	    if (reset)
+	        rearm = port.ThreeWire();
+	}
+
+	void ReadWrite ( uint8_t regaddr, uint8_t* data, int len, uint8_t* wdata, int wlen )
+	{
+	    uint8_t tx[BME280_SPI_MAX_XFER];
+	    uint8_t rx[BME280_SPI_MAX_XFER];
+	    uint8_t wtx[BME280_SPI_MAX_XFER];
+	    bool    reset = false;
+	    struct spi_ioc_transfer xfer[3];
+
+	    int n = this->ReadFrame(xfer, tx, rx, regaddr, data, len);
+	    xfer[n - 1].cs_change = 1;
+	    this->Segment(xfer[n], wtx, nullptr, this->WriteFrame(wtx, wdata, wlen, reset));
+
+	    if (rearm) this->Enable3W();
+	    port.Message(xfer, n + 1);
+
+	    if (!port.ThreeWire())
+	        memcpy(data, &rx[1], len);
+	    if (reset)
+	        rearm = port.ThreeWire();
+	}
+
+	uint8_t Address () const { return 0; }
+
+	Port& GetPort () { return port; }
+
+}; // class SpiTransport
+
+typedef SpiTransport<SpiDevPort>  SpiDevTransport;
+
+} // namespace bosch_bme280
+
+#endif /* BME280_SPI_HPP_ */
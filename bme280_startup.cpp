@@ -0,0 +1,248 @@
+/*
+ * bme280_startup.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Interleaved startup of many BME280s on one bus.
+ */
+
+
+#include <chrono>            // milliseconds, microseconds
+#include <stdexcept>         // runtime_error, invalid_argument
+#include <thread>            // this_thread
+
+#include "bme280_startup.hpp"
+#include "bme280_time.hpp"
+
+
+using namespace std;
+using namespace std::chrono;
+
+
+namespace bosch_bme280
+{
+
+/*
+ * StartupReport StartDevices(const std::vector<BME280*>& devs, const Config& cfg,
+ *                            std::vector<std::exception_ptr>* errors)
+ *
+ * Description:
+ *   Resets, calibrates, and configures a set of devices that share a
+ *   bus, interleaving the steps across devices. Runs on the calling
+ *   thread; each device's mutex is held only for its own transfers.
+ *
+ *   A device's status is first polled BME280_NVM_MIN_DELAY after its
+ *   reset, since it may read clear before the NVM copy has started.
+ *   A device whose NVM copy has not finished BME280_NVM_TIMEOUT
+ *   after its reset, or whose transfers keep failing until then, is
+ *   counted as failed. For a normal mode configuration, a device is
+ *   done once its first measurement has had time to complete.
+ *
+ * Parameters:
+ *   devs   - devices to start
+ *   cfg    - configuration to apply
+ *   errors - Optional. Receives one entry per device: null, or the
+ *            exception that stopped it.
+ *
+ * Returns:
+ *   Returns device counts, status polls, and elapsed time.
+ *
+ * Exceptions:
+ *   Throws std::invalid_argument if cfg.IsValid() is false.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_startup.hpp
+ */
+StartupReport StartDevices(const vector<BME280*>& devs, const Config& cfg,
+                           vector<exception_ptr>* errors)
+{
+    enum Stage { STAGE_NVM, STAGE_SETTLE, STAGE_DONE, STAGE_FAILED };
+
+    if (!cfg.IsValid())
+        throw invalid_argument("StartDevices(): invalid configuration");
+
+    StartupReport sr;
+    vector<Stage>   stage(devs.size(), STAGE_NVM);
+    vector<int64_t> due(devs.size(), 0);
+    vector<int64_t> poll(devs.size(), 0);
+    vector<exception_ptr> errs(devs.size());
+    size_t pending = devs.size();
+
+    int64_t start = SteadyNanos();
+
+    // Resets first, back to back, so that the NVM copies overlap.
+    for (size_t i = 0; i < devs.size(); i++)
+    {
+        try
+        {
+            lock_guard<mutex> lock(devs[i]->mtx);
+            devs[i]->BeginReset();
+        }
+        catch (...)
+        {
+            errs[i]  = current_exception();
+            stage[i] = STAGE_FAILED;
+            pending--;
+        }
+        poll[i] = SteadyNanos() + (int64_t)BME280_NVM_MIN_DELAY * 1000;
+        due[i]  = SteadyNanos() + (int64_t)BME280_NVM_TIMEOUT * 1000000;
+    }
+
+    while (pending > 0)
+    {
+        bool progress = false;
+
+        for (size_t i = 0; i < devs.size(); i++)
+        {
+            if (stage[i] == STAGE_SETTLE)
+            {
+                if (SteadyNanos() >= due[i])
+                {
+                    stage[i] = STAGE_DONE;
+                    pending--;
+                    progress = true;
+                }
+                continue;
+            }
+            if (stage[i] != STAGE_NVM)
+                continue;
+
+            // Status may read clear before the NVM copy has started.
+            if (SteadyNanos() < poll[i])
+                continue;
+
+            BME280* dev = devs[i];
+
+            try
+            {
+                lock_guard<mutex> lock(dev->mtx);
+
+                sr.polls++;
+                if (dev->ReadStatus() & BME280_STATUS_IM_UPDATE)
+                {
+                    if (SteadyNanos() > due[i])
+                        throw runtime_error("StartDevices(): NVM copy did not finish");
+                    continue;
+                }
+
+                dev->LoadCalParams();
+                dev->ApplyConfig(cfg);
+
+                if (cfg.mode == BME280_MODE_NORMAL)
+                {
+                    stage[i] = STAGE_SETTLE;
+                    due[i]   = SteadyNanos() + (int64_t)dev->MeasureTime(true) * 1000;
+                }
+                else
+                {
+                    stage[i] = STAGE_DONE;
+                    pending--;
+                }
+                progress = true;
+            }
+            catch (...)
+            {
+                // Transfers may fail while the device comes out of
+                // reset; only give up once its time is up.
+                if (SteadyNanos() > due[i])
+                {
+                    errs[i]  = current_exception();
+                    stage[i] = STAGE_FAILED;
+                    pending--;
+                    progress = true;
+                }
+            }
+        }
+
+        if (pending > 0 && !progress)
+            this_thread::sleep_for(microseconds(BME280_POLL_INTERVAL));
+    }
+
+    sr.seconds = (SteadyNanos() - start) / 1e9;
+
+    for (size_t i = 0; i < devs.size(); i++)
+    {
+        if (stage[i] == STAGE_DONE)
+            sr.devices++;
+        else
+            sr.failed++;
+    }
+
+    if (errors) errors->swap(errs);
+
+    return sr;
+}
+
+/*
+ * StartupBench BenchStartup(const std::vector<BME280*>& devs, const Config& cfg)
+ *
+ * Description:
+ *   Starts the same devices three ways and times each: serially with
+ *   the fixed BME280_RESET_DELAY and BME280_CONFIG_DELAY sleeps,
+ *   serially with Reset() polling the status register and waiting
+ *   out the first normal mode measurement, as StartDevices() does,
+ *   and with StartDevices().
+ *
+ * Parameters:
+ *   devs - devices, all on one bus
+ *   cfg  - configuration to apply
+ *
+ * Returns:
+ *   Returns the total startup time of each method.
+ *
+ * Exceptions:
+ *   Rethrows the first device error.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_startup.hpp
+ */
+StartupBench BenchStartup(const vector<BME280*>& devs, const Config& cfg)
+{
+    StartupBench sb;
+    sb.devices = devs.size();
+
+    int64_t start = SteadyNanos();
+    for (size_t i = 0; i < devs.size(); i++)
+    {
+        lock_guard<mutex> lock(devs[i]->mtx);
+
+        devs[i]->BeginReset();
+        this_thread::sleep_for(milliseconds(BME280_RESET_DELAY));
+        devs[i]->LoadCalParams();
+        if (devs[i]->ApplyConfig(cfg))
+            this_thread::sleep_for(milliseconds(BME280_CONFIG_DELAY));
+    }
+    sb.fixed = (SteadyNanos() - start) / 1e9;
+
+    start = SteadyNanos();
+    for (size_t i = 0; i < devs.size(); i++)
+    {
+        lock_guard<mutex> lock(devs[i]->mtx);
+
+        devs[i]->Reset();
+        devs[i]->LoadCalParams();
+        devs[i]->ApplyConfig(cfg);
+        if (cfg.mode == BME280_MODE_NORMAL)
+            this_thread::sleep_for(microseconds(devs[i]->MeasureTime(true)));
+    }
+    sb.polled = (SteadyNanos() - start) / 1e9;
+
+    vector<exception_ptr> errors;
+    StartupReport sr = StartDevices(devs, cfg, &errors);
+    sb.interleaved = sr.seconds;
+
+    for (size_t i = 0; i < errors.size(); i++)
+        if (errors[i]) rethrow_exception(errors[i]);
+
+    return sb;
+}
+
+} // namespace bosch_bme280
@@ -0,0 +1,107 @@
+/*
+ * bme280_startup.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Interleaved startup of many BME280s on one bus.
+ *
+ *    Bringing a device up takes a reset, a wait for the NVM copy that
+ *    follows it, a calibration load, and a configuration write. Done
+ *    one device at a time with fixed delays, the waits add up: 40
+ *    devices at 3 ms + 43 ms each is nearly two seconds.
+ *
+ *    StartDevices() resets every device back to back, then polls the
+ *    status registers in turn, each no sooner than BME280_NVM_MIN_DELAY
+ *    after its reset. As each device reports its NVM copy
+ *    done (im_update clear), its calibration is loaded and its
+ *    configuration written, while the others are still settling. The
+ *    waits overlap, so the total is roughly one NVM copy plus the
+ *    bus time of the transfers.
+ *
+ *  Example:
+ *    std::vector<BME280*> devs = ...;       // all on one bus
+ *    StartupReport sr = StartDevices(devs, ConfigWeather);
+ */
+
+#ifndef BME280_STARTUP_HPP_
+#define BME280_STARTUP_HPP_
+
+#include <exception>         // exception_ptr
+#include <stddef.h>          // size_t
+#include <stdint.h>          // uint64_t
+#include <vector>            // vector
+
+#include "bme280.hpp"
+#include "bme280_config.hpp"
+
+
+namespace bosch_bme280
+{
+
+/*
+ * struct StartupReport
+ *
+ * Description:
+ *   Result of a startup.
+ *
+ *     devices - devices started
+ *     failed  - devices that could not be started
+ *     polls   - status reads made while waiting
+ *     seconds - elapsed time
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_startup.hpp
+ */
+struct StartupReport
+{
+    size_t    devices;
+    size_t    failed;
+    uint64_t  polls;
+    double    seconds;
+
+    StartupReport ( )
+      : devices(0), failed(0), polls(0), seconds(0.0) { }
+};
+
+/*
+ * struct StartupBench
+ *
+ * Description:
+ *   Result of BenchStartup(). Total startup time of the same devices
+ *   three ways, in seconds:
+ *
+ *     fixed       - one at a time, with the fixed reset and
+ *                   configuration delays
+ *     polled      - one at a time, waiting on the status register
+ *     interleaved - StartDevices()
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_startup.hpp
+ */
+struct StartupBench
+{
+    size_t  devices;
+    double  fixed;
+    double  polled;
+    double  interleaved;
+
+    StartupBench ( )
+      : devices(0), fixed(0.0), polled(0.0), interleaved(0.0) { }
+};
+
+StartupReport  StartDevices ( const std::vector<BME280*>& devs, const Config& cfg,
+                              std::vector<std::exception_ptr>* errors = nullptr );
+
+StartupBench   BenchStartup ( const std::vector<BME280*>& devs, const Config& cfg );
+
+} // namespace bosch_bme280
+
+#endif /* BME280_STARTUP_HPP_ */
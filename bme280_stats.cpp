@@ -0,0 +1,297 @@
+/*
+ * bme280_stats.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Per-device bus instrumentation.
+ *
+ *  Notes:
+ *    Recording a transfer costs four relaxed atomic adds, which on
+ *    an uncontended cache line are ordinary locked adds (x86) or
+ *    short load/store-exclusive loops (ARM).
+ */
+
+
+#include "bme280_stats.hpp"
+
+
+using namespace std;
+
+
+namespace bosch_bme280
+{
+
+// Histogram Bucket
+// -----------------------------------------------------------------
+
+/*
+ * Returns floor(log2(ns)), limited to the histogram range.
+ */
+static inline int Bucket(uint64_t ns)
+{
+    int b = 63 - __builtin_clzll(ns | 1);
+
+    return (b < BME280_HIST_BUCKETS) ? b : BME280_HIST_BUCKETS - 1;
+}
+
+
+// OpSnapshot, StatsSnapshot
+// -----------------------------------------------------------------
+
+/*
+ * OpSnapshot::OpSnapshot()
+ *
+ * Description:
+ *   Constructor. Zeroes all counters.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_stats.hpp
+ */
+OpSnapshot::OpSnapshot()
+  : xfers(0), bytes(0), errors(0), retries(0), total_ns(0)
+{
+    for (int i = 0; i < BME280_HIST_BUCKETS; i++)
+        hist[i] = 0;
+}
+
+/*
+ * uint64_t OpSnapshot::Percentile(double p) const
+ *
+ * Description:
+ *   Returns an upper bound for the given latency percentile: the top
+ *   of the histogram bucket that contains it.
+ *
+ * Parameters:
+ *   p - percentile, 0.0 to 100.0
+ *
+ * Returns:
+ *   Returns nanoseconds, or zero if there are no transfers.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_stats.hpp
+ */
+uint64_t OpSnapshot::Percentile(double p) const
+{
+    uint64_t n = 0;
+    for (int i = 0; i < BME280_HIST_BUCKETS; i++)
+        n += hist[i];
+
+    if (n == 0) return 0;
+
+    uint64_t rank = (uint64_t)(p / 100.0 * (double)n);
+    if (rank >= n) rank = n - 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BME280_HIST_BUCKETS; i++)
+    {
+        seen += hist[i];
+        if (seen > rank)
+            return (2ULL << i) - 1;
+    }
+
+    return (2ULL << (BME280_HIST_BUCKETS - 1)) - 1;
+}
+
+/*
+ * OpSnapshot& OpSnapshot::operator+=(const OpSnapshot& rhs)
+ *
+ * Description:
+ *   Adds another snapshot's counters to this one.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_stats.hpp
+ */
+OpSnapshot& OpSnapshot::operator+=(const OpSnapshot& rhs)
+{
+    xfers    += rhs.xfers;
+    bytes    += rhs.bytes;
+    errors   += rhs.errors;
+    retries  += rhs.retries;
+    total_ns += rhs.total_ns;
+
+    for (int i = 0; i < BME280_HIST_BUCKETS; i++)
+        hist[i] += rhs.hist[i];
+
+    return *this;
+}
+
+/*
+ * OpSnapshot StatsSnapshot::Total() const
+ *
+ * Description:
+ *   Returns the sum over all operations.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_stats.hpp
+ */
+OpSnapshot StatsSnapshot::Total() const
+{
+    OpSnapshot total;
+
+    for (int i = 0; i < OP_COUNT; i++)
+        total += op[i];
+
+    return total;
+}
+
+
+// DeviceStats
+// -----------------------------------------------------------------
+
+/*
+ * DeviceStats::DeviceStats()
+ *
+ * Description:
+ *   Constructor. Zeroes all counters.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_stats.hpp
+ */
+DeviceStats::DeviceStats()
+{
+    this->Reset();
+}
+
+/*
+ * void DeviceStats::Record(BusOp op, uint64_t bytes, uint64_t ns)
+ *
+ * Description:
+ *   Records one successful transfer.
+ *
+ * Parameters:
+ *   op    - the operation
+ *   bytes - data bytes moved
+ *   ns    - transfer time, in nanoseconds
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_stats.hpp
+ */
+void DeviceStats::Record(BusOp op, uint64_t bytes, uint64_t ns)
+{
+    OpCounters& c = ops[op];
+
+    c.xfers.fetch_add(1, memory_order_relaxed);
+    c.bytes.fetch_add(bytes, memory_order_relaxed);
+    c.total_ns.fetch_add(ns, memory_order_relaxed);
+    c.hist[Bucket(ns)].fetch_add(1, memory_order_relaxed);
+}
+
+/*
+ * void DeviceStats::Error(BusOp op)
+ *
+ * Description:
+ *   Records one failed transfer attempt.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_stats.hpp
+ */
+void DeviceStats::Error(BusOp op)
+{
+    ops[op].errors.fetch_add(1, memory_order_relaxed);
+}
+
+/*
+ * void DeviceStats::Retry(BusOp op)
+ *
+ * Description:
+ *   Records a retry of a failed transfer.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_stats.hpp
+ */
+void DeviceStats::Retry(BusOp op)
+{
+    ops[op].retries.fetch_add(1, memory_order_relaxed);
+}
+
+/*
+ * StatsSnapshot DeviceStats::Snapshot() const
+ *
+ * Description:
+ *   Copies the counters. Safe to call from any thread.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_stats.hpp
+ */
+StatsSnapshot DeviceStats::Snapshot() const
+{
+    StatsSnapshot snap;
+
+    for (int o = 0; o < OP_COUNT; o++)
+    {
+        const OpCounters& c = ops[o];
+        OpSnapshot&       s = snap.op[o];
+
+        s.xfers    = c.xfers.load(memory_order_relaxed);
+        s.bytes    = c.bytes.load(memory_order_relaxed);
+        s.errors   = c.errors.load(memory_order_relaxed);
+        s.retries  = c.retries.load(memory_order_relaxed);
+        s.total_ns = c.total_ns.load(memory_order_relaxed);
+
+        for (int i = 0; i < BME280_HIST_BUCKETS; i++)
+            s.hist[i] = c.hist[i].load(memory_order_relaxed);
+    }
+
+    return snap;
+}
+
+/*
+ * void DeviceStats::Reset()
+ *
+ * Description:
+ *   Zeroes all counters. Transfers that complete during the reset
+ *   may be partly counted.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_stats.hpp
+ */
+void DeviceStats::Reset()
+{
+    for (int o = 0; o < OP_COUNT; o++)
+    {
+        OpCounters& c = ops[o];
+
+        c.xfers.store(0, memory_order_relaxed);
+        c.bytes.store(0, memory_order_relaxed);
+        c.errors.store(0, memory_order_relaxed);
+        c.retries.store(0, memory_order_relaxed);
+        c.total_ns.store(0, memory_order_relaxed);
+
+        for (int i = 0; i < BME280_HIST_BUCKETS; i++)
+            c.hist[i].store(0, memory_order_relaxed);
+    }
+}
+
+} // namespace bosch_bme280
@@ -0,0 +1,151 @@
+/*
+ * bme280_stats.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Per-device bus instrumentation: transaction counters and
+ *    latency histograms, kept separately for each kind of operation.
+ *
+ *    Counters are relaxed atomics, updated without locks by the
+ *    thread doing the transfer. A snapshot may be taken from any
+ *    thread at any time; it never blocks the transfer path. Counters
+ *    in one snapshot are individually exact but may be a transfer
+ *    apart from each other.
+ *
+ *    Latency histogram bucket i counts transfers that took from 2^i
+ *    up to 2^(i+1) nanoseconds. The last bucket also takes anything
+ *    longer.
+ */
+
+#ifndef BME280_STATS_HPP_
+#define BME280_STATS_HPP_
+
+#include <atomic>            // atomic
+#include <stdint.h>          // uint64_t
+
+
+#define BME280_HIST_BUCKETS  32    // 1 ns to 2.1 s and over
+
+
+namespace bosch_bme280
+{
+
+/*
+ * enum BusOp
+ *
+ * Description:
+ *   The operation a bus transfer belongs to.
+ *
+ *     OP_CALIBRATION - calibration ROM reads
+ *     OP_DATA        - data and status reads
+ *     OP_FORCE       - forced mode triggers
+ *     OP_CONFIG      - ctrl_hum, ctrl_meas, config, and reset
+ *     OP_OTHER       - anything else, e.g. chip id
+ */
+enum BusOp
+{
+    OP_CALIBRATION = 0,
+    OP_DATA,
+    OP_FORCE,
+    OP_CONFIG,
+    OP_OTHER,
+    OP_COUNT
+};
+
+/*
+ * struct OpSnapshot
+ *
+ * Description:
+ *   Counters for one operation, as plain values.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_stats.hpp
+ */
+struct OpSnapshot
+{
+    uint64_t  xfers;                          // successful transfers
+    uint64_t  bytes;                          // data bytes moved
+    uint64_t  errors;                         // failed attempts
+    uint64_t  retries;                        // attempts after a failure
+    uint64_t  total_ns;                       // time in successful transfers
+    uint64_t  hist[BME280_HIST_BUCKETS];
+
+    OpSnapshot ( );
+
+    uint64_t    Percentile ( double p ) const;
+    OpSnapshot& operator+= ( const OpSnapshot& rhs );
+};
+
+/*
+ * struct StatsSnapshot
+ *
+ * Description:
+ *   Counters for all operations of one device, indexed by BusOp.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_stats.hpp
+ */
+struct StatsSnapshot
+{
+    OpSnapshot  op[OP_COUNT];
+
+    OpSnapshot  Total () const;
+};
+
+/*
+ * class DeviceStats
+ *
+ * Description:
+ *   Live counters for one device. Each operation's counters occupy
+ *   their own cache lines.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_stats.hpp
+ */
+class DeviceStats
+{
+
+  protected:
+
+	struct alignas(64) OpCounters
+	{
+	    std::atomic<uint64_t>  xfers;
+	    std::atomic<uint64_t>  bytes;
+	    std::atomic<uint64_t>  errors;
+	    std::atomic<uint64_t>  retries;
+	    std::atomic<uint64_t>  total_ns;
+	    std::atomic<uint64_t>  hist[BME280_HIST_BUCKETS];
+	};
+
+	OpCounters ops[OP_COUNT];
+
+  public:
+
+	DeviceStats ();
+
+	DeviceStats ( const DeviceStats& ) = delete;
+	DeviceStats& operator= ( const DeviceStats& ) = delete;
+
+	void  Record ( BusOp op, uint64_t bytes, uint64_t ns );
+	void  Error  ( BusOp op );
+	void  Retry  ( BusOp op );
+
+	StatsSnapshot  Snapshot () const;
+	void           Reset    ();
+
+}; // class DeviceStats
+
+} // namespace bosch_bme280
+
+#endif /* BME280_STATS_HPP_ */
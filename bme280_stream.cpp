@@ -0,0 +1,383 @@
+/*
+ * bme280_stream.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Continuous (normal mode) acquisition for the BME280.
+ *
+ *  Notes:
+ *    1. In normal mode, the device alternates between a conversion
+ *       (measuring bit set) and t_sb of standby. The data registers
+ *       are shadowed, so a read always returns the newest complete
+ *       sample. A new sample has arrived when the measuring bit
+ *       falls, or when the data differ from the last sample read;
+ *       the latter catches a 0.5 ms standby that falls between two
+ *       polls. If neither is seen well past the expected arrival,
+ *       the new sample is taken to equal the old one.
+ *    2. The first period is the data sheet typical value. The
+ *       standby time may differ from nominal by the oscillator
+ *       tolerance, so the second cycle also waits for a rising edge
+ *       before accepting an unchanged sample. From then on the
+ *       period is measured.
+ *    3. The sample time is the arrival edge less half the typical
+ *       measurement time.
+ */
+
+
+#include <algorithm>         // min
+#include <chrono>            // steady_clock, microseconds
+#include <exception>         // exception
+#include <mutex>             // lock_guard
+#include <stdexcept>         // invalid_argument
+#include <thread>            // thread, this_thread
+
+#include "bme280_stream.hpp"
+#include "bme280_time.hpp"
+
+
+using namespace std;
+using namespace std::chrono;
+
+
+namespace bosch_bme280
+{
+
+// BME280Stream Constructor, Destructor
+// -----------------------------------------------------------------
+
+/*
+ * BME280Stream::BME280Stream(BME280* device, const Config& config)
+ *
+ * Description:
+ *   Constructor. Does not touch the device; acquisition begins with
+ *   Start().
+ *
+ * Parameters:
+ *   device - the BME280 to read
+ *   config - Optional. A valid normal mode configuration.
+ *            Default value is ConfigIndoorNav.
+ *
+ * Exceptions:
+ *   Throws std::invalid_argument if config is not a valid normal
+ *   mode configuration.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_stream.hpp
+ */
+BME280Stream::BME280Stream(BME280* device, const Config& config)
+  : dev(device), cfg(config), running(false),
+    samples(0), overruns(0), missed(0), late(0), polls(0)
+{
+    if (!cfg.IsValid() || (cfg.mode != BME280_MODE_NORMAL))
+        throw invalid_argument("BME280Stream: configuration is not normal mode");
+}
+
+/*
+ * BME280Stream::~BME280Stream()
+ *
+ * Description:
+ *   Destructor. Stops acquisition if it is running. An error while
+ *   returning the device to sleep mode is ignored.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_stream.hpp
+ */
+BME280Stream::~BME280Stream()
+{
+    try
+    {
+        this->Stop();
+    }
+    catch (const exception&)
+    {
+    }
+}
+
+
+// BME280Stream Protected
+// -----------------------------------------------------------------
+
+/*
+ * void BME280Stream::Run(clock::time_point start)
+ *
+ * Description:
+ *   Acquisition thread. Runs until Stop() is called or a bus
+ *   transfer throws.
+ *
+ * Parameters:
+ *   start - time at which normal mode was entered
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_stream.hpp
+ */
+void BME280Stream::Run(clock::time_point start)
+{
+    uint32_t ttyp = MeasureTimeTyp(cfg.CtrlHum(), cfg.CtrlMeas());
+    uint32_t tmax = MeasureTimeMax(cfg.CtrlHum(), cfg.CtrlMeas());
+
+    clock::duration period = microseconds(ttyp + StandbyTime(cfg.ConfReg()));
+    clock::duration slack  = microseconds(min<uint32_t>(BME280_STREAM_SLACK, ttyp / 2));
+
+    clock::time_point edge  = start;        // last sample arrival
+    bool              exact = false;        // edge was observed, not estimated
+    int               edges = 0;
+
+    clock::time_point wake  = start + microseconds(ttyp) - slack;
+
+    TPH32SensorData   last;
+
+    try
+    {
+        while (running)
+        {
+            this_thread::sleep_until(wake);
+
+            TPH32SensorData sensdat;
+            uint8_t status   = 0;
+            bool    first    = true;
+            bool    rise     = (edges != 1);
+            bool    timeout  = false;
+
+            clock::time_point giveup = wake + slack * 2 + microseconds(tmax - ttyp);
+
+            while (running)
+            {
+                {
+                    lock_guard<mutex> lock(dev->mtx);
+                    sensdat = dev->GetSensorData(status);
+                }
+                polls++;
+
+                bool changed = (edges > 0) &&
+                               ((sensdat.temperature != last.temperature) ||
+                                (sensdat.pressure    != last.pressure)    ||
+                                (sensdat.humidity    != last.humidity));
+
+                if (status & BME280_STATUS_MEASURING)
+                    rise = true;
+                else if (rise)
+                    break;
+
+                if (changed)
+                    break;
+
+                // Standby fell between polls and the new sample equals
+                // the old one.
+                if ((edges > 1) && rise && (clock::now() > giveup))
+                {
+                    timeout = true;
+                    break;
+                }
+
+                first = false;
+                this_thread::sleep_for(microseconds(BME280_POLL_INTERVAL));
+            }
+            if (!running) break;
+
+            clock::time_point now = clock::now();
+            long n = (edges > 0) ? (long)((now - edge + period / 2) / period) : 1;
+
+            if (n > 1)
+                missed += n - 1;
+
+            if ((first || timeout) && (edges > 0))
+            {
+                // The conversion was over before we woke, or its end was
+                // not seen. The sample is new, but its arrival time is
+                // unknown.
+                late++;
+                edge  += period * max(n, 1L);
+                exact  = false;
+            }
+            else
+            {
+                if (exact && (n == 1))
+                    period = (edges < 2) ? (now - edge) : (period * 7 + (now - edge)) / 8;
+
+                edge  = now;
+                exact = true;
+                edges++;
+            }
+
+            sensdat.sampled   = duration_cast<nanoseconds>(edge.time_since_epoch()).count() - (int64_t)ttyp * 500;
+            sensdat.timestamp = WallSeconds(sensdat.sampled);
+
+            last = sensdat;
+
+            if (ring.Push(sensdat))
+                samples++;
+            else
+                overruns++;
+
+            wake = edge + period - slack;
+        }
+    }
+    catch (const exception&)
+    {
+        running = false;
+    }
+}
+
+
+// BME280Stream Public
+// -----------------------------------------------------------------
+
+/*
+ * void BME280Stream::Start()
+ *
+ * Description:
+ *   Applies the stream configuration, which puts the device into
+ *   normal mode, and starts the acquisition thread. Does nothing if
+ *   the stream is already running. If the thread stopped on a bus
+ *   error, it is joined and a new one started.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_stream.hpp
+ */
+void BME280Stream::Start()
+{
+    if (running) return;
+    if (worker.joinable()) worker.join();
+
+    clock::time_point start;
+    {
+        lock_guard<mutex> lock(dev->mtx);
+        dev->ApplyConfig(cfg);
+        start = clock::now();
+    }
+
+    running = true;
+    worker  = thread(&BME280Stream::Run, this, start);
+}
+
+/*
+ * void BME280Stream::Stop()
+ *
+ * Description:
+ *   Stops the acquisition thread and returns the device to sleep
+ *   mode. Samples already in the ring buffer remain available.
+ *
+ *   If the thread had already stopped on a bus error, it is only
+ *   joined; the device is not touched.
+ *
+ * Exceptions:
+ *   Rethrows a bus error from putting the device to sleep.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_stream.hpp
+ */
+void BME280Stream::Stop()
+{
+    if (!worker.joinable()) return;
+
+    bool failed = !running.exchange(false);
+    worker.join();
+
+    if (failed) return;
+
+    lock_guard<mutex> lock(dev->mtx);
+    dev->Sleep();
+}
+
+/*
+ * bool BME280Stream::IsRunning() const
+ *
+ * Description:
+ *   Returns true while the acquisition thread is running. Becomes
+ *   false if a bus transfer fails.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_stream.hpp
+ */
+bool BME280Stream::IsRunning() const
+{
+    return running;
+}
+
+/*
+ * bool BME280Stream::Pop(TPH32SensorData& sensdat)
+ *
+ * Description:
+ *   Removes the oldest raw sample from the ring buffer. Never
+ *   blocks. Must be called from one consumer thread only.
+ *
+ * Parameters:
+ *   sensdat - receives the sample
+ *
+ * Returns:
+ *   Returns false if no sample is available.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_stream.hpp
+ */
+bool BME280Stream::Pop(TPH32SensorData& sensdat)
+{
+    return ring.Pop(sensdat);
+}
+
+/*
+ * size_t BME280Stream::Available() const
+ *
+ * Description:
+ *   Returns the number of samples waiting in the ring buffer.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_stream.hpp
+ */
+size_t BME280Stream::Available() const
+{
+    return ring.Size();
+}
+
+/*
+ * StreamStats BME280Stream::GetStats() const
+ *
+ * Description:
+ *   Returns a snapshot of the acquisition counters.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_stream.hpp
+ */
+StreamStats BME280Stream::GetStats() const
+{
+    StreamStats st;
+
+    st.samples  = samples;
+    st.overruns = overruns;
+    st.missed   = missed;
+    st.late     = late;
+    st.polls    = polls;
+
+    return st;
+}
+
+} // namespace bosch_bme280
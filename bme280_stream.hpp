@@ -0,0 +1,160 @@
+/*
+ * bme280_stream.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Continuous (normal mode) acquisition for the BME280.
+ *
+ *    A BME280Stream puts the device into normal mode and reads each
+ *    new sample on a dedicated thread, pushing raw samples into a
+ *    wait-free single-producer, single-consumer ring buffer.
+ *    Consumers pop samples without touching the bus, so they never
+ *    block on I2C; the acquisition thread never waits for them.
+ *
+ *  Example:
+ *    BME280Stream stream(&dev, ConfigIndoorNav);
+ *    Compensator<DoublePolicy> comp(dev.GetCalParams());
+ *    TPHDoubleCompData compdat;
+ *
+ *    stream.Start();
+ *    ...
+ *    while (stream.Pop(comp, compdat))
+ *        ...
+ *    stream.Stop();
+ */
+
+#ifndef BME280_STREAM_HPP_
+#define BME280_STREAM_HPP_
+
+#include <atomic>            // atomic
+#include <chrono>            // steady_clock
+#include <stddef.h>          // size_t
+#include <stdint.h>          // uint64_t
+#include <thread>            // thread
+
+#include "bme280.hpp"
+#include "bme280_config.hpp"
+#include "bme280_data.hpp"
+#include "bme280_defs.hpp"
+#include "bme280_policy.hpp"
+#include "bme280_ring.hpp"
+
+
+namespace bosch_bme280
+{
+
+/*
+ * struct StreamStats
+ *
+ * Description:
+ *   Acquisition counters for a BME280Stream.
+ *
+ *     samples  - samples pushed into the ring buffer
+ *     overruns - samples dropped because the ring buffer was full
+ *     missed   - device samples lost because the acquisition thread
+ *                woke more than one cycle late
+ *     late     - wake-ups that found the conversion already done
+ *     polls    - status + data burst reads
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_stream.hpp
+ */
+struct StreamStats
+{
+    uint64_t  samples;
+    uint64_t  overruns;
+    uint64_t  missed;
+    uint64_t  late;
+    uint64_t  polls;
+
+    StreamStats ( ) : samples(0), overruns(0), missed(0), late(0), polls(0) { }
+};
+
+/*
+ * class BME280Stream
+ *
+ * Description:
+ *   Normal mode acquisitor for one BME280.
+ *
+ *   The acquisition thread locks to the device's own cycle. It sleeps
+ *   until shortly before the expected end of the next conversion,
+ *   then reads status and data in one burst every BME280_POLL_INTERVAL
+ *   until the measuring bit clears. That read carries the new sample,
+ *   and its time becomes the reference for the next cycle. The cycle
+ *   period is learned from these edges, so host and device clocks
+ *   cannot drift apart, and each device sample is read exactly once.
+ *
+ *   The device mutex is held only for each bus transfer.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_stream.hpp
+ */
+class BME280Stream
+{
+
+  protected:
+
+	typedef std::chrono::steady_clock  clock;
+
+	BME280* dev;
+	Config  cfg;
+
+	SpscRing<TPH32SensorData, BME280_STREAM_DEPTH> ring;
+
+	std::atomic<bool> running;
+	std::thread       worker;
+
+	std::atomic<uint64_t> samples;
+	std::atomic<uint64_t> overruns;
+	std::atomic<uint64_t> missed;
+	std::atomic<uint64_t> late;
+	std::atomic<uint64_t> polls;
+
+	void  Run ( clock::time_point start );
+
+  public:
+
+	BME280Stream ( BME280* device, const Config& config = ConfigIndoorNav );
+	~BME280Stream ();
+
+	BME280Stream ( const BME280Stream& ) = delete;
+	BME280Stream& operator= ( const BME280Stream& ) = delete;
+
+	void  Start ();
+	void  Stop  ();
+	bool  IsRunning () const;
+
+	bool    Pop       ( TPH32SensorData& sensdat );
+	size_t  Available () const;
+
+	StreamStats  GetStats () const;
+
+	/*
+	 * Pops one sample and compensates it with comp, on the calling
+	 * thread. Returns false if no sample is available.
+	 */
+	template <class Policy>
+	bool Pop ( const Compensator<Policy>& comp, typename Policy::CompData& compdat )
+	{
+	    TPH32SensorData sensdat;
+
+	    if (!ring.Pop(sensdat))
+	        return false;
+
+	    compdat = comp(sensdat);
+	    return true;
+	}
+
+}; // class BME280Stream
+
+} // namespace bosch_bme280
+
+#endif /* BME280_STREAM_HPP_ */
@@ -0,0 +1,224 @@
+/*
+ * bme280_time.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Measurement and standby timing for the BME280.
+ *
+ *  Notes:
+ *    Measurement time formulas are from the BME280 Data Sheet,
+ *    BST-BME280-DS002-13, Rev 1.5, section 9.1. For oversampling
+ *    ratios T, P, and H, in milliseconds:
+ *
+ *      typical = 1    + 2*T   + (2*P   + 0.5)   + (2*H   + 0.5)
+ *      maximum = 1.25 + 2.3*T + (2.3*P + 0.575) + (2.3*H + 0.575)
+ *
+ *    A skipped measurement (ratio 0) drops its term entirely,
+ *    including the constant.
+ */
+
+
+#include <chrono>            // steady_clock, system_clock
+
+#include "bme280_defs.hpp"
+#include "bme280_time.hpp"
+
+
+using namespace std::chrono;
+
+
+// Oversampling ratio, by osrs_x register value.
+static const int osrs_ratio[8] = { 0, 1, 2, 4, 8, 16, 16, 16 };
+
+// Standby time in microseconds, by t_sb register value.
+static const uint32_t tsb_us[8] = { 500, 62500, 125000, 250000, 500000, 1000000, 10000, 20000 };
+
+
+namespace bosch_bme280
+{
+
+/*
+ * int OversampleRatio(uint8_t osrs)
+ *
+ * Description:
+ *   Converts a right-justified osrs_t, osrs_p, or osrs_h field value
+ *   to its oversampling ratio.
+ *
+ * Parameters:
+ *   osrs - oversampling field value, 0 through 7
+ *
+ * Returns:
+ *   Returns 0 (skipped), 1, 2, 4, 8, or 16.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_time.hpp
+ */
+int OversampleRatio(uint8_t osrs)
+{
+    return osrs_ratio[osrs & 0x07];
+}
+
+/*
+ * uint32_t MeasureTimeTyp(uint8_t ctrl_hum, uint8_t ctrl_meas)
+ *
+ * Description:
+ *   Computes the typical duration of one measurement cycle.
+ *
+ * Parameters:
+ *   ctrl_hum  - ctrl_hum register value
+ *   ctrl_meas - ctrl_meas register value
+ *
+ * Returns:
+ *   Returns the typical measurement time, in microseconds.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_time.hpp
+ */
+uint32_t MeasureTimeTyp(uint8_t ctrl_hum, uint8_t ctrl_meas)
+{
+    uint32_t ost = OversampleRatio((ctrl_meas & BME280_OSRS_T_MSK) >> 5);
+    uint32_t osp = OversampleRatio((ctrl_meas & BME280_OSRS_P_MSK) >> 2);
+    uint32_t osh = OversampleRatio( ctrl_hum  & BME280_OSRS_H_MSK);
+
+    uint32_t us = 1000 + 2000 * ost;
+    if (osp) us += 2000 * osp + 500;
+    if (osh) us += 2000 * osh + 500;
+
+    return us;
+}
+
+/*
+ * uint32_t MeasureTimeMax(uint8_t ctrl_hum, uint8_t ctrl_meas)
+ *
+ * Description:
+ *   Computes the maximum duration of one measurement cycle.
+ *
+ * Parameters:
+ *   ctrl_hum  - ctrl_hum register value
+ *   ctrl_meas - ctrl_meas register value
+ *
+ * Returns:
+ *   Returns the maximum measurement time, in microseconds.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_time.hpp
+ */
+uint32_t MeasureTimeMax(uint8_t ctrl_hum, uint8_t ctrl_meas)
+{
+    uint32_t ost = OversampleRatio((ctrl_meas & BME280_OSRS_T_MSK) >> 5);
+    uint32_t osp = OversampleRatio((ctrl_meas & BME280_OSRS_P_MSK) >> 2);
+    uint32_t osh = OversampleRatio( ctrl_hum  & BME280_OSRS_H_MSK);
+
+    uint32_t us = 1250 + 2300 * ost;
+    if (osp) us += 2300 * osp + 575;
+    if (osh) us += 2300 * osh + 575;
+
+    return us;
+}
+
+/*
+ * uint32_t StandbyTime(uint8_t config)
+ *
+ * Description:
+ *   Returns the normal mode inactive duration (t_sb) selected by
+ *   a config register value.
+ *
+ * Parameters:
+ *   config - config register value
+ *
+ * Returns:
+ *   Returns the standby time, in microseconds.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_time.hpp
+ */
+uint32_t StandbyTime(uint8_t config)
+{
+    return tsb_us[(config & BME280_T_SB_MSK) >> 5];
+}
+
+/*
+ * int64_t WallOffset()
+ *
+ * Description:
+ *   Returns the offset from the steady clock to the wall clock, in
+ *   nanoseconds. The offset is taken once, on first use, so later
+ *   adjustments of the system clock are not reflected.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_time.hpp
+ */
+int64_t WallOffset()
+{
+    static const int64_t offset =
+        duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count() - SteadyNanos();
+
+    return offset;
+}
+
+/*
+ * time_t WallSeconds(int64_t steady_ns)
+ *
+ * Description:
+ *   Converts a steady clock time to wall clock seconds, using
+ *   WallOffset().
+ *
+ * Parameters:
+ *   steady_ns - steady clock time, in nanoseconds
+ *
+ * Returns:
+ *   Returns seconds since the epoch.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_time.hpp
+ */
+time_t WallSeconds(int64_t steady_ns)
+{
+    return (time_t)((steady_ns + WallOffset()) / 1000000000);
+}
+
+/*
+ * int64_t WallMicros(int64_t steady_ns)
+ *
+ * Description:
+ *   Converts a steady clock time to wall clock microseconds, using
+ *   WallOffset().
+ *
+ * Parameters:
+ *   steady_ns - steady clock time, in nanoseconds
+ *
+ * Returns:
+ *   Returns microseconds since the epoch.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s);
+ *   bme280_time.hpp
+ */
+int64_t WallMicros(int64_t steady_ns)
+{
+    return (steady_ns + WallOffset()) / 1000;
+}
+
+} // namespace bosch_bme280
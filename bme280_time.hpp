@@ -0,0 +1,50 @@
+/*
+ * bme280_time.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Measurement and standby timing for the BME280, computed from
+ *    register settings, and the sample clock.
+ *
+ *    Sample times are steady_clock nanoseconds. On Linux, reading
+ *    the steady clock is a vDSO call, with no system call.
+ */
+
+#ifndef BME280_TIME_HPP_
+#define BME280_TIME_HPP_
+
+#include <chrono>            // steady_clock, nanoseconds
+#include <stdint.h>          // uint8_t, uint32_t, int64_t
+#include <time.h>            // time_t
+
+
+namespace bosch_bme280
+{
+
+int       OversampleRatio ( uint8_t osrs );
+
+uint32_t  MeasureTimeTyp  ( uint8_t ctrl_hum, uint8_t ctrl_meas );
+uint32_t  MeasureTimeMax  ( uint8_t ctrl_hum, uint8_t ctrl_meas );
+uint32_t  StandbyTime     ( uint8_t config );
+
+int64_t   WallOffset      ();
+time_t    WallSeconds     ( int64_t steady_ns );
+int64_t   WallMicros      ( int64_t steady_ns );
+
+/*
+ * int64_t SteadyNanos()
+ *
+ * Description:
+ *   Returns the steady clock, in nanoseconds.
+ */
+inline int64_t SteadyNanos ( )
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace bosch_bme280
+
+#endif /* BME280_TIME_HPP_ */
@@ -0,0 +1,87 @@
+/*
+ * bme280_transport.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Transport policies for the BME280 driver. Most of the transport
+ *    code is inline, in bme280_transport.hpp.
+ */
+
+
+#include <fcntl.h>           // open
+#include <linux/i2c-dev.h>   // I2C_SLAVE
+#include <sys/ioctl.h>       // ioctl
+
+#include "bme280_transport.hpp"
+
+
+using namespace std;
+
+
+namespace bosch_bme280
+{
+
+/*
+ * I2CDevTransport::I2CDevTransport(const std::string& path, uint8_t addr)
+ *
+ * Description:
+ *   Constructor. Opens an i2c-dev adapter and binds it to the device
+ *   address.
+ *
+ * Parameters:
+ *   path - adapter device file, such as "/dev/i2c-2"
+ *   addr - device I2C address
+ *
+ * Exceptions:
+ *   Throws std::runtime_error if the adapter cannot be opened or the
+ *   address cannot be set.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_transport.hpp
+ */
+I2CDevTransport::I2CDevTransport(const string& path, uint8_t addr)
+{
+    i2caddr = addr;
+
+    fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0)
+        throw runtime_error("I2CDevTransport: cannot open " + path);
+
+    if (ioctl(fd, I2C_SLAVE, (unsigned long)addr) < 0)
+    {
+        close(fd);
+        throw runtime_error("I2CDevTransport: cannot set address on " + path);
+    }
+}
+
+/*
+ * I2CDevTransport::I2CDevTransport(I2CDevTransport&& other)
+ *
+ * Description:
+ *   Move constructor. other is left without a file descriptor.
+ */
+I2CDevTransport::I2CDevTransport(I2CDevTransport&& other)
+{
+    fd       = other.fd;
+    i2caddr  = other.i2caddr;
+    other.fd = -1;
+}
+
+/*
+ * I2CDevTransport::~I2CDevTransport()
+ *
+ * Description:
+ *   Destructor. Closes the adapter.
+ */
+I2CDevTransport::~I2CDevTransport()
+{
+    if (fd >= 0)
+        close(fd);
+}
+
+} // namespace bosch_bme280
@@ -0,0 +1,467 @@
+/*
+ * bme280_transport.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    Compile-time transport policies for the BME280 driver.
+ *
+ *    A transport moves bytes between the driver and one device. It
+ *    provides:
+ *
+ *      void     Read      ( uint8_t regaddr, uint8_t* data, int len );
+ *      void     Write     ( uint8_t* data, int len );
+ *      void     ReadWrite ( uint8_t regaddr, uint8_t* data, int len,
+ *                           uint8_t* wdata, int wlen );
+ *      uint8_t  Address   () const;
+ *
+ *    Read() returns consecutive registers starting at regaddr. Write()
+ *    sends {address, data} pairs. ReadWrite() is a Read() followed by
+ *    a Write(), as one transaction where the transport allows it.
+ *    Address() is the I2C address, or zero where the transport has
+ *    none. Transfer errors are thrown.
+ *
+ *    BME280Dev<Transport> is a BME280 whose register access is fixed
+ *    at compile time. Its GetSensorData() overloads run the
+ *    instrumented read loop, BME280::ReadRegsVia(), with the
+ *    transport's Read() inlined, so a sample read called on a
+ *    BME280Dev has no indirection down to the transport's system
+ *    call. Its GetRegs() and SetRegs() overrides are final and call
+ *    the transport inline too, but every other transfer, and any
+ *    call made through a BME280* (as BME280Fleet, BME280Scheduler,
+ *    and the rest do), still reaches them through one virtual call.
+ *
+ *  Transports:
+ *    BbbI2CTransport   - bbb-i2c I2CBus
+ *    I2CDevTransport   - Linux i2c-dev, read() and write() on /dev/i2c-N
+ *    I2CRdwrTransport  - Linux i2c-dev, one I2C_RDWR ioctl per transaction
+ *    SpiDevTransport   - Linux spidev (bme280_spi.hpp)
+ *    EmuTransport      - a BME280Emulator, in memory (bme280_emu.hpp)
+ *    EmuSpiTransport   - a BME280Emulator, through SPI framing
+ *                        (bme280_emu.hpp)
+ *
+ *  Example:
+ *    BME280Dev<I2CDevTransport> dev("/dev/i2c-2", BME280_I2C0);
+ *    dev.LoadCalParams();
+ *    TPHDoubleCompData compdat = dev.ForceAndRead();
+ */
+
+#ifndef BME280_TRANSPORT_HPP_
+#define BME280_TRANSPORT_HPP_
+
+#include <fcntl.h>           // open
+#include <linux/i2c.h>       // i2c_msg, I2C_M_RD, I2C_FUNC_I2C
+#include <linux/i2c-dev.h>   // I2C_RDWR, I2C_FUNCS, i2c_rdwr_ioctl_data
+#include <stdexcept>         // runtime_error
+#include <stdint.h>          // uint8_t, int64_t, uint64_t
+#include <string>            // string
+#include <sys/ioctl.h>       // ioctl
+#include <unistd.h>          // read, write, close
+#include <utility>           // forward
+
+#include "bme280.hpp"
+#include "bme280_time.hpp"
+
+
+namespace bosch_bme280
+{
+
+/*
+ * class I2CBusTransport<Bus>
+ *
+ * Description:
+ *   A device at one address on a bus with the I2CBus interface:
+ *
+ *     void Xfer  ( uint8_t* outbuff, int outlen, uint8_t* inbuff, int inlen, uint8_t addr );
+ *     void Write ( uint8_t* data, int len, uint8_t addr );
+ *
+ *   The bus is not owned.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_transport.hpp
+ */
+template <class Bus>
+class I2CBusTransport
+{
+
+  protected:
+
+	Bus*    bus;
+	uint8_t i2caddr;
+
+  public:
+
+	I2CBusTransport ( Bus* i2cbus, uint8_t addr )
+	  : bus(i2cbus), i2caddr(addr) { }
+
+	void Read ( uint8_t regaddr, uint8_t* data, int len )
+	{
+	    bus->Xfer(&regaddr, 1, data, len, i2caddr);
+	}
+
+	void Write ( uint8_t* data, int len )
+	{
+	    bus->Write(data, len, i2caddr);
+	}
+
+	void ReadWrite ( uint8_t regaddr, uint8_t* data, int len, uint8_t* wdata, int wlen )
+	{
+	    bus->Xfer(&regaddr, 1, data, len, i2caddr);
+	    bus->Write(wdata, wlen, i2caddr);
+	}
+
+	uint8_t Address () const { return i2caddr; }
+
+}; // class I2CBusTransport
+
+typedef I2CBusTransport<I2CBus>  BbbI2CTransport;
+
+/*
+ * class I2CDevTransport
+ *
+ * Description:
+ *   A device reached through the Linux i2c-dev interface. The
+ *   adapter is opened once and bound to the device address with
+ *   I2C_SLAVE. A register read is a write() of the register address
+ *   followed by a read(); a register write is a single write().
+ *
+ *   Owns its file descriptor. Movable, not copyable.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_transport.hpp
+ */
+class I2CDevTransport
+{
+
+  protected:
+
+	int     fd;
+	uint8_t i2caddr;
+
+  public:
+
+	I2CDevTransport ( const std::string& path, uint8_t addr );
+	I2CDevTransport ( I2CDevTransport&& other );
+	~I2CDevTransport ();
+
+	I2CDevTransport ( const I2CDevTransport& ) = delete;
+	I2CDevTransport& operator= ( const I2CDevTransport& ) = delete;
+
+	void Read ( uint8_t regaddr, uint8_t* data, int len )
+	{
+	    if (::write(fd, &regaddr, 1) != 1)
+	        throw std::runtime_error("I2CDevTransport: address write failed");
+	    if (::read(fd, data, len) != len)
+	        throw std::runtime_error("I2CDevTransport: read failed");
+	}
+
+	void Write ( uint8_t* data, int len )
+	{
+	    if (::write(fd, data, len) != len)
+	        throw std::runtime_error("I2CDevTransport: write failed");
+	}
+
+	void ReadWrite ( uint8_t regaddr, uint8_t* data, int len, uint8_t* wdata, int wlen )
+	{
+	    this->Read(regaddr, data, len);
+	    this->Write(wdata, wlen);
+	}
+
+	uint8_t Address () const { return i2caddr; }
+
+}; // class I2CDevTransport
+
+/*
+ * struct I2CDevSys
+ *
+ * Description:
+ *   The system calls used by I2CRdwrTransport. A test build supplies
+ *   a class with the same members in its place; see EmuI2CSys.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_transport.hpp
+ */
+struct I2CDevSys
+{
+    int Open  ( const char* path, int flags )             { return ::open(path, flags); }
+    int Ioctl ( int fd, unsigned long request, void* arg ) { return ::ioctl(fd, request, arg); }
+    int Close ( int fd )                                   { return ::close(fd); }
+};
+
+/*
+ * class I2CRdwrTransport<Sys>
+ *
+ * Description:
+ *   A device reached through the Linux i2c-dev interface, with every
+ *   transaction a single I2C_RDWR ioctl. A register read is two
+ *   messages, the register address and the read, joined by a
+ *   repeated start. ReadWrite() adds the write as a third message, so
+ *   reading a sample and re-arming a forced conversion costs one
+ *   system call and no bus release.
+ *
+ *   The adapter must report I2C_FUNC_I2C. System calls go through a
+ *   Sys object, I2CDevSys by default.
+ *
+ *   Owns its file descriptor. Movable, not copyable.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_transport.hpp
+ */
+template <class Sys = I2CDevSys>
+class I2CRdwrTransport
+{
+
+  protected:
+
+	Sys     sys;
+	int     fd;
+	uint8_t i2caddr;
+
+	void Message ( struct i2c_msg& msg, uint16_t flags, uint8_t* buf, int len )
+	{
+	    msg.addr  = i2caddr;
+	    msg.flags = flags;
+	    msg.len   = (uint16_t)len;
+	    msg.buf   = buf;
+	}
+
+	void Transfer ( struct i2c_msg* msgs, int n )
+	{
+	    struct i2c_rdwr_ioctl_data rdwr;
+	    rdwr.msgs  = msgs;
+	    rdwr.nmsgs = n;
+
+	    if (sys.Ioctl(fd, I2C_RDWR, &rdwr) < 0)
+	        throw std::runtime_error("I2CRdwrTransport: transfer failed");
+	}
+
+  public:
+
+	I2CRdwrTransport ( const std::string& path, uint8_t addr, const Sys& system = Sys() )
+	  : sys(system), i2caddr(addr)
+	{
+	    fd = sys.Open(path.c_str(), O_RDWR | O_CLOEXEC);
+	    if (fd < 0)
+	        throw std::runtime_error("I2CRdwrTransport: cannot open " + path);
+
+	    unsigned long funcs = 0;
+	    if (sys.Ioctl(fd, I2C_FUNCS, &funcs) < 0 || !(funcs & I2C_FUNC_I2C))
+	    {
+	        sys.Close(fd);
+	        throw std::runtime_error("I2CRdwrTransport: no I2C_RDWR support on " + path);
+	    }
+	}
+
+	I2CRdwrTransport ( I2CRdwrTransport&& other )
+	  : sys(std::move(other.sys)), fd(other.fd), i2caddr(other.i2caddr)
+	{
+	    other.fd = -1;
+	}
+
+	~I2CRdwrTransport ()
+	{
+	    if (fd >= 0)
+	        sys.Close(fd);
+	}
+
+	I2CRdwrTransport ( const I2CRdwrTransport& ) = delete;
+	I2CRdwrTransport& operator= ( const I2CRdwrTransport& ) = delete;
+
+	void Read ( uint8_t regaddr, uint8_t* data, int len )
+	{
+	    struct i2c_msg msgs[2];
+	    this->Message(msgs[0], 0, &regaddr, 1);
+	    this->Message(msgs[1], I2C_M_RD, data, len);
+	    this->Transfer(msgs, 2);
+	}
+
+	void Write ( uint8_t* data, int len )
+	{
+	    struct i2c_msg msg;
+	    this->Message(msg, 0, data, len);
+	    this->Transfer(&msg, 1);
+	}
+
+	void ReadWrite ( uint8_t regaddr, uint8_t* data, int len, uint8_t* wdata, int wlen )
+	{
+	    struct i2c_msg msgs[3];
+	    this->Message(msgs[0], 0, &regaddr, 1);
+	    this->Message(msgs[1], I2C_M_RD, data, len);
+	    this->Message(msgs[2], 0, wdata, wlen);
+	    this->Transfer(msgs, 3);
+	}
+
+	uint8_t Address () const { return i2caddr; }
+
+	Sys& GetSys () { return sys; }
+
+}; // class I2CRdwrTransport
+
+/*
+ * class BME280Dev<Transport>
+ *
+ * Description:
+ *   A BME280 driver bound at compile time to a transport. Constructor
+ *   arguments are passed on to the Transport constructor, and the
+ *   driver takes its address from the transport.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_transport.hpp
+ */
+template <class Transport>
+class BME280Dev : public BME280
+{
+
+  protected:
+
+	Transport bus;
+
+	void GetRegs ( uint8_t regaddr, uint8_t* data, int len ) final
+	{
+	    bus.Read(regaddr, data, len);
+	}
+
+	void SetRegs ( uint8_t* data, int len ) final
+	{
+	    bus.Write(data, len);
+	}
+
+	void GetSetRegs ( uint8_t regaddr, uint8_t* data, int len,
+	                  uint8_t* wdata, int wlen ) final
+	{
+	    bus.ReadWrite(regaddr, data, len, wdata, wlen);
+	}
+
+  public:
+
+	template <class... Args>
+	explicit BME280Dev ( Args&&... args )
+	  : BME280(nullptr, 0), bus(std::forward<Args>(args)...)
+	{
+	    i2caddr = bus.Address();
+	}
+
+	Transport& GetTransport () { return bus; }
+
+	/*
+	 * BME280::GetSensorData(), reading through the transport directly.
+	 * These hide the base class versions; through a BME280* the
+	 * virtual GetRegs() path is used.
+	 */
+	TPH32SensorData GetSensorData ()
+	{
+	    return this->SensorDataVia([this](uint8_t r, uint8_t* d, int n) { bus.Read(r, d, n); });
+	}
+
+	TPH32SensorData GetSensorData ( uint8_t& status )
+	{
+	    return this->SensorDataVia([this](uint8_t r, uint8_t* d, int n) { bus.Read(r, d, n); },
+	                               status);
+	}
+
+}; // class BME280Dev
+
+/*
+ * struct TransportBench
+ *
+ * Description:
+ *   Result of BenchTransport().
+ *
+ *     reads     - sensor data reads timed
+ *     read_ns   - mean time of one GetSensorData(), nanoseconds
+ *     xfer_ns   - mean time of one data transfer, from the device
+ *                 statistics
+ *     driver_ns - read_ns less xfer_ns: driver overhead per read
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_transport.hpp
+ */
+struct TransportBench
+{
+    uint64_t  reads;
+    double    read_ns;
+    double    xfer_ns;
+    double    driver_ns;
+
+    TransportBench ( )
+      : reads(0), read_ns(0.0), xfer_ns(0.0), driver_ns(0.0) { }
+};
+
+/*
+ * template <class Dev>
+ * TransportBench BenchTransport(Dev& dev, unsigned reads)
+ *
+ * Description:
+ *   Measures the cost of reading sensor data through one device. The
+ *   data registers are read back to back, reads times, after a short
+ *   warm-up. Device statistics are reset before and after.
+ *
+ *   Dev is the static type the reads are made through: a BME280Dev
+ *   times its direct read path, a BME280 the virtual one. Run against
+ *   a stand-in device, such as a BME280Dev<EmuTransport>, the
+ *   transfer time is small and the result shows the per-read
+ *   overhead of the driver and its transport.
+ *
+ * Parameters:
+ *   dev   - device to be read
+ *   reads - number of timed reads
+ *
+ * Returns:
+ *   Mean read, transfer, and driver times.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_transport.hpp
+ */
+template <class Dev>
+TransportBench BenchTransport ( Dev& dev, unsigned reads )
+{
+    TransportBench tb;
+    if (reads == 0) return tb;
+
+    for (unsigned i = 0; i < reads / 16 + 1; i++)
+        dev.GetSensorData();
+
+    dev.ResetStats();
+
+    int64_t start = SteadyNanos();
+    for (unsigned i = 0; i < reads; i++)
+        dev.GetSensorData();
+    int64_t elapsed = SteadyNanos() - start;
+
+    OpSnapshot data = dev.GetStats().op[OP_DATA];
+    dev.ResetStats();
+
+    tb.reads   = reads;
+    tb.read_ns = (double)elapsed / reads;
+    if (data.xfers > 0)
+        tb.xfer_ns = (double)data.total_ns / data.xfers;
+    tb.driver_ns = tb.read_ns - tb.xfer_ns;
+
+    return tb;
+}
+
+} // namespace bosch_bme280
+
+#endif /* BME280_TRANSPORT_HPP_ */
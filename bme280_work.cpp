@@ -0,0 +1,167 @@
+/*
+ * bme280_work.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    A task queue served by a fixed set of threads.
+ */
+
+
+#include <utility>           // move
+
+#include "bme280_work.hpp"
+
+
+using namespace std;
+
+
+namespace bosch_bme280
+{
+
+/*
+ * WorkQueue::WorkQueue(unsigned nthreads)
+ *
+ * Description:
+ *   Constructor. Starts the worker threads.
+ *
+ * Parameters:
+ *   nthreads - Optional. Number of threads; zero selects one per
+ *              hardware thread.
+ *              Default value is 1.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_work.hpp
+ */
+WorkQueue::WorkQueue(unsigned nthreads)
+  : stopping(false)
+{
+    if (nthreads == 0)
+        nthreads = thread::hardware_concurrency();
+    if (nthreads == 0)
+        nthreads = 1;
+
+    for (unsigned i = 0; i < nthreads; i++)
+        threads.push_back(thread(&WorkQueue::Run, this));
+}
+
+/*
+ * WorkQueue::~WorkQueue()
+ *
+ * Description:
+ *   Destructor. Runs the tasks still queued, then joins the threads.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_work.hpp
+ */
+WorkQueue::~WorkQueue()
+{
+    {
+        lock_guard<mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+}
+
+/*
+ * void WorkQueue::Run()
+ *
+ * Description:
+ *   Worker thread. Takes tasks from the queue until the queue is
+ *   empty and the destructor has been called.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_work.hpp
+ */
+void WorkQueue::Run()
+{
+    for (;;)
+    {
+        function<void()> task;
+        {
+            unique_lock<mutex> lock(mtx);
+            cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+
+            if (tasks.empty())
+                return;
+
+            task = move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+/*
+ * void WorkQueue::Post(std::function<void()> task)
+ *
+ * Description:
+ *   Queues a task.
+ *
+ * Parameters:
+ *   task - the task; must not throw
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_work.hpp
+ */
+void WorkQueue::Post(function<void()> task)
+{
+    {
+        lock_guard<mutex> lock(mtx);
+        tasks.push_back(move(task));
+    }
+    cv.notify_one();
+}
+
+/*
+ * size_t WorkQueue::Pending()
+ *
+ * Description:
+ *   Returns the number of tasks waiting to run.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_work.hpp
+ */
+size_t WorkQueue::Pending()
+{
+    lock_guard<mutex> lock(mtx);
+    return tasks.size();
+}
+
+/*
+ * size_t WorkQueue::Threads() const
+ *
+ * Description:
+ *   Returns the number of worker threads.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_work.hpp
+ */
+size_t WorkQueue::Threads() const
+{
+    return threads.size();
+}
+
+} // namespace bosch_bme280
@@ -0,0 +1,90 @@
+/*
+ * bme280_work.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: JSRagman
+ *
+ *  Description:
+ *    A task queue served by a fixed set of threads.
+ *
+ *    With one thread, a WorkQueue serializes everything posted to
+ *    it, which is how the fleet manager owns an I2C bus. With
+ *    several, it is a thread pool.
+ */
+
+#ifndef BME280_WORK_HPP_
+#define BME280_WORK_HPP_
+
+#include <condition_variable>  // condition_variable
+#include <deque>             // deque
+#include <functional>        // function
+#include <future>            // future, packaged_task
+#include <memory>            // shared_ptr
+#include <mutex>             // mutex
+#include <stddef.h>          // size_t
+#include <thread>            // thread
+#include <utility>           // declval
+#include <vector>            // vector
+
+
+namespace bosch_bme280
+{
+
+/*
+ * class WorkQueue
+ *
+ * Description:
+ *   Runs posted tasks in FIFO order on nthreads threads. The
+ *   destructor runs all tasks still queued, then joins the threads.
+ *
+ *   Tasks posted with Post() must not throw. Submit() wraps a task
+ *   so that its result, or its exception, is delivered through a
+ *   future.
+ *
+ * Namespace:
+ *   bosch_bme280
+ *
+ * Header File(s):
+ *   bme280_work.hpp
+ */
+class WorkQueue
+{
+
+  protected:
+
+	std::mutex                         mtx;
+	std::condition_variable            cv;
+	std::deque<std::function<void()>>  tasks;
+	std::vector<std::thread>           threads;
+	bool                               stopping;
+
+	void  Run ();
+
+  public:
+
+	explicit WorkQueue ( unsigned nthreads = 1 );
+	~WorkQueue ();
+
+	WorkQueue ( const WorkQueue& ) = delete;
+	WorkQueue& operator= ( const WorkQueue& ) = delete;
+
+	void    Post    ( std::function<void()> task );
+	size_t  Pending ();
+	size_t  Threads () const;
+
+	template <class F, class R = decltype(std::declval<F&>()())>
+	std::future<R> Submit ( F task )
+	{
+	    std::shared_ptr<std::packaged_task<R()>> pt =
+	        std::make_shared<std::packaged_task<R()>>(task);
+
+	    this->Post([pt] { (*pt)(); });
+
+	    return pt->get_future();
+	}
+
+}; // class WorkQueue
+
+} // namespace bosch_bme280
+
+#endif /* BME280_WORK_HPP_ */